@@ -0,0 +1,337 @@
+/*!
+ * @file L3G4200D.h
+ *
+ * A compile-time configured L3G4200D driver, for boards where every byte of
+ * flash and every cycle counts.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_H
+#define L3G4200D_H
+
+#include "L3G4200D_Transport.h"
+#include "L3G4200D_U.h"
+
+/*!
+ * @brief The default configuration for L3G4200D, matching what
+ * L3G4200D_Unified::begin sets up.
+ *
+ * To change something, inherit from this and hide just the values you want
+ * to change:
+ *
+ * @code{.cpp}
+ * struct YawConfig : L3G4200D_DefaultConfig {
+ *   static constexpr gyroAxes_t AXES = GYRO_AXES_Z;
+ *   static constexpr gyroDataRate_t DATA_RATE = GYRO_DATA_RATE_800HZ;
+ *   static constexpr gyroBandwidth_t BANDWIDTH = GYRO_BANDWIDTH_WIDEST;
+ * };
+ *
+ * L3G4200D<YawConfig> gyro;
+ * @endcode
+ *
+ * @ingroup sensor
+ */
+struct L3G4200D_DefaultConfig {
+  /*! The range to use, or to start at if @ref AUTO_RANGE is set. */
+  static constexpr gyroRange_t RANGE = GYRO_RANGE_4_DOT_36_RAD_PER_SEC;
+
+  /*! The output data rate. */
+  static constexpr gyroDataRate_t DATA_RATE = GYRO_DATA_RATE_400HZ;
+
+  /*! The low-pass cutoff. ::GYRO_BANDWIDTH_AUTO isn't supported here. */
+  static constexpr gyroBandwidth_t BANDWIDTH = GYRO_BANDWIDTH_NARROW;
+
+  /*! Which axes to enable, read, and convert. */
+  static constexpr gyroAxes_t AXES = GYRO_AXES_XYZ;
+
+  /*! Whether to change range automatically. See
+   * L3G4200D_Unified::enableAutoRange. When this is false, the scale factors
+   * are constants. */
+  static constexpr bool AUTO_RANGE = false;
+
+  /*! Whether to log to the Serial console, like
+   * L3G4200D_Unified::enableDebugLogging. */
+  static constexpr bool DEBUG_LOGGING = false;
+
+  /*! The SPI clock frequency for the default L3G4200D_HardwareSPI
+   * transport. Must be lower than 10 MHz. */
+  static constexpr uint32_t SPI_FREQUENCY = 5L * 1000L * 1000L;
+};
+
+/*!
+ * @brief A leaner alternative to L3G4200D_Unified, where the configuration is
+ * fixed at compile time by @p Config instead of being checked on every call.
+ *
+ * Features that are turned off in @p Config compile to nothing, the scale
+ * factors are constants unless auto-ranging is on, and only the axes in
+ * `Config::AXES` are read and converted. The output format is picked by
+ * calling @ref getEvent or @ref getEventFixed; whichever one you don't call
+ * isn't compiled in at all.
+ *
+ * How registers are read and written is picked by @p Transport, so
+ * there's no indirection between a read and the bus either. As well as the
+ * default hardware SPI, there's L3G4200D_SoftwareSPI, and L3G4200D_I2C in
+ * L3G4200D_I2C.h:
+ *
+ * @code{.cpp}
+ * L3G4200D<L3G4200D_DefaultConfig, L3G4200D_SoftwareSPI> gyro;
+ *
+ * void setup() {
+ *   // CS, SCK, COPI, CIPO.
+ *   gyro.begin(4, 5, 6, 7);
+ * }
+ * @endcode
+ *
+ * This doesn't have the FIFO, interrupt capture, telemetry, or stats support
+ * of L3G4200D_Unified. Use L3G4200D_Unified if you need any of those, or
+ * need to change the configuration at run time.
+ *
+ * @tparam Config A struct like L3G4200D_DefaultConfig.
+ * @tparam Transport A class like L3G4200D_HardwareSPI, with `begin`,
+ * `readRegs`, and `writeRegs` methods.
+ *
+ * @ingroup sensor
+ */
+template <typename Config = L3G4200D_DefaultConfig,
+          typename Transport = L3G4200D_HardwareSPI<Config::SPI_FREQUENCY>>
+class L3G4200D {
+
+  static_assert(Config::BANDWIDTH != GYRO_BANDWIDTH_AUTO,
+                "Pick a specific bandwidth for L3G4200D");
+
+public:
+  /*! @brief Create a new object representing an @htmlonly L3G4200D
+   * @endhtmlonly gyroscope. */
+  L3G4200D() {
+    _range = Config::RANGE;
+    _lastSampleSaturated = false;
+  }
+
+  /*! @brief Initializes this L3G4200D gyroscope. See
+   * L3G4200D_Unified::begin.
+   *
+   * @param args The arguments for the transport's `begin`: the CS pin and
+   * optionally the `SPIClass` for L3G4200D_HardwareSPI, the four pins for
+   * L3G4200D_SoftwareSPI, or the `TwoWire` and address for L3G4200D_I2C.
+   *
+   * @returns True if this sensor was successfully activated, false if it was
+   * not.
+   */
+  template <typename... Args> bool begin(Args &&...args) {
+    if (!_bus.begin(args...)) {
+      return false;
+    }
+
+    uint8_t chipId;
+    _bus.readRegs(REG_WHO_AM_I, &chipId, 1);
+    if (chipId != L3G4200D_CHIP_ID) {
+      if (Config::DEBUG_LOGGING) {
+        Serial.print("[L3G4200D]: Expected chip ID ");
+        Serial.print(L3G4200D_CHIP_ID);
+        Serial.print(", but got ");
+        Serial.print(chipId);
+        Serial.print(". Check your wiring.\n");
+      }
+      return false;
+    }
+
+    uint8_t ctrl[5];
+    ctrl[0] = Config::DATA_RATE | Config::BANDWIDTH | Config::AXES;
+    ctrl[1] = CTRL2_HIGH_PASS_DIV_12;
+    ctrl[2] = CTRL3_DRIVE_HIGH_AND_LOW;
+    ctrl[3] = CTRL4_UPDATE_MSB_AND_LSB_TOGETHER | CTRL4_LSB_AT_LOWER_ADDRESS |
+              Config::RANGE;
+    ctrl[4] = CTRL5_NO_FILTERING;
+    _bus.writeRegs(REG_CTRL_1, ctrl, sizeof(ctrl));
+
+    _range = Config::RANGE;
+    _autoRangeState.reset();
+
+    return true;
+  }
+
+  /*! @brief Reads the raw sample for the axes in `Config::AXES`, in one
+   * burst. The other axes are 0.
+   *
+   * @param sample [out] The raw sample.
+   */
+  void readRaw(gyroSample_t &sample) {
+    uint8_t bytes[6];
+    memset(bytes, 0, sizeof(bytes));
+    _bus.readRegs(REG_OUT_X_L + 2 * FIRST_AXIS, &bytes[2 * FIRST_AXIS],
+                  2 * (LAST_AXIS - FIRST_AXIS + 1));
+
+    sample = L3G4200D_Unified::sampleFromBytes(bytes);
+    _lastSampleSaturated = L3G4200D_Unified::isSaturated(sample);
+
+    if (Config::DEBUG_LOGGING) {
+      Serial.print("[L3G4200D]: Raw X, Y, Z samples: ");
+      Serial.print(sample.x);
+      Serial.print(", ");
+      Serial.print(sample.y);
+      Serial.print(", ");
+      Serial.print(sample.z);
+      Serial.print("\n");
+    }
+  }
+
+  /*! @brief Reads the sensor and converts the axes in `Config::AXES` to
+   * rad/s. The other axes are left untouched. See
+   * L3G4200D_Unified::getEvent.
+   *
+   * @param event [out] A pointer to a sensors_event_t object to populate.
+   *
+   * @returns True.
+   */
+  bool getEvent(sensors_event_t *event) {
+    gyroSample_t sample;
+    readRaw(sample);
+
+    const float radiansPerCount = radiansPerCountAt(range());
+    if (Config::AXES & CTRL1_X_ENABLE) {
+      event->gyro.x = sample.x * radiansPerCount;
+    }
+    if (Config::AXES & CTRL1_Y_ENABLE) {
+      event->gyro.y = sample.y * radiansPerCount;
+    }
+    if (Config::AXES & CTRL1_Z_ENABLE) {
+      event->gyro.z = sample.z * radiansPerCount;
+    }
+
+    autoRange(sample);
+    return true;
+  }
+
+  /*! @brief Like @ref getEvent, but without any floating point math. See
+   * L3G4200D_Unified::getEventFixed.
+   *
+   * @param event [out] A pointer to a ::gyroFixedEvent_t to populate.
+   *
+   * @returns True.
+   */
+  bool getEventFixed(gyroFixedEvent_t *event) {
+    return readFixed(event, fixedScaleAt(range()), L3G4200D_FIXED_SHIFT);
+  }
+
+  /*! @brief Like @ref getEventFixed, but in milliradians per second. See
+   * L3G4200D_Unified::getEventMilliRad.
+   *
+   * @param event [out] A pointer to a ::gyroFixedEvent_t to populate.
+   *
+   * @returns True.
+   */
+  bool getEventMilliRad(gyroFixedEvent_t *event) {
+    return readFixed(event, milliRadScaleAt(range()),
+                     L3G4200D_MILLIRAD_SHIFT);
+  }
+
+  /*! @brief Returns whether the last sample was at the limit of its range.
+   * @returns True if the last sample was saturated.
+   */
+  bool lastSampleSaturated() const { return _lastSampleSaturated; }
+
+  /*! @brief Returns the current range. This is always `Config::RANGE`
+   * unless `Config::AUTO_RANGE` is set.
+   * @returns The current range.
+   */
+  gyroRange_t range() const {
+    if (!Config::AUTO_RANGE) {
+      return Config::RANGE;
+    }
+    return _range;
+  }
+
+  /*! @brief Gets the transport, for example to look at its
+   * L3G4200D_TransportStats::stats.
+   * @returns The transport this gyroscope is read through.
+   */
+  Transport &transport() { return _bus; }
+
+private:
+  // The first and last axis in Config::AXES (0 for X, 1 for Y, 2 for Z), so
+  // we read the shortest burst that covers them.
+  static constexpr uint8_t FIRST_AXIS = (Config::AXES & CTRL1_X_ENABLE)   ? 0
+                                        : (Config::AXES & CTRL1_Y_ENABLE) ? 1
+                                                                          : 2;
+  static constexpr uint8_t LAST_AXIS = (Config::AXES & CTRL1_Z_ENABLE)   ? 2
+                                       : (Config::AXES & CTRL1_Y_ENABLE) ? 1
+                                                                         : 0;
+
+  Transport _bus;
+  gyroRange_t _range;
+  bool _lastSampleSaturated;
+  L3G4200D_AutoRange _autoRangeState;
+
+  // The same scale factors as L3G4200D_Unified::updateScaleFactors().
+  static constexpr float halfRangeAt(gyroRange_t range) {
+    return range == GYRO_RANGE_34_DOT_91_RAD_PER_SEC
+               ? L3G4200D_HALF_RANGE_34_DOT_91
+           : range == GYRO_RANGE_8_DOT_73_RAD_PER_SEC
+               ? L3G4200D_HALF_RANGE_8_DOT_73
+               : L3G4200D_HALF_RANGE_4_DOT_36;
+  }
+
+  static constexpr float radiansPerCountAt(gyroRange_t range) {
+    return halfRangeAt(range) / INT16_MAX;
+  }
+
+  static constexpr int32_t fixedScaleAt(gyroRange_t range) {
+    return range == GYRO_RANGE_34_DOT_91_RAD_PER_SEC
+               ? L3G4200D_FIXED_SCALE(L3G4200D_HALF_RANGE_34_DOT_91)
+           : range == GYRO_RANGE_8_DOT_73_RAD_PER_SEC
+               ? L3G4200D_FIXED_SCALE(L3G4200D_HALF_RANGE_8_DOT_73)
+               : L3G4200D_FIXED_SCALE(L3G4200D_HALF_RANGE_4_DOT_36);
+  }
+
+  static constexpr int32_t milliRadScaleAt(gyroRange_t range) {
+    return range == GYRO_RANGE_34_DOT_91_RAD_PER_SEC
+               ? L3G4200D_MILLIRAD_SCALE(L3G4200D_HALF_RANGE_34_DOT_91)
+           : range == GYRO_RANGE_8_DOT_73_RAD_PER_SEC
+               ? L3G4200D_MILLIRAD_SCALE(L3G4200D_HALF_RANGE_8_DOT_73)
+               : L3G4200D_MILLIRAD_SCALE(L3G4200D_HALF_RANGE_4_DOT_36);
+  }
+
+  static int32_t toFixed(int16_t sample, int32_t scale, uint8_t shift) {
+    int32_t scaled = (int32_t)sample * scale;
+    return (scaled + (1L << (shift - 1))) >> shift;
+  }
+
+  // The scale is worked out before the sample is read, but auto-ranging only
+  // changes the range after it has been converted, so they always match.
+  bool readFixed(gyroFixedEvent_t *event, int32_t scale, uint8_t shift) {
+    gyroSample_t sample;
+    readRaw(sample);
+
+    if (Config::AXES & CTRL1_X_ENABLE) {
+      event->x = toFixed(sample.x, scale, shift);
+    }
+    if (Config::AXES & CTRL1_Y_ENABLE) {
+      event->y = toFixed(sample.y, scale, shift);
+    }
+    if (Config::AXES & CTRL1_Z_ENABLE) {
+      event->z = toFixed(sample.z, scale, shift);
+    }
+
+    autoRange(sample);
+    return true;
+  }
+
+  void autoRange(const gyroSample_t &sample) {
+    if (!Config::AUTO_RANGE) {
+      return;
+    }
+
+    gyroRange_t range =
+        _autoRangeState.update(sample, _range, _lastSampleSaturated);
+    if (range != _range) {
+      _range = range;
+
+      uint8_t ctrl4 = CTRL4_UPDATE_MSB_AND_LSB_TOGETHER |
+                      CTRL4_LSB_AT_LOWER_ADDRESS | range;
+      _bus.writeRegs(REG_CTRL_4, &ctrl4, 1);
+    }
+  }
+};
+
+#endif
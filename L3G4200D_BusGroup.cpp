@@ -0,0 +1,95 @@
+#include "L3G4200D_BusGroup.h"
+
+L3G4200D_BusGroup::L3G4200D_BusGroup() { _count = 0; }
+
+bool L3G4200D_BusGroup::add(L3G4200D_Unified &gyro) {
+  if (_count >= L3G4200D_BUS_GROUP_MAX_DEVICES) {
+    return false;
+  }
+
+  // We only start one transaction for everyone, so everyone has to be on the
+  // same bus.
+  if (_count > 0 && gyro._spi != _devices[0]->_spi) {
+    return false;
+  }
+
+  _devices[_count] = &gyro;
+  _count++;
+
+  return true;
+}
+
+size_t L3G4200D_BusGroup::size() const { return _count; }
+
+bool L3G4200D_BusGroup::readAll(gyroBusFrame_t *frame) {
+  frame->count = 0;
+  if (_count == 0 || !startGroupTransaction()) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    uint8_t bytes[6];
+    _devices[i]->frameReadRegs(REG_OUT_X_L, bytes, sizeof(bytes));
+    frame->timestamp[i] = micros();
+
+    gyroSample_t sample = L3G4200D_Unified::sampleFromBytes(bytes);
+    frame->x[i] = sample.x;
+    frame->y[i] = sample.y;
+    frame->z[i] = sample.z;
+  }
+  frame->count = _count;
+
+  endGroupTransaction();
+  return true;
+}
+
+size_t L3G4200D_BusGroup::drainFifos(gyroSample_t *buf, size_t maxPerDevice,
+                                     size_t *counts, uint32_t *timestamps) {
+  for (uint8_t i = 0; i < _count; i++) {
+    counts[i] = 0;
+  }
+  if (_count == 0 || !startGroupTransaction()) {
+    return 0;
+  }
+
+  size_t total = 0;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    counts[i] = _devices[i]->drainFifo(&buf[i * maxPerDevice], maxPerDevice);
+    if (timestamps != NULL) {
+      timestamps[i] = micros();
+    }
+
+    total += counts[i];
+  }
+
+  endGroupTransaction();
+
+  return total;
+}
+
+bool L3G4200D_BusGroup::startGroupTransaction() {
+  // A read started with startRead() is still waiting for pollReadComplete(),
+  // and reading that gyroscope now would take its sample.
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_devices[i]->_asyncReadBusy) {
+      return false;
+    }
+  }
+
+  // Every gyroscope's interrupt handler has to keep off the bus until we're
+  // done, not just the first's, whose transaction it is.
+  for (uint8_t i = 1; i < _count; i++) {
+    _devices[i]->holdBus();
+  }
+  _devices[0]->startSpiTransaction();
+
+  return true;
+}
+
+void L3G4200D_BusGroup::endGroupTransaction() {
+  _devices[0]->endSpiTransaction();
+  for (uint8_t i = 1; i < _count; i++) {
+    _devices[i]->releaseBus();
+  }
+}
@@ -0,0 +1,132 @@
+/*!
+ * @file L3G4200D_BusGroup.h
+ *
+ * Reading several L3G4200D gyroscopes that share one SPI bus.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_BUS_GROUP_H
+#define L3G4200D_BUS_GROUP_H
+
+#include "L3G4200D_U.h"
+
+/*! @brief The most gyroscopes one L3G4200D_BusGroup can hold. */
+#ifndef L3G4200D_BUS_GROUP_MAX_DEVICES
+#define L3G4200D_BUS_GROUP_MAX_DEVICES (4)
+#endif
+
+/*!
+ * @ingroup sensor
+ * @{
+ */
+
+/*!
+ * @brief One raw sample from every gyroscope in an L3G4200D_BusGroup, stored
+ * axis by axis so each axis can be processed as one contiguous array.
+ *
+ * Index `i` of each array belongs to the `i`th gyroscope added to the group.
+ */
+typedef struct {
+  int16_t x[L3G4200D_BUS_GROUP_MAX_DEVICES]; /*!< Raw X-axis samples. */
+  int16_t y[L3G4200D_BUS_GROUP_MAX_DEVICES]; /*!< Raw Y-axis samples. */
+  int16_t z[L3G4200D_BUS_GROUP_MAX_DEVICES]; /*!< Raw Z-axis samples. */
+
+  /*! The `micros()` time each gyroscope's sample was read at. */
+  uint32_t timestamp[L3G4200D_BUS_GROUP_MAX_DEVICES];
+
+  /*! The number of gyroscopes that were read. */
+  uint8_t count;
+} gyroBusFrame_t;
+
+/*!
+ * @brief A group of L3G4200D_Unified gyroscopes on the same SPI bus (each with
+ * its own Chip Select pin) that are read together.
+ *
+ * Reading each gyroscope on its own starts and ends a whole SPI transaction
+ * for every read. A group starts one transaction, reads every gyroscope back
+ * to back by toggling their Chip Select pins, and then ends the transaction.
+ *
+ * @code{.cpp}
+ * L3G4200D_Unified gyroA = L3G4200D_Unified(1);
+ * L3G4200D_Unified gyroB = L3G4200D_Unified(2);
+ * L3G4200D_BusGroup gyros;
+ *
+ * gyroA.begin(9);
+ * gyroB.begin(10);
+ * gyros.add(gyroA);
+ * gyros.add(gyroB);
+ *
+ * gyroBusFrame_t frame;
+ * gyros.readAll(&frame);
+ * @endcode
+ *
+ * The SPI settings of the first gyroscope added are used for the whole group.
+ */
+class L3G4200D_BusGroup {
+
+public:
+  /*! @brief Create a new, empty group. */
+  L3G4200D_BusGroup();
+
+  /*! @brief Adds a gyroscope to this group. Call this after
+   * L3G4200D_Unified::begin.
+   *
+   * @param gyro The gyroscope to add. It must stay alive as long as this
+   * group is used.
+   *
+   * @returns True if the gyroscope was added, false if the group is full or
+   * the gyroscope is on a different SPI bus than the others in the group.
+   */
+  bool add(L3G4200D_Unified &gyro);
+
+  /*! @brief Returns the number of gyroscopes in this group. */
+  size_t size() const;
+
+  /*! @brief Reads one sample from every gyroscope in one SPI transaction.
+   *
+   * @param frame [out] Where to store the samples and the time each one was
+   * read.
+   *
+   * @returns True if the samples were read, false if the group is empty or
+   * a read started with L3G4200D_Unified::startRead hasn't been finished
+   * with L3G4200D_Unified::pollReadComplete.
+   */
+  bool readAll(gyroBusFrame_t *frame);
+
+  /*! @brief Drains the hardware FIFO of every gyroscope in one SPI
+   * transaction, going through the gyroscopes in the order they were added.
+   * The FIFO of each gyroscope must have been enabled with
+   * L3G4200D_Unified::enableFifo.
+   *
+   * @param buf [out] Where to store the samples. The samples of the `i`th
+   * gyroscope start at `buf[i * maxPerDevice]`, so this needs room for
+   * `size() * maxPerDevice` samples.
+   * @param maxPerDevice The most samples to read from each gyroscope.
+   * @param counts [out] The number of samples read from each gyroscope. Needs
+   * room for `size()` values.
+   * @param timestamps [out] Optional. The `micros()` time each gyroscope's
+   * FIFO was drained at. Needs room for `size()` values.
+   *
+   * @returns The total number of samples read. Nothing is read while a read
+   * started with L3G4200D_Unified::startRead hasn't been finished.
+   */
+  size_t drainFifos(gyroSample_t *buf, size_t maxPerDevice, size_t *counts,
+                    uint32_t *timestamps = NULL);
+
+private:
+  L3G4200D_Unified *_devices[L3G4200D_BUS_GROUP_MAX_DEVICES];
+  uint8_t _count;
+
+  /*! @brief Starts the group's SPI transaction, keeping every gyroscope's
+   * interrupt handler off the bus until endGroupTransaction().
+   * @returns False if a gyroscope is in the middle of a startRead(). */
+  bool startGroupTransaction();
+
+  /*! @brief Ends the group's SPI transaction. */
+  void endGroupTransaction();
+};
+
+/*! @} */ // End group sensor.
+
+#endif
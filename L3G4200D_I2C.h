@@ -0,0 +1,129 @@
+/*!
+ * @file L3G4200D_I2C.h
+ *
+ * An I2C transport for the compile-time configured L3G4200D driver. This is
+ * in its own header so boards that only use SPI don't pull in `Wire`.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_I2C_H
+#define L3G4200D_I2C_H
+
+#include <Wire.h>
+
+#include "L3G4200D_Transport.h"
+
+/*! @brief The L3G4200D's I2C address when its SDO pin is pulled low. */
+#define L3G4200D_I2C_ADDRESS_SDO_LOW (0x68)
+
+/*! @brief The L3G4200D's I2C address when its SDO pin is pulled high, which is
+ * how most breakout boards wire it. */
+#define L3G4200D_I2C_ADDRESS_SDO_HIGH (0x69)
+
+/*!
+ * @ingroup sensor
+ * @{
+ */
+
+/*!
+ * @brief Talks to the gyroscope over I2C, for boards whose SPI bus is taken.
+ * The gyroscope's CS pin must be tied high to put it in I2C mode.
+ *
+ * Reads are one transfer: the register address is written, then a repeated
+ * start (rather than a stop) turns the bus around to read the registers back.
+ * Setting the top bit of the register address makes the gyroscope
+ * auto-increment it, so a whole sample comes back in one burst.
+ *
+ * A 7-byte burst is about 100 bit times on the bus, so at 400 kHz a sample
+ * takes around 250 us, enough for the 400 Hz data rate.
+ *
+ * @code{.cpp}
+ * #include <L3G4200D.h>
+ * #include <L3G4200D_I2C.h>
+ *
+ * L3G4200D<L3G4200D_DefaultConfig, L3G4200D_I2C<>> gyro;
+ *
+ * void setup() {
+ *   gyro.begin(Wire, L3G4200D_I2C_ADDRESS_SDO_HIGH);
+ * }
+ * @endcode
+ *
+ * @tparam Clock The I2C clock frequency. The L3G4200D datasheet only goes up
+ * to 400 kHz fast mode; faster clocks may work on short buses, but aren't
+ * guaranteed.
+ */
+template <uint32_t Clock = 400000L>
+class L3G4200D_I2C : public L3G4200D_TransportStats {
+
+public:
+  /*! @brief Starts the I2C bus.
+   *
+   * @param wire The I2C interface to use. Defaults to `Wire`.
+   * @param address The gyroscope's I2C address, which depends on its SDO pin.
+   * Defaults to @ref L3G4200D_I2C_ADDRESS_SDO_HIGH.
+   *
+   * @returns True.
+   */
+  bool begin(TwoWire &wire = Wire,
+             uint8_t address = L3G4200D_I2C_ADDRESS_SDO_HIGH) {
+    _wire = &wire;
+    _address = address;
+
+    _wire->begin();
+    _wire->setClock(Clock);
+
+    return true;
+  }
+
+  /*! @brief Reads @p count consecutive registers in one transfer. @p count
+   * must fit in the `Wire` buffer, which is 32 bytes on most cores.
+   *
+   * If the gyroscope doesn't acknowledge, @p buf is filled with zeros. */
+  void readRegs(uint8_t startAddress, uint8_t *buf, size_t count) {
+    _wire->beginTransmission(_address);
+    _wire->write(subAddress(startAddress, count));
+
+    // Keep the bus, so the read comes straight after a repeated start.
+    uint8_t received = 0;
+    if (_wire->endTransmission(false) == 0) {
+      received = _wire->requestFrom(_address, (uint8_t)count);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      buf[i] = (i < received) ? _wire->read() : 0;
+    }
+
+    // The address byte is sent twice, once to write and once to read.
+    countTransaction(3 + count);
+  }
+
+  /*! @brief Writes @p count consecutive registers in one transfer. */
+  void writeRegs(uint8_t startAddress, const uint8_t *values, size_t count) {
+    _wire->beginTransmission(_address);
+    _wire->write(subAddress(startAddress, count));
+    _wire->write(values, count);
+    _wire->endTransmission();
+
+    countTransaction(2 + count);
+  }
+
+private:
+  TwoWire *_wire;
+  uint8_t _address;
+
+  /* The L3G4200D I2C sub-address (register address) is:
+   * 1 bit:  HIGH indicates auto-increment address across multiple reads or
+   *         writes, so we only assert it for more than one register.
+   * 7 bits: The address of the register to start at.
+   *
+   * This is a different bit than over SPI, where the top bit means read.
+   */
+  static uint8_t subAddress(uint8_t startAddress, size_t count) {
+    return startAddress | (count > 1 ? 0x80 : 0);
+  }
+};
+
+/*! @} */ // End group sensor.
+
+#endif
@@ -0,0 +1,717 @@
+/*!
+ * @file L3G4200D_Registers.h
+ *
+ * The L3G4200D's register addresses and bit values. Only macros, so it can be
+ * shared with code that doesn't have the Arduino core, such as the Linux
+ * backend in extras/linux.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_REGISTERS_H
+#define L3G4200D_REGISTERS_H
+
+/*!
+ * @defgroup registers Registers
+ *
+ * @brief This contains advanced functionality for reading and writing to raw
+ * gyroscope registers. If you just want to read gyro data, you probably want
+ * @ref usage or @ref sensor instead.
+ *
+ * @see L3G4200D_Unified
+ *
+ * @{
+ */
+
+/*! @name Addresses
+ * @anchor reg_addresses
+ * @{
+ */
+
+/*! @brief The address of the chip ID register. Should always read as `0xd3`.
+ *
+ * @see L3G42000D_CHIP_ID
+ */
+#define REG_WHO_AM_I (0x0F)
+
+/*! @brief The address of CTRL_REG1, which is used for bandwidth, data rate, and
+ * power selection.
+ *
+ * @see CTRL1.
+ */
+#define REG_CTRL_1 (0x20)
+
+/*! @brief The address of CTRL_REG2, which is used for configuring the high pass
+ * filter.
+ *
+ * @see CTRL2.
+ */
+#define REG_CTRL_2 (0x21)
+
+/*! @brief The address of CTRL_REG3, which is used for configuring the
+ * electrical characteristics of the pins on the chip.
+ *
+ * @see CTRL3.
+ */
+#define REG_CTRL_3 (0x22)
+
+/*! @brief The address of CTRL_REG4, which is used for setting the gyroscope
+ * range.
+ *
+ * @see CTRL4.
+ */
+#define REG_CTRL_4 (0x23)
+
+/*! @brief The address of CTRL_REG5, which is used for enabling different kinds
+ * of filtering.
+ *
+ * @see CTRL5.
+ */
+#define REG_CTRL_5 (0x24)
+
+/*! @brief The address of REFERENCE, which holds the reference value for the
+ * high pass filter's reference mode. Reading it resets the high pass filter
+ * in the normal reset mode.
+ *
+ * @see high_pass_mode
+ */
+#define REG_REFERENCE (0x25)
+
+/*! @brief The address of OUT_TEMP, which has the temperature of the
+ * gyroscope, as -1 per degree Celsius from an uncalibrated offset.
+ */
+#define REG_OUT_TEMP (0x26)
+
+/*! @brief The address of STATUS_REG, which says whether a new sample is ready
+ * and whether any samples were overwritten before being read.
+ *
+ * @see STATUS.
+ */
+#define REG_STATUS (0x27)
+
+/*! @brief The address of OUT_X_L, which contains the low byte of the X-axis
+ * angular data, as two's complement.
+ */
+#define REG_OUT_X_L (0x28)
+
+/*! @brief The address of OUT_X_L, which contains the high byte of the X-axis
+ * angular data, as two's complement.
+ */
+#define REG_OUT_X_H (0x29)
+
+/*! @brief The address of OUT_X_H, which contains the low byte of the Y-axis
+ * angular data, as two's complement.
+ */
+#define REG_OUT_Y_L (0x2a)
+
+/*! @brief The address of OUT_Y_L, which contains the high byte of the Y-axis
+ * angular data, as two's complement.
+ */
+#define REG_OUT_Y_H (0x2b)
+
+/*! @brief The address of OUT_X_L, which contains the low byte of the Z-axis
+ * angular data, as two's complement.
+ */
+#define REG_OUT_Z_L (0x2c)
+
+/*! @brief The address of OUT_X_L, which contains the high byte of the Z-axis
+ * angular data, as two's complement.
+ */
+#define REG_OUT_Z_H (0x2d)
+
+/*! @brief The address of FIFO_CTRL_REG, which is used for selecting the FIFO
+ * mode and the FIFO watermark level.
+ *
+ * @see FIFO_CTRL.
+ */
+#define REG_FIFO_CTRL (0x2e)
+
+/*! @brief The address of FIFO_SRC_REG, which contains the FIFO status flags
+ * and the number of unread samples stored in the FIFO.
+ *
+ * @see FIFO_SRC.
+ */
+#define REG_FIFO_SRC (0x2f)
+
+/*! @brief The chip ID constant value of [REG_WHO_AM_I](@ref REG_WHO_AM_I):
+ * `0xd3`.
+ *
+ * This should be the only value ever read from @ref REG_WHO_AM_I.
+ * If you get a different value, your wires may not be connected correctly.
+ */
+#define L3G4200D_CHIP_ID (0xd3)
+
+/*!
+ * @}
+ */
+
+/*!
+ * @addtogroup CTRL1
+ * @ingroup registers
+ *
+ * @brief Values for @ref REG_CTRL_1, which is used for bandwidth, data rate,
+ * and power selection.
+ *
+ * @{
+ */
+
+/*! @name Output data rate and filtering
+ * @anchor rate_filtering
+ *
+ * These values of @ref REG_CTRL_1 set the output data rate and the "low-pass"
+ * filtering bandwidth. The low-pass filtering is for "smoothing out" changes
+ * that occur too quickly to be useful.
+ *
+ * These values can be or'd with other `CTRL1_` values when writing to
+ * @ref REG_CTRL_1.
+ *
+ * @{
+ */
+
+// Bits 7:6 set the output data rate, and bits 5:4 set the "low-pass" filtering
+// bandwidth.
+
+/*! @brief REG_CTRL_1 value for a 100 Hz data rate and a 12.5 Hz cutoff. */
+#define CTRL1_RATE_100HZ_CUTOFF_12HZ5 (0b0000 << 4)
+
+/*! @brief REG_CTRL_1 value for a 100 Hz data rate and a 25 Hz cutoff. */
+#define CTRL1_RATE_100HZ_CUTOFF_25HZ (0b0001 << 4)
+
+/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 12.5 Hz cutoff. */
+#define CTRL1_RATE_200HZ_CUTOFF_12HZ5 (0b0100 << 4)
+
+/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 25 Hz cutoff. */
+#define CTRL1_RATE_200HZ_CUTOFF_25HZ (0b0101 << 4)
+
+/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 50 Hz cutoff. */
+#define CTRL1_RATE_200HZ_CUTOFF_50HZ (0b0110 << 4)
+
+/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 70 Hz cutoff. */
+#define CTRL1_RATE_200HZ_CUTOFF_70HZ (0b0111 << 4)
+
+/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 20 Hz cutoff. */
+#define CTRL1_RATE_400HZ_CUTOFF_20HZ (0b1000 << 4)
+
+/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 2 Hz cutoff. */
+#define CTRL1_RATE_400HZ_CUTOFF_25HZ (0b1001 << 4)
+
+/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 50 Hz cutoff. */
+#define CTRL1_RATE_400HZ_CUTOFF_50HZ (0b1010 << 4)
+
+/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 110 Hz cutoff. */
+#define CTRL1_RATE_400HZ_CUTOFF_110HZ (0b1011 << 4)
+
+/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 30 Hz cutoff. */
+#define CTRL1_RATE_800HZ_CUTOFF_30HZ (0b1100 << 4)
+
+/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 35 Hz cutoff. */
+#define CTRL1_RATE_800HZ_CUTOFF_35HZ (0b1101 << 4)
+
+/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 50 Hz cutoff. */
+#define CTRL1_RATE_800HZ_CUTOFF_50HZ (0b1110 << 4)
+
+/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 110 Hz cutoff. */
+#define CTRL1_RATE_800HZ_CUTOFF_110HZ (0b1111 << 4)
+
+/*! @brief Mask for the data rate and cutoff bits of @ref REG_CTRL_1. */
+#define CTRL1_RATE_CUTOFF_MASK (0b1111 << 4)
+
+/*! @brief Mask for just the data rate bits of @ref REG_CTRL_1. */
+#define CTRL1_RATE_MASK (0b11 << 6)
+
+/*! @brief Mask for just the cutoff bits of @ref REG_CTRL_1. */
+#define CTRL1_CUTOFF_MASK (0b11 << 4)
+
+/*! @} */ // End member group rate_filtering.
+
+/*! @name Power and axes settings
+ * @anchor power_axes
+ *
+ * These values of @ref REG_CTRL_1 set the power mode of the chip as a whole
+ * and for each of the X, Y, and Z axes.
+ * Turning off unncesseary axes saves power.
+ *
+ * These values can be or'd with other `CTRL1_` values when writing to
+ * @ref REG_CTRL_1
+ *
+ * @{
+ */
+
+// Bit 3 sets the power mode for the chip as a whole.
+// Bit 2 enables or disables the Z-axis.
+// Bit 1 enables or disables the Y-axis.
+// Bit 0 enables or disables the X-axis.
+
+/*! @brief REG_CTRL_1 value to power down the gyroscope. */
+#define CTRL1_POWER_DOWN (0b0000 << 0)
+
+/*! @brief REG_CTRL_1 value to put the gyroscope in sleep mode - on, but with no
+ * gyroscope axes enabled.
+ */
+#define CTRL1_SLEEP (0b1000 << 0)
+
+/*! @brief REG_CTRL_1 value to enable the X-axis only. */
+#define CTRL1_X_ONLY (0b1001 << 0)
+
+/*! @brief REG_CTRL_1 value to enable the Y-axis only. */
+#define CTRL1_Y_ONLY (0b1010 << 0)
+
+/*! @brief REG_CTRL_1 value to enable the Z-axis only. */
+#define CTRL1_Z_ONLY (0b1100 << 0)
+
+/*! @brief REG_CTRL_1 value to enable the X and Y axes only. */
+#define CTRL1_XY (0b1011 << 0)
+
+/*! @brief REG_CTRL_1 value to enable the Y and Z axes only. */
+#define CTRL1_YZ (0b1110 << 0)
+
+/*! @brief REG_CTRL_1 value to enable the X and Z axes only. */
+#define CTRL1_XZ (0b1101 << 0)
+
+/*! @brief REG_CTRL_1 value to enable all axes. This is probably what you want.
+ */
+#define CTRL1_XYZ (0b1111 << 0)
+
+/*! @brief Mask for the power and axes bits of @ref REG_CTRL_1. */
+#define CTRL1_POWER_AXES_MASK (0b1111 << 0)
+
+/*! @brief REG_CTRL_1 bit that is set when the X-axis is enabled. */
+#define CTRL1_X_ENABLE (0b1 << 0)
+
+/*! @brief REG_CTRL_1 bit that is set when the Y-axis is enabled. */
+#define CTRL1_Y_ENABLE (0b1 << 1)
+
+/*! @brief REG_CTRL_1 bit that is set when the Z-axis is enabled. */
+#define CTRL1_Z_ENABLE (0b1 << 2)
+
+/*! @} */ // End member group power_axes.
+/*! @} */ // End group CTRL1.
+
+/*!
+ * @addtogroup CTRL2
+ * @ingroup registers
+ *
+ * @brief Values for @ref REG_CTRL_2, which is used for configuring the
+ * high pass filter.
+ *
+ * @{
+ */
+
+/*! @name High pass filter setting
+ * @anchor high_pass_divisor
+ *
+ * @brief Values for @ref REG_CTRL_2 that control the high pass filter.
+ *
+ * The high pass filter rejects movements that are too slow to be useful.
+ * The value used for filtering is expressed as a fraction of the clock rate.
+ * To figure out the filter frequency, divide the output data rate by the
+ * number at the end of these constants.
+ *
+ * For example, if you want to detect gestures, you might not be interested
+ * in various slow movements (which wouldn't be part of a sharp gesture).
+ * If your data rate were 200 Hz, and you don't care about gestures that happen
+ * over less than 1 second, then you might want HIGH_PASS_DIV_200,
+ * since 200 Hz / 200 = 1 Hz.
+ *
+ * @{
+ */
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 12.
+ */
+#define CTRL2_HIGH_PASS_DIV_12 (0b0000 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 25.
+ */
+#define CTRL2_HIGH_PASS_DIV_25 (0b0001 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 50.
+ */
+#define CTRL2_HIGH_PASS_DIV_50 (0b0010 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 100.
+ */
+#define CTRL2_HIGH_PASS_DIV_100 (0b0011 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 200.
+ */
+#define CTRL2_HIGH_PASS_DIV_200 (0b0100 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 500.
+ */
+#define CTRL2_HIGH_PASS_DIV_500 (0b0101 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
+ * 1000. */
+#define CTRL2_HIGH_PASS_DIV_1000 (0b0110 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
+ * 2000. */
+#define CTRL2_HIGH_PASS_DIV_2000 (0b0111 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
+ * 5000. */
+#define CTRL2_HIGH_PASS_DIV_5000 (0b1000 << 0)
+
+/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
+ * 10000. */
+#define CTRL2_HIGH_PASS_DIV_10000 (0b1001 << 0)
+
+/*! @brief Mask for the high pass filter divisor bits of @ref REG_CTRL_2. */
+#define CTRL2_HIGH_PASS_DIV_MASK (0b1111 << 0)
+
+/*! @} */ // End member group high_pass_divisor
+
+/*! @name High pass filter mode
+ * @anchor high_pass_mode
+ *
+ * @brief Values for @ref REG_CTRL_2 that set how the high pass filter is
+ * reset.
+ *
+ * @{
+ */
+
+/*! @brief REG_CTRL_2 value for the normal high pass filter mode, where
+ * reading @ref REG_REFERENCE resets the filter. This is the default. */
+#define CTRL2_HIGH_PASS_MODE_NORMAL_RESET (0b00 << 4)
+
+/*! @brief REG_CTRL_2 value for filtering relative to the value in
+ * @ref REG_REFERENCE. */
+#define CTRL2_HIGH_PASS_MODE_REFERENCE (0b01 << 4)
+
+/*! @brief REG_CTRL_2 value for the normal high pass filter mode. */
+#define CTRL2_HIGH_PASS_MODE_NORMAL (0b10 << 4)
+
+/*! @brief REG_CTRL_2 value to reset the high pass filter automatically on an
+ * interrupt event. */
+#define CTRL2_HIGH_PASS_MODE_AUTORESET (0b11 << 4)
+
+/*! @brief Mask for the high pass filter mode bits of @ref REG_CTRL_2. */
+#define CTRL2_HIGH_PASS_MODE_MASK (0b11 << 4)
+
+/*! @} */ // End member group high_pass_mode
+/*! @} */ // End group CTRL2
+
+/*!
+ * @addtogroup CTRL3
+ * @ingroup registers
+ *
+ * @brief Values for @ref REG_CTRL_3, which is used for configuring the
+ * electrical characteristics of the pins on the chip.
+ *
+ * @{
+ */
+
+/*! @brief REG_CTRL_3 value to indicate that the gyro chip should drive output
+ * pins HIGH and LOW, instead of using a pull-up resistor for logic HIGH.
+ */
+#define CTRL3_DRIVE_HIGH_AND_LOW (0b0 << 4)
+
+/*! @brief REG_CTRL_3 value to indicate that the gyro chip should not drive
+ * output pins HIGH, and instead use a pull-up resistor for logic HIGH.
+ */
+#define CTRL3_USE_PULL_UP_FOR_HIGH (0b1 << 4)
+
+/*! @brief REG_CTRL_3 value to signal on the INT2/DRDY pin whenever a new
+ * sample is ready. This can be or'd with other `CTRL3_` values.
+ */
+#define CTRL3_I2_DATA_READY (0b1 << 3)
+
+/*! @brief REG_CTRL_3 value to signal on the INT2/DRDY pin when the FIFO
+ * reaches its watermark level. This can be or'd with other `CTRL3_` values.
+ */
+#define CTRL3_I2_WATERMARK (0b1 << 2)
+
+/*! @brief REG_CTRL_3 value to signal on the INT2/DRDY pin when the FIFO
+ * overruns. This can be or'd with other `CTRL3_` values.
+ */
+#define CTRL3_I2_OVERRUN (0b1 << 1)
+
+/*! @brief REG_CTRL_3 value to signal on the INT2/DRDY pin when the FIFO is
+ * empty. This can be or'd with other `CTRL3_` values.
+ */
+#define CTRL3_I2_EMPTY (0b1 << 0)
+
+/*! @} */ // End group CTRL3.
+
+/*!
+ * @addtogroup CTRL4
+ * @ingroup registers
+ *
+ * @brief Values for @ref REG_CTRL_4, which is used for setting the gyroscope
+ * range.
+ *
+ * @{
+ */
+
+/*! @name Output register configuration
+ * @anchor out_reg_config
+ *
+ * These values of @ref REG_CTRL_4 control how the X, Y, and Z axis output
+ * registers contain and update their values.
+ *
+ * These values can be or'd with other `CTRL_4` values when writing to
+ * @ref REG_CTRL_4.
+ *
+ * @{
+ */
+
+/*! @brief REG_CTRL_4 value to indicate that the high byte and low byte of each
+ * output register should not update when we've read one but not the other.
+ */
+#define CTRL4_UPDATE_MSB_AND_LSB_TOGETHER (0b1 << 7)
+
+/*! @brief REG_CTRL_4 value to indicate that the low byte of each output
+ * register is at the lower address (as is displayed in the datasheet).
+ */
+#define CTRL4_LSB_AT_LOWER_ADDRESS (0b0 << 6)
+
+/*! @brief REG_CTRL_4 value to indicate that the high byte of each output
+ * register is at the higher address.
+ */
+#define CTRL4_MSB_AT_LOWER_ADDRESS (0b1 << 6)
+
+/*! @brief Mask for the @ref CTRL4_UPDATE_MSB_AND_LSB_TOGETHER bit of
+ * @ref REG_CTRL_4.
+ */
+#define CTRL4_BLOCK_DATA_UPDATE_MASK (0b1 << 7)
+
+/*! @} */ // End member group out_reg_config.
+
+/*! @name Gyro range settings
+ * @anchor gyro_range
+ *
+ * These values of @ref REG_CTRL_4 control the current range of the gyroscope
+ *
+ * These values can be or'd with other `CTRL4_` values when writing to
+ * @ref REG_CTRL_4
+ *
+ * @see ::gyroRange_t
+ *
+ * @{
+ */
+
+/*! @brief REG_CTRL_4 value for a gyroscope range of 250 deg/s. Corresponds to
+ * ::GYRO_RANGE_4_DOT_36_RAD_PER_SEC (4.36 rad/s).
+ */
+#define CTRL4_FULL_SCALE_250DPS (0b00 << 4)
+
+/*! @brief REG_CTRL_4 value for a gyroscope range of 500 deg/s. Corresponds to
+ * ::GYRO_RANGE_8_DOT_73_RAD_PER_SEC (8.73 rad/s).
+ */
+#define CTRL4_FULL_SCALE_500DPS (0b01 << 4)
+
+/*! @brief REG_CTRL_4 value for a gyroscope range of 2000 deg/s. Corresponds to
+ * ::GYRO_RANGE_34_DOT_91_RAD_PER_SEC (34.91 rad/s).
+ */
+#define CTRL4_FULL_SCALE_2000DPS (0b10 << 4)
+
+/*! @brief Mask for the full scale bits of @ref REG_CTRL_4. */
+#define CTRL4_FULL_SCALE_MASK (0b11 << 4)
+
+/*! @} */ // End member group gyro_range.
+
+/*! @} */ // End group CTRL4.
+
+/*!
+ * @addtogroup CTRL5
+ * @ingroup registers
+ *
+ * @brief Values for @ref REG_CTRL_5, which is used for enabling different
+ * kinds of filtering.
+ *
+ * @{
+ */
+
+/*! @brief REG_CTRL_5 value to disable both the low pass and high pass filter.
+ */
+#define CTRL5_NO_FILTERING ((0b00 << 0) | (0b0 << 4))
+
+/*! @brief REG_CTRL_5 value to enable the high pass filter only. */
+#define CTRL5_HIGH_PASS_FILTERING ((0b01 << 0) | (0b1 << 4))
+
+/*! @brief REG_CTRL_5 value to enable the low pass filter only. */
+#define CTRL5_LOW_PASS_FILTERING ((0b10 << 0) | (0b0 << 4))
+
+/*! @brief REG_CTRL_5 value to enable both the band pass filter (both high pass
+ * and low pass).
+ */
+#define CTRL5_BAND_PASS_FILTERING ((0b10 << 0) | (0b1 << 4))
+
+/*! @brief Mask for the filtering bits of @ref REG_CTRL_5. */
+#define CTRL5_FILTERING_MASK ((0b11 << 0) | (0b1 << 4))
+
+/*! @brief REG_CTRL_5 value to enable the 32-sample FIFO. This can be or'd with
+ * the other `CTRL5_` values.
+ *
+ * While the FIFO is enabled, reading past @ref REG_OUT_Z_H with the
+ * auto-increment bit set wraps back around to @ref REG_OUT_X_L, so many
+ * samples can be drained in one burst read.
+ */
+#define CTRL5_FIFO_ENABLE (0b1 << 6)
+
+/*! @brief REG_CTRL_5 bit that reloads the gyroscope's trimming values from
+ * its internal memory. It clears itself once the reload is done.
+ */
+#define CTRL5_REBOOT_MEMORY (0b1 << 7)
+
+// End group CTRL5.
+/*!
+ * @}
+ */
+
+/*!
+ * @addtogroup defaults
+ * @ingroup registers
+ *
+ * @brief What L3G4200D_Unified::begin writes to @ref REG_CTRL_1 through
+ * @ref REG_CTRL_5, so other backends can start the gyroscope the same way.
+ *
+ * @{
+ */
+
+/*! @brief Default REG_CTRL_1 value: 400 Hz with a 25 Hz cutoff, powered on,
+ * with every axis enabled.
+ */
+#define L3G4200D_DEFAULT_CTRL1 (CTRL1_RATE_400HZ_CUTOFF_25HZ | CTRL1_XYZ)
+
+/*! @brief Default REG_CTRL_2 value: a high-pass divisor of 12. */
+#define L3G4200D_DEFAULT_CTRL2 (CTRL2_HIGH_PASS_DIV_12)
+
+/*! @brief Default REG_CTRL_3 value: push-pull interrupts, all disabled. */
+#define L3G4200D_DEFAULT_CTRL3 (CTRL3_DRIVE_HIGH_AND_LOW)
+
+/*! @brief Default REG_CTRL_4 value, without the range: block data update, with
+ * the low byte at the lower address. One of the `CTRL4_FULL_SCALE_` values
+ * is or'd in.
+ */
+#define L3G4200D_DEFAULT_CTRL4                                                 \
+  (CTRL4_UPDATE_MSB_AND_LSB_TOGETHER | CTRL4_LSB_AT_LOWER_ADDRESS)
+
+/*! @brief Default REG_CTRL_5 value: no filtering, and the FIFO off. */
+#define L3G4200D_DEFAULT_CTRL5 (CTRL5_NO_FILTERING)
+
+/*! @} */ // End group defaults.
+
+/*!
+ * @addtogroup STATUS
+ * @ingroup registers
+ *
+ * @brief Bits of @ref REG_STATUS, which says whether a new sample is ready and
+ * whether any samples were overwritten before being read.
+ *
+ * @{
+ */
+
+/*! @brief REG_STATUS bit that is set when a new sample for any axis
+ * overwrote one that hadn't been read yet. */
+#define STATUS_XYZ_OVERRUN (0b1 << 7)
+
+/*! @brief REG_STATUS bit that is set when a new sample for the Z-axis
+ * overwrote one that hadn't been read yet. */
+#define STATUS_Z_OVERRUN (0b1 << 6)
+
+/*! @brief REG_STATUS bit that is set when a new sample for the Y-axis
+ * overwrote one that hadn't been read yet. */
+#define STATUS_Y_OVERRUN (0b1 << 5)
+
+/*! @brief REG_STATUS bit that is set when a new sample for the X-axis
+ * overwrote one that hadn't been read yet. */
+#define STATUS_X_OVERRUN (0b1 << 4)
+
+/*! @brief REG_STATUS bit that is set when there is a new sample for any axis
+ * that hasn't been read yet. */
+#define STATUS_XYZ_NEW_DATA (0b1 << 3)
+
+/*! @brief REG_STATUS bit that is set when there is a new Z-axis sample that
+ * hasn't been read yet. */
+#define STATUS_Z_NEW_DATA (0b1 << 2)
+
+/*! @brief REG_STATUS bit that is set when there is a new Y-axis sample that
+ * hasn't been read yet. */
+#define STATUS_Y_NEW_DATA (0b1 << 1)
+
+/*! @brief REG_STATUS bit that is set when there is a new X-axis sample that
+ * hasn't been read yet. */
+#define STATUS_X_NEW_DATA (0b1 << 0)
+
+/*! @} */ // End group STATUS.
+
+/*!
+ * @addtogroup FIFO_CTRL
+ * @ingroup registers
+ *
+ * @brief Values for @ref REG_FIFO_CTRL, which is used for selecting the FIFO
+ * mode and the FIFO watermark level.
+ *
+ * @{
+ */
+
+// Bits 7:5 set the FIFO mode, and bits 4:0 set the watermark level.
+
+/*! @brief REG_FIFO_CTRL value to bypass the FIFO, so only the newest sample is
+ * kept.
+ */
+#define FIFO_CTRL_MODE_BYPASS (0b000 << 5)
+
+/*! @brief REG_FIFO_CTRL value to fill the FIFO and then stop collecting
+ * samples until it is emptied.
+ */
+#define FIFO_CTRL_MODE_FIFO (0b001 << 5)
+
+/*! @brief REG_FIFO_CTRL value to keep collecting samples, discarding the oldest
+ * sample when the FIFO is full.
+ */
+#define FIFO_CTRL_MODE_STREAM (0b010 << 5)
+
+/*! @brief REG_FIFO_CTRL value to stream until an interrupt event occurs, and
+ * then switch to FIFO mode.
+ */
+#define FIFO_CTRL_MODE_STREAM_TO_FIFO (0b011 << 5)
+
+/*! @brief REG_FIFO_CTRL value to bypass until an interrupt event occurs, and
+ * then switch to stream mode.
+ */
+#define FIFO_CTRL_MODE_BYPASS_TO_STREAM (0b100 << 5)
+
+/*! @brief Mask for the watermark level bits of @ref REG_FIFO_CTRL. */
+#define FIFO_CTRL_WATERMARK_MASK (0b11111 << 0)
+
+/*! @} */ // End group FIFO_CTRL.
+
+/*!
+ * @addtogroup FIFO_SRC
+ * @ingroup registers
+ *
+ * @brief Bits of @ref REG_FIFO_SRC, which contains the FIFO status flags and
+ * the number of unread samples stored in the FIFO.
+ *
+ * @{
+ */
+
+/*! @brief REG_FIFO_SRC bit that is set when the FIFO level is at or above the
+ * watermark level.
+ */
+#define FIFO_SRC_WATERMARK (0b1 << 7)
+
+/*! @brief REG_FIFO_SRC bit that is set when the FIFO is completely full and
+ * samples are being overwritten or dropped.
+ */
+#define FIFO_SRC_OVERRUN (0b1 << 6)
+
+/*! @brief REG_FIFO_SRC bit that is set when the FIFO is empty. */
+#define FIFO_SRC_EMPTY (0b1 << 5)
+
+/*! @brief Mask for the stored sample count bits of @ref REG_FIFO_SRC. */
+#define FIFO_SRC_LEVEL_MASK (0b11111 << 0)
+
+/*! @brief The number of samples the L3G4200D FIFO can hold. */
+#define L3G4200D_FIFO_DEPTH (32)
+
+/*! @} */ // End group FIFO_SRC.
+
+// End group registers.
+/*!
+ * @}
+ */
+
+#endif
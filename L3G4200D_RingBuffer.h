@@ -0,0 +1,99 @@
+/*!
+ * @file L3G4200D_RingBuffer.h
+ *
+ * A small single-producer, single-consumer ring buffer used to hand samples
+ * from an interrupt handler to the main loop without disabling interrupts.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_RING_BUFFER_H
+#define L3G4200D_RING_BUFFER_H
+
+#include <stdint.h>
+
+// On AVR there is only one core and byte accesses are atomic, so keeping the
+// compiler from reordering is enough. Everywhere else, use a real fence so the
+// ring also works across cores.
+#if defined(__AVR__)
+#define L3G4200D_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define L3G4200D_RING_BARRIER() __sync_synchronize()
+#endif
+
+/*!
+ * @brief A lock-free ring buffer that is safe to use with exactly one producer
+ * (for example an interrupt handler) and exactly one consumer (for example the
+ * main loop).
+ *
+ * The head index is only ever written by the producer, and the tail index is
+ * only ever written by the consumer. Both indices run freely and wrap at 256,
+ * so the whole @p Capacity can be used.
+ *
+ * @tparam T The type of the items to store.
+ * @tparam Capacity The number of items the ring can hold. Must be a power of
+ * two no larger than 128.
+ */
+template <typename T, uint8_t Capacity> class L3G4200D_RingBuffer {
+  static_assert(Capacity > 0 && Capacity <= 128 &&
+                    (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two no larger than 128");
+
+public:
+  L3G4200D_RingBuffer() : _head(0), _tail(0) {}
+
+  /*! @brief Adds an item. Only call this from the producer.
+   * @returns True if the item was added, false if the ring was full and the
+   * item was dropped.
+   */
+  bool push(const T &item) {
+    uint8_t head = _head;
+    uint8_t tail = _tail;
+    if ((uint8_t)(head - tail) == Capacity) {
+      return false;
+    }
+
+    _items[head & (Capacity - 1)] = item;
+
+    // Make sure the item is stored before the consumer can see the new head.
+    L3G4200D_RING_BARRIER();
+    _head = head + 1;
+    return true;
+  }
+
+  /*! @brief Removes the oldest item. Only call this from the consumer.
+   * @returns True if an item was stored in @p item, false if the ring was
+   * empty.
+   */
+  bool pop(T &item) {
+    uint8_t tail = _tail;
+    uint8_t head = _head;
+    if (head == tail) {
+      return false;
+    }
+
+    // Make sure we read the item only after we've seen the head that covers
+    // it, and that we're done with it before the producer can reuse the slot.
+    L3G4200D_RING_BARRIER();
+    item = _items[tail & (Capacity - 1)];
+    L3G4200D_RING_BARRIER();
+    _tail = tail + 1;
+    return true;
+  }
+
+  /*! @brief Returns the number of items currently stored. */
+  uint8_t size() const { return (uint8_t)(_head - _tail); }
+
+  /*! @brief Returns true if there are no items stored. */
+  bool empty() const { return _head == _tail; }
+
+  /*! @brief Discards all stored items. Only call this from the consumer. */
+  void clear() { _tail = _head; }
+
+private:
+  T _items[Capacity];
+  volatile uint8_t _head;
+  volatile uint8_t _tail;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "L3G4200D_SampleClock.h"
+
+// How far the measured period may be from the nominal one before it's treated
+// as a bad fit (say, from a gap in the samples) and ignored: a fifth either
+// way. The L3G4200D's data rate is well within this.
+#define MAX_PERIOD_ERROR_DIVISOR (5)
+
+// The period is kept in 16.16 fixed point.
+#define PERIOD_SHIFT (16)
+
+// Divides, rounding to the nearest whole number with halves away from zero.
+// The denominator must be positive.
+static int32_t roundedDiv(int64_t numerator, int64_t denominator) {
+  if (numerator >= 0) {
+    return (int32_t)((numerator + denominator / 2) / denominator);
+  }
+  return -(int32_t)((-numerator + denominator / 2) / denominator);
+}
+
+L3G4200D_SampleClock::L3G4200D_SampleClock() { reset(10000); }
+
+void L3G4200D_SampleClock::reset(uint32_t nominalPeriodMicros) {
+  _nominalPeriod = nominalPeriodMicros;
+  _period = nominalPeriodMicros << PERIOD_SHIFT;
+  _nextIndex = 0;
+  _haveReference = false;
+  _points = 0;
+  _newestPoint = 0;
+}
+
+uint32_t L3G4200D_SampleClock::observe(uint32_t arrivalMicros,
+                                       uint32_t count) {
+  uint32_t first = _nextIndex;
+  if (count == 0) {
+    return first;
+  }
+
+  uint32_t last = first + count - 1;
+  _nextIndex += count;
+
+  // Points that are too close together say more about read jitter than about
+  // the data rate, so skip them.
+  if (_points > 0 &&
+      last - _pointIndex[_newestPoint] < L3G4200D_SAMPLE_CLOCK_SPACING) {
+    return first;
+  }
+
+  if (_points > 0) {
+    _newestPoint = (_newestPoint + 1) % L3G4200D_SAMPLE_CLOCK_POINTS;
+  }
+  if (_points < L3G4200D_SAMPLE_CLOCK_POINTS) {
+    _points++;
+  }
+  _pointIndex[_newestPoint] = last;
+  _pointMicros[_newestPoint] = arrivalMicros;
+
+  fit();
+
+  return first;
+}
+
+uint32_t L3G4200D_SampleClock::advance(uint32_t count) {
+  uint32_t first = _nextIndex;
+  _nextIndex += count;
+  return first;
+}
+
+void L3G4200D_SampleClock::fit() {
+  uint32_t newestIndex = _pointIndex[_newestPoint];
+  uint32_t newestMicros = _pointMicros[_newestPoint];
+
+  // Until there are two points, just count from the newest one at the
+  // nominal rate.
+  if (_points < 2) {
+    _referenceIndex = newestIndex;
+    _referenceMicros = newestMicros;
+    _haveReference = true;
+    return;
+  }
+
+  // Work relative to the newest point, so the numbers stay small (and
+  // wrapping of the index and micros() doesn't matter). The points are a few
+  // batches apart, so the sums are nowhere near overflowing.
+  int64_t sumX = 0;
+  int64_t sumY = 0;
+  int64_t sumXX = 0;
+  int64_t sumXY = 0;
+  for (uint8_t i = 0; i < _points; i++) {
+    int64_t x = (int32_t)(_pointIndex[i] - newestIndex);
+    int64_t y = (int32_t)(_pointMicros[i] - newestMicros);
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+  }
+
+  // The slope is the covariance over the variance, both of which are scaled
+  // up here by the number of points squared, which cancels out.
+  int64_t covariance = _points * sumXY - sumX * sumY;
+  int64_t variance = _points * sumXX - sumX * sumX;
+
+  // Work out the slope in 16.16 fixed point as its whole part plus the
+  // fraction from the remainder, so the covariance never needs shifting.
+  // Points so far apart that the remainder can't be shifted either (hours
+  // apart, at these data rates) leave the period as it was.
+  if (covariance > 0 && variance > 0 && variance < ((int64_t)1 << 47)) {
+    int64_t whole = covariance / variance;
+    if (whole < 2 * (int64_t)_nominalPeriod) {
+      int64_t slope = (whole << PERIOD_SHIFT) +
+                      ((covariance % variance) << PERIOD_SHIFT) / variance;
+      int64_t nominal = (int64_t)_nominalPeriod << PERIOD_SHIFT;
+      int64_t margin = nominal / MAX_PERIOD_ERROR_DIVISOR;
+      if (slope > nominal - margin && slope < nominal + margin) {
+        _period = (uint32_t)slope;
+      }
+    }
+  }
+
+  // The line goes through the mean of the points. Use where it crosses the
+  // newest point's index as the reference: the mean of y, less the period
+  // times the mean of x.
+  int64_t offset = (sumY << PERIOD_SHIFT) - (int64_t)_period * sumX;
+  _referenceIndex = newestIndex;
+  _referenceMicros =
+      newestMicros + roundedDiv(offset, (int64_t)_points << PERIOD_SHIFT);
+  _haveReference = true;
+}
+
+uint32_t L3G4200D_SampleClock::timestampMicros(uint32_t index) const {
+  if (!_haveReference) {
+    return 0;
+  }
+
+  int32_t offset = (int32_t)(index - _referenceIndex);
+  return _referenceMicros +
+         roundedDiv((int64_t)offset * _period, (int64_t)1 << PERIOD_SHIFT);
+}
+
+float L3G4200D_SampleClock::periodMicros() const {
+  return (float)_period / (1UL << PERIOD_SHIFT);
+}
+
+uint32_t L3G4200D_SampleClock::periodMicrosQ16() const { return _period; }
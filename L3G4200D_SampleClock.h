@@ -0,0 +1,124 @@
+/*!
+ * @file L3G4200D_SampleClock.h
+ *
+ * Reconstructs when each gyroscope sample was taken from its position in the
+ * stream of samples, so timestamps don't depend on when they happen to be
+ * read.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_SAMPLE_CLOCK_H
+#define L3G4200D_SAMPLE_CLOCK_H
+
+#include <stdint.h>
+
+/*! @brief The number of batch arrivals L3G4200D_SampleClock fits its line
+ * through. More points smooth out more jitter but follow changes more
+ * slowly. This changes the size of L3G4200D_Unified, so set it as a build
+ * flag. */
+#ifndef L3G4200D_SAMPLE_CLOCK_POINTS
+#define L3G4200D_SAMPLE_CLOCK_POINTS (8)
+#endif
+
+/*! @brief The fewest samples between two points L3G4200D_SampleClock fits
+ * its line through, so reading one sample at a time doesn't mean fitting a
+ * line for every sample. */
+#ifndef L3G4200D_SAMPLE_CLOCK_SPACING
+#define L3G4200D_SAMPLE_CLOCK_SPACING (16)
+#endif
+
+/*!
+ * @brief Works out the time each sample was taken at, from its index in the
+ * stream of samples, and the gyroscope's real output data rate as measured
+ * against `micros()`.
+ *
+ * The gyroscope's oscillator doesn't run at exactly the nominal data rate, so
+ * this fits a line (by least squares) through the times the last few
+ * batches of samples arrived at, against the index of the last sample in
+ * each batch. The slope is the real sample period, and the line gives every
+ * sample a timestamp without the jitter of when it happened to be read.
+ *
+ * It's all integer math, with the period kept in 16.16 fixed point, so
+ * timestamping doesn't pull floating point into L3G4200D_Unified's
+ * fixed-point read path.
+ *
+ * L3G4200D_Unified uses one of these for the timestamps of its events.
+ */
+class L3G4200D_SampleClock {
+
+public:
+  /*! @brief Create a new sample clock with no samples seen yet. */
+  L3G4200D_SampleClock();
+
+  /*! @brief Forgets every sample seen so far. Do this whenever samples may
+   * have been lost, or the data rate changes.
+   *
+   * @param nominalPeriodMicros The sample period the data rate is supposed to
+   * have, in microseconds.
+   */
+  void reset(uint32_t nominalPeriodMicros);
+
+  /*! @brief Records that a batch of samples has arrived.
+   *
+   * @param arrivalMicros The `micros()` time the newest sample in the batch
+   * was taken at, as well as it is known.
+   * @param count The number of samples in the batch.
+   *
+   * @returns The index of the oldest sample in the batch. The others follow
+   * it in order.
+   */
+  uint32_t observe(uint32_t arrivalMicros, uint32_t count);
+
+  /*! @brief Records that a batch of samples has arrived, when it isn't known
+   * when. They're timestamped by counting on from the others.
+   *
+   * @param count The number of samples in the batch.
+   *
+   * @returns The index of the oldest sample in the batch.
+   */
+  uint32_t advance(uint32_t count);
+
+  /*! @brief Returns the reconstructed `micros()` time of a sample.
+   * @param index The index of the sample, as returned by @ref observe.
+   * @returns The time the sample was taken at.
+   */
+  uint32_t timestampMicros(uint32_t index) const;
+
+  /*! @brief Returns the measured sample period.
+   * @returns The time between samples, in microseconds. This is the nominal
+   * period until enough batches have arrived to measure it.
+   */
+  float periodMicros() const;
+
+  /*! @brief Returns the measured sample period, without floating point.
+   * @returns The time between samples, in 1/65536ths of a microsecond.
+   */
+  uint32_t periodMicrosQ16() const;
+
+private:
+  uint32_t _nominalPeriod;
+
+  // The measured period, in 1/65536ths of a microsecond.
+  uint32_t _period;
+
+  // The index the next sample will be given.
+  uint32_t _nextIndex;
+
+  // A point on the fitted line, which timestampMicros() counts from.
+  bool _haveReference;
+  uint32_t _referenceIndex;
+  uint32_t _referenceMicros;
+
+  // The last few arrivals, as the index of the newest sample in each batch and
+  // its arrival time. _newestPoint is where the latest one is.
+  uint32_t _pointIndex[L3G4200D_SAMPLE_CLOCK_POINTS];
+  uint32_t _pointMicros[L3G4200D_SAMPLE_CLOCK_POINTS];
+  uint8_t _points;
+  uint8_t _newestPoint;
+
+  /*! @brief Fits the line through the stored points. */
+  void fit();
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "L3G4200D_Telemetry.h"
+
+L3G4200D_Telemetry::L3G4200D_Telemetry() {
+  _sequence = 0;
+  _dropped = 0;
+}
+
+bool L3G4200D_Telemetry::record(int32_t sensorId, uint32_t timestampMicros,
+                                const gyroSample_t &sample, uint8_t flags) {
+  frame_t frame;
+  uint8_t *bytes = frame.bytes;
+
+  // Lay the frame out byte by byte so it's the same on every board,
+  // regardless of endianness or struct padding.
+  bytes[0] = L3G4200D_TELEMETRY_SYNC;
+  bytes[1] = _sequence++;
+  bytes[2] = (uint8_t)sensorId;
+  bytes[3] = (uint8_t)(sensorId >> 8);
+  bytes[4] = (uint8_t)timestampMicros;
+  bytes[5] = (uint8_t)(timestampMicros >> 8);
+  bytes[6] = (uint8_t)(timestampMicros >> 16);
+  bytes[7] = (uint8_t)(timestampMicros >> 24);
+  bytes[8] = (uint8_t)sample.x;
+  bytes[9] = (uint8_t)(sample.x >> 8);
+  bytes[10] = (uint8_t)sample.y;
+  bytes[11] = (uint8_t)(sample.y >> 8);
+  bytes[12] = (uint8_t)sample.z;
+  bytes[13] = (uint8_t)(sample.z >> 8);
+  bytes[14] = flags;
+
+  uint8_t check = 0;
+  for (uint8_t i = 0; i < L3G4200D_TELEMETRY_FRAME_SIZE - 1; i++) {
+    check ^= bytes[i];
+  }
+  bytes[15] = check;
+
+  if (!_frames.push(frame)) {
+    _dropped++;
+    return false;
+  }
+
+  return true;
+}
+
+size_t L3G4200D_Telemetry::flush(Print &out, bool block) {
+  size_t written = 0;
+
+  while (!_frames.empty()) {
+    if (!block && out.availableForWrite() < L3G4200D_TELEMETRY_FRAME_SIZE) {
+      break;
+    }
+
+    frame_t frame;
+    _frames.pop(frame);
+    out.write(frame.bytes, L3G4200D_TELEMETRY_FRAME_SIZE);
+    written++;
+  }
+
+  return written;
+}
+
+uint32_t L3G4200D_Telemetry::dropped() const { return _dropped; }
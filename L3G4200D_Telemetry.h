@@ -0,0 +1,134 @@
+/*!
+ * @file L3G4200D_Telemetry.h
+ *
+ * A compact binary stream of L3G4200D samples, for logging every sample at
+ * full rate without blocking on the serial port.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TELEMETRY_H
+#define L3G4200D_TELEMETRY_H
+
+#include "L3G4200D_U.h"
+
+/*! @brief The number of frames buffered between L3G4200D_Unified and
+ * L3G4200D_Telemetry::flush. Must be a power of two no larger than 128.
+ * Like @ref L3G4200D_SAMPLE_RING_CAPACITY, set it as a build flag.
+ */
+#ifndef L3G4200D_TELEMETRY_CAPACITY
+#define L3G4200D_TELEMETRY_CAPACITY (16)
+#endif
+
+/*!
+ * @defgroup telemetry Telemetry
+ *
+ * @brief A binary alternative to L3G4200D_Unified::enableDebugLogging.
+ *
+ * Each sample is written as one 16-byte frame, with multi-byte values
+ * little-endian:
+ *
+ * | Byte  | Contents                                                  |
+ * | ----- | --------------------------------------------------------- |
+ * | 0     | @ref L3G4200D_TELEMETRY_SYNC                              |
+ * | 1     | Sequence number, counting up by 1 for each frame recorded |
+ * | 2-3   | The lower 16 bits of the sensor ID                        |
+ * | 4-7   | `micros()` timestamp of the sample                        |
+ * | 8-9   | Raw X-axis sample                                         |
+ * | 10-11 | Raw Y-axis sample                                         |
+ * | 12-13 | Raw Z-axis sample                                         |
+ * | 14    | Flags (see below)                                         |
+ * | 15    | XOR of bytes 0 through 14                                 |
+ *
+ * Gaps in the sequence number mean frames were dropped because
+ * L3G4200D_Telemetry::flush wasn't called often enough.
+ *
+ * `extras/decode_telemetry.py` decodes a captured stream.
+ *
+ * @{
+ */
+
+/*! @brief The size of one telemetry frame, in bytes. */
+#define L3G4200D_TELEMETRY_FRAME_SIZE (16)
+
+/*! @brief The first byte of every telemetry frame. */
+#define L3G4200D_TELEMETRY_SYNC (0xa5)
+
+/*! @brief Mask for the range bits of the flags byte. The range is the
+ * @ref gyro_range value of the sample shifted down to bits 1:0. */
+#define L3G4200D_TELEMETRY_FLAG_RANGE_MASK (0b11 << 0)
+
+/*! @brief Flags bit that is set if the sample was saturated. */
+#define L3G4200D_TELEMETRY_FLAG_SATURATED (0b1 << 2)
+
+/*!
+ * @brief Buffers telemetry frames from one or more L3G4200D_Unified
+ * gyroscopes and writes them out when there's room.
+ *
+ * @code{.cpp}
+ * L3G4200D_Unified gyro = L3G4200D_Unified(2113);
+ * L3G4200D_Telemetry telemetry;
+ *
+ * void setup() {
+ *   Serial.begin(921600);
+ *   gyro.begin(10);
+ *   gyro.setTelemetry(&telemetry);
+ * }
+ *
+ * void loop() {
+ *   sensors_event_t event;
+ *   gyro.getEvent(&event);
+ *   telemetry.flush(Serial);
+ * }
+ * @endcode
+ */
+class L3G4200D_Telemetry {
+
+public:
+  /*! @brief Create a new, empty telemetry buffer. */
+  L3G4200D_Telemetry();
+
+  /*! @brief Adds a frame for one sample. This is called for you by
+   * L3G4200D_Unified once it has been given this object with
+   * L3G4200D_Unified::setTelemetry.
+   *
+   * @param sensorId The ID of the sensor the sample is from.
+   * @param timestampMicros The `micros()` time of the sample.
+   * @param sample The raw sample.
+   * @param flags The flags byte of the frame.
+   *
+   * @returns True if the frame was added, false if the buffer was full and
+   * the frame was dropped.
+   */
+  bool record(int32_t sensorId, uint32_t timestampMicros,
+              const gyroSample_t &sample, uint8_t flags);
+
+  /*! @brief Writes out as many buffered frames as @p out can take without
+   * blocking, according to its `availableForWrite()`.
+   *
+   * @param out Where to write the frames, such as `Serial`.
+   * @param block Set to true to write every buffered frame, even if that has
+   * to wait. Use this for outputs that don't implement
+   * `availableForWrite()`.
+   *
+   * @returns The number of frames written.
+   */
+  size_t flush(Print &out, bool block = false);
+
+  /*! @brief Returns the number of frames that have been dropped because the
+   * buffer was full. */
+  uint32_t dropped() const;
+
+private:
+  typedef struct {
+    uint8_t bytes[L3G4200D_TELEMETRY_FRAME_SIZE];
+  } frame_t;
+
+  L3G4200D_RingBuffer<frame_t, L3G4200D_TELEMETRY_CAPACITY> _frames;
+  uint8_t _sequence;
+  uint32_t _dropped;
+};
+
+/*! @} */ // End group telemetry.
+
+#endif
@@ -0,0 +1,249 @@
+/*!
+ * @file L3G4200D_Transport.h
+ *
+ * Transport policies for the compile-time configured L3G4200D driver: how
+ * register reads and writes get to the gyroscope. See L3G4200D_I2C.h for I2C.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TRANSPORT_H
+#define L3G4200D_TRANSPORT_H
+
+#include "L3G4200D_U.h"
+
+/*!
+ * @ingroup sensor
+ * @{
+ */
+
+/*!
+ * @brief Bus traffic counted by a transport when @ref L3G4200D_STATS is
+ * enabled.
+ */
+typedef struct {
+  /*! The number of register reads and writes, each of which is one SPI
+   * transaction or one I2C transfer. */
+  uint32_t transactions;
+
+  /*! The number of bytes sent or received, including command bytes and I2C
+   * address bytes. */
+  uint32_t bytes;
+} gyroTransportStats_t;
+
+/*!
+ * @brief The traffic counters every transport has. Transports inherit this,
+ * so it doesn't cost anything per call unless @ref L3G4200D_STATS is set.
+ */
+class L3G4200D_TransportStats {
+
+public:
+  L3G4200D_TransportStats() { resetStats(); }
+
+  /*! @brief Gets the traffic counted since the transport was created or
+   * @ref resetStats was called. Always 0 unless @ref L3G4200D_STATS is set.
+   * @returns The traffic counters.
+   */
+  const gyroTransportStats_t &stats() const { return _stats; }
+
+  /*! @brief Sets every counter back to 0. */
+  void resetStats() { memset(&_stats, 0, sizeof(_stats)); }
+
+protected:
+  /*! @brief Counts one transaction of @p bytes bytes. */
+  void countTransaction(size_t bytes) {
+#if L3G4200D_STATS
+    _stats.transactions++;
+    _stats.bytes += bytes;
+#else
+    (void)bytes;
+#endif
+  }
+
+private:
+  gyroTransportStats_t _stats;
+};
+
+/*!
+ * @brief Talks to the gyroscope over a hardware SPI peripheral. This is the
+ * default transport for L3G4200D.
+ *
+ * @tparam Frequency The SPI clock frequency. Must be lower than 10 MHz, per
+ * the L3G4200D datasheet.
+ */
+template <uint32_t Frequency = 5L * 1000L * 1000L>
+class L3G4200D_HardwareSPI : public L3G4200D_TransportStats {
+
+public:
+  /*! @brief Sets up the Chip Select pin and the SPI peripheral.
+   *
+   * @param spiChipSelect The pin number on your board that you have connected
+   * to the SPI CS (Chip Select) pin on the L3G4200D.
+   * @param spi The SPI interface to use. Defaults to `SPI`.
+   *
+   * @returns True.
+   */
+  bool begin(int spiChipSelect, SPIClass &spi = SPI) {
+    _spiCS = spiChipSelect;
+    pinMode(_spiCS, OUTPUT);
+    digitalWrite(_spiCS, HIGH);
+
+    _spi = &spi;
+    _spi->begin();
+
+    return true;
+  }
+
+  /*! @brief Reads @p count consecutive registers in one transaction. See
+   * L3G4200D_Unified::rawReadRegs. */
+  void readRegs(uint8_t startAddress, uint8_t *buf, size_t count) {
+    uint8_t readCmd = startAddress | 0x80 | (count > 1 ? 0x40 : 0);
+
+    _spi->beginTransaction(SPISettings(Frequency, MSBFIRST, SPI_MODE3));
+    digitalWrite(_spiCS, LOW);
+
+    // The response to the command byte is garbage, so send it and clock out
+    // the registers in one buffer transfer when they fit in our frame.
+    if (count <= FRAME_DATA_MAX) {
+      uint8_t frame[1 + FRAME_DATA_MAX];
+      memset(frame, 0, sizeof(frame));
+      frame[0] = readCmd;
+      _spi->transfer(frame, 1 + count);
+      memcpy(buf, &frame[1], count);
+    } else {
+      _spi->transfer(readCmd);
+      memset(buf, 0, count);
+      _spi->transfer(buf, count);
+    }
+
+    digitalWrite(_spiCS, HIGH);
+    _spi->endTransaction();
+
+    countTransaction(1 + count);
+  }
+
+  /*! @brief Writes @p count consecutive registers in one transaction. */
+  void writeRegs(uint8_t startAddress, const uint8_t *values, size_t count) {
+    uint8_t writeCmd = startAddress | (count > 1 ? 0x40 : 0);
+
+    _spi->beginTransaction(SPISettings(Frequency, MSBFIRST, SPI_MODE3));
+    digitalWrite(_spiCS, LOW);
+
+    // transfer() overwrites its buffer, so copy the values into our frame
+    // when they fit, and otherwise send them a byte at a time.
+    if (count <= FRAME_DATA_MAX) {
+      uint8_t frame[1 + FRAME_DATA_MAX];
+      frame[0] = writeCmd;
+      memcpy(&frame[1], values, count);
+      _spi->transfer(frame, 1 + count);
+    } else {
+      _spi->transfer(writeCmd);
+      for (size_t i = 0; i < count; i++) {
+        _spi->transfer(values[i]);
+      }
+    }
+
+    digitalWrite(_spiCS, HIGH);
+    _spi->endTransaction();
+
+    countTransaction(1 + count);
+  }
+
+private:
+  // Enough for the status register and every axis, or all five control
+  // registers.
+  static const size_t FRAME_DATA_MAX = 8;
+
+  SPIClass *_spi;
+  int _spiCS;
+};
+
+/*!
+ * @brief Talks to the gyroscope by bit-banging SPI (mode 3, MSB first) on any
+ * four GPIO pins, for when the hardware SPI peripheral is taken or its pins
+ * are in use.
+ *
+ * This is much slower than L3G4200D_HardwareSPI, since every bit is a few
+ * `digitalWrite()` calls, but a 7-byte burst is still fast enough for 400 Hz
+ * on most boards.
+ */
+class L3G4200D_SoftwareSPI : public L3G4200D_TransportStats {
+
+public:
+  /*! @brief Sets up the four SPI pins.
+   *
+   * @param spiChipSelect The pin connected to the L3G4200D's CS pin.
+   * @param sck The pin connected to the L3G4200D's SCL/SPC pin.
+   * @param copi The pin connected to the L3G4200D's SDA/SDI pin.
+   * @param cipo The pin connected to the L3G4200D's SDO pin.
+   *
+   * @returns True.
+   */
+  bool begin(int spiChipSelect, int sck, int copi, int cipo) {
+    _spiCS = spiChipSelect;
+    _sck = sck;
+    _copi = copi;
+    _cipo = cipo;
+
+    pinMode(_spiCS, OUTPUT);
+    digitalWrite(_spiCS, HIGH);
+
+    // Mode 3 idles with the clock high.
+    pinMode(_sck, OUTPUT);
+    digitalWrite(_sck, HIGH);
+    pinMode(_copi, OUTPUT);
+    pinMode(_cipo, INPUT);
+
+    return true;
+  }
+
+  /*! @brief Reads @p count consecutive registers in one transaction. See
+   * L3G4200D_Unified::rawReadRegs. */
+  void readRegs(uint8_t startAddress, uint8_t *buf, size_t count) {
+    digitalWrite(_spiCS, LOW);
+    transfer(startAddress | 0x80 | (count > 1 ? 0x40 : 0));
+    for (size_t i = 0; i < count; i++) {
+      buf[i] = transfer(0);
+    }
+    digitalWrite(_spiCS, HIGH);
+
+    countTransaction(1 + count);
+  }
+
+  /*! @brief Writes @p count consecutive registers in one transaction. */
+  void writeRegs(uint8_t startAddress, const uint8_t *values, size_t count) {
+    digitalWrite(_spiCS, LOW);
+    transfer(startAddress | (count > 1 ? 0x40 : 0));
+    for (size_t i = 0; i < count; i++) {
+      transfer(values[i]);
+    }
+    digitalWrite(_spiCS, HIGH);
+
+    countTransaction(1 + count);
+  }
+
+private:
+  int _spiCS;
+  int _sck;
+  int _copi;
+  int _cipo;
+
+  // Shifts one byte out and one byte in. In mode 3, the gyroscope changes its
+  // output on the falling edge and samples ours on the rising edge.
+  uint8_t transfer(uint8_t out) {
+    uint8_t in = 0;
+    for (uint8_t bit = 0x80; bit != 0; bit >>= 1) {
+      digitalWrite(_sck, LOW);
+      digitalWrite(_copi, (out & bit) ? HIGH : LOW);
+      digitalWrite(_sck, HIGH);
+      if (digitalRead(_cipo)) {
+        in |= bit;
+      }
+    }
+    return in;
+  }
+};
+
+/*! @} */ // End group sensor.
+
+#endif
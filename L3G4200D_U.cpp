@@ -1,7 +1,33 @@
 #include "L3G4200D_U.h"
+#include "L3G4200D_Telemetry.h"
+
+// Adds to one of the counters in _stats, or does nothing at all if stats were
+// compiled out.
+#if L3G4200D_STATS
+#define STATS_ADD(counter, amount) (_stats.counter += (amount))
+#else
+#define STATS_ADD(counter, amount) ((void)0)
+#endif
+
+// The bias is kept with this many fraction bits, so the online estimator can
+// move it by less than a count at a time.
+#define BIAS_FRACTION_BITS (8)
+
+// Returns the largest absolute value of the three. Arduino cores disagree on
+// what abs() and max() do with 32-bit values, so don't use them here.
+static int32_t largestMagnitude(int32_t x, int32_t y, int32_t z) {
+  int32_t largest = labs(x);
+  if (labs(y) > largest) {
+    largest = labs(y);
+  }
+  if (labs(z) > largest) {
+    largest = labs(z);
+  }
+  return largest;
+}
 
 void L3G4200D_Unified::debugLog(const char str[]) {
-  if (_debugLoggingEnabled) {
+  if (L3G4200D_DEBUG_LOGGING && _debugLoggingEnabled) {
     Serial.print("[");
     Serial.print(_sensorId);
     Serial.print("]: ");
@@ -10,7 +36,7 @@ void L3G4200D_Unified::debugLog(const char str[]) {
 }
 
 void L3G4200D_Unified::debugLog(int val) {
-  if (_debugLoggingEnabled) {
+  if (L3G4200D_DEBUG_LOGGING && _debugLoggingEnabled) {
     Serial.print("[");
     Serial.print(_sensorId);
     Serial.print("]: ");
@@ -19,21 +45,55 @@ void L3G4200D_Unified::debugLog(int val) {
 }
 
 void L3G4200D_Unified::debugAppend(const char str[]) {
-  if (_debugLoggingEnabled) {
+  if (L3G4200D_DEBUG_LOGGING && _debugLoggingEnabled) {
     Serial.print(str);
   }
 }
 
 void L3G4200D_Unified::debugAppend(int val) {
-  if (_debugLoggingEnabled) {
+  if (L3G4200D_DEBUG_LOGGING && _debugLoggingEnabled) {
     Serial.print(val);
   }
 }
 
+void L3G4200D_Unified::debugLogSample(const gyroSample_t &sample) {
+  debugLog("Raw X, Y, Z samples: ");
+  debugAppend(sample.x);
+  debugAppend(", ");
+  debugAppend(sample.y);
+  debugAppend(", ");
+  debugAppend(sample.z);
+  debugAppend("\n");
+}
+
 L3G4200D_Unified::L3G4200D_Unified(int32_t sensorId) {
   _sensorId = sensorId;
   _autoRangeEnabled = false;
+  _lastSampleSaturated = false;
+  _lastStatus = 0;
   _debugLoggingEnabled = false;
+  _fifoEnabled = false;
+  _fifoCtrl = FIFO_CTRL_MODE_BYPASS;
+  _interruptCaptureEnabled = false;
+  _interruptNumber = -1;
+  _busDepth = 0;
+  _interruptPending = false;
+  _interruptMicros = 0;
+  _capturedMicros = 0;
+  _asyncReadBusy = false;
+  _asyncTransferOpen = false;
+  _settlingSamples = 0;
+  _heldSampleSettling = false;
+  _lastTimestampMicros = 0;
+  _samplesLost = false;
+  _onlineCalibrationEnabled = false;
+  _stillSamples = 0;
+  clearCalibration();
+  _awakeAxes = CTRL1_XYZ;
+  _dutyCycleState = DUTY_CYCLE_OFF;
+  _telemetry = NULL;
+  memset(_ctrlShadow, 0, sizeof(_ctrlShadow));
+  resetStats();
 }
 
 bool L3G4200D_Unified::begin(int spiChipSelect, gyroRange_t range,
@@ -45,7 +105,28 @@ bool L3G4200D_Unified::begin(int spiChipSelect, gyroRange_t range,
   pinMode(_spiCS, OUTPUT);
   digitalWrite(_spiCS, HIGH);
 
+  // Calling begin() again starts from scratch, so forget everything the
+  // last one was set up to do, starting with the interrupt the old bus was
+  // told about.
+  _interruptCaptureEnabled = false;
+  _interruptPending = false;
+  _sampleRing.clear();
+  if (_interruptNumber >= 0) {
+#ifdef SPI_HAS_NOTUSINGINTERRUPT
+    _spi->notUsingInterrupt(_interruptNumber);
+#endif
+    _interruptNumber = -1;
+  }
+  _fifoEnabled = false;
+  _fifoCtrl = FIFO_CTRL_MODE_BYPASS;
+  _dutyCycleState = DUTY_CYCLE_OFF;
+  _awakeAxes = CTRL1_XYZ;
+  _settlingSamples = 0;
+  _heldSampleSettling = false;
+  _samplesLost = false;
+
   _range = range;
+  updateScaleFactors();
 
   // Store the SPI interface we're using...
   _spi = &spi;
@@ -58,9 +139,7 @@ bool L3G4200D_Unified::begin(int spiChipSelect, gyroRange_t range,
 
   // Check that the chip ID is what we expect: 0b11010011, or 0xd3 in hex, and
   // 211 in decimal.
-  beginTransaction();
   uint8_t chipId = spiReadReg(REG_WHO_AM_I);
-  endTransaction();
 
   if (chipId == 0) {
     debugLog("We tried to read the L3G4200 gyroscope chip ID, but got all "
@@ -83,19 +162,29 @@ bool L3G4200D_Unified::begin(int spiChipSelect, gyroRange_t range,
     return false;
   }
 
+  // CTRL_REG1 through CTRL_REG5 are next to each other, so write them all in
+  // one burst.
+  uint8_t ctrl[5];
+
   // Use a medium data rate and cutoff for the user, power on the gyroscope,
-  // and enable all three axes.
-  spiWriteReg(REG_CTRL_1, CTRL1_RATE_400HZ_CUTOFF_25HZ | CTRL1_XYZ);
+  // and enable all three axes. These can be changed afterwards with
+  // setDataRate() and setEnabledAxes().
+  ctrl[0] = L3G4200D_DEFAULT_CTRL1;
+
+  ctrl[1] = L3G4200D_DEFAULT_CTRL2;
 
-  spiWriteReg(REG_CTRL_3, CTRL3_DRIVE_HIGH_AND_LOW);
+  ctrl[2] = L3G4200D_DEFAULT_CTRL3;
 
   // Ask the gyroscope not to update the high byte and low byte of a sample
   // between reads, use the low byte at the lower address (as is the default),
   // and use the gyroscope range the user asked for.
-  spiWriteReg(REG_CTRL_4, CTRL4_UPDATE_MSB_AND_LSB_TOGETHER |
-                              CTRL4_LSB_AT_LOWER_ADDRESS | range);
+  ctrl[3] = L3G4200D_DEFAULT_CTRL4 | range;
 
-  spiWriteReg(REG_CTRL_5, CTRL5_NO_FILTERING);
+  ctrl[4] = L3G4200D_DEFAULT_CTRL5;
+
+  spiWriteRegs(REG_CTRL_1, ctrl, sizeof(ctrl));
+  memcpy(_ctrlShadow, ctrl, sizeof(ctrl));
+  _sampleClock.reset(samplePeriodMicros());
 
   return true;
 }
@@ -109,55 +198,394 @@ void L3G4200D_Unified::enableDebugLogging(bool enabled) {
 }
 
 bool L3G4200D_Unified::getEvent(sensors_event_t *event) {
+  return readEvent(event, false);
+}
 
-  rawGyroSample sample = rawXYZ();
+bool L3G4200D_Unified::getEventIfNew(sensors_event_t *event) {
+  return readEvent(event, true);
+}
 
-  // If we're supposed to be automatically changing the range, check if we're
-  // saturating the sensor at the current range.
-  if (_autoRangeEnabled) {
+bool L3G4200D_Unified::readEvent(sensors_event_t *event, bool onlyIfNew) {
 
-    // Give it a little bit of lee-way, in case it doesn't hit exactly 32767.
-    const int16_t SATURATED_SAMPLE_VALUE = INT16_MAX - 10;
-    if (abs(sample.x) >= SATURATED_SAMPLE_VALUE ||
-        abs(sample.y) >= SATURATED_SAMPLE_VALUE ||
-        abs(sample.z) >= SATURATED_SAMPLE_VALUE) {
-
-      // Bump the range if we can, and re-read the sample.
-      switch (_range) {
-      // Intentional fallthrough.
-      default:
-      case GYRO_RANGE_4_DOT_36_RAD_PER_SEC:
-        setRange(GYRO_RANGE_8_DOT_73_RAD_PER_SEC);
-        sample = rawXYZ();
-        break;
-
-      case GYRO_RANGE_8_DOT_73_RAD_PER_SEC:
-        setRange(GYRO_RANGE_34_DOT_91_RAD_PER_SEC);
-        sample = rawXYZ();
-        break;
-
-      case GYRO_RANGE_34_DOT_91_RAD_PER_SEC:
-        // We're already at maximum range; nothing to do here.
-        break;
-      }
-    }
+#if L3G4200D_STATS
+  uint32_t startMicros = micros();
+#endif
+
+  rawGyroSample sample;
+  if (!nextSample(sample, onlyIfNew)) {
+    return false;
   }
 
-  debugLog("Raw X, Y, Z samples: ");
-  debugAppend(sample.x);
-  debugAppend(", ");
-  debugAppend(sample.y);
-  debugAppend(", ");
-  debugAppend(sample.z);
-  debugAppend("\n");
+  // Check once here instead of in every debugAppend() call, so the usual case
+  // is just the read and three multiplies.
+  if (L3G4200D_DEBUG_LOGGING && _debugLoggingEnabled) {
+    debugLogSample(sample);
+  }
 
   event->gyro.x = sampleToRad(sample.x);
   event->gyro.y = sampleToRad(sample.y);
   event->gyro.z = sampleToRad(sample.z);
+  event->timestamp = eventTimestamp(_lastTimestampMicros, millis(), micros());
+
+  // Only change the range after converting, since this sample was taken at
+  // the old range.
+  if (_autoRangeEnabled) {
+    autoRange(sample);
+  }
+
+#if L3G4200D_STATS
+  recordLatency(micros() - startMicros);
+#endif
+
+  return true;
+}
+
+bool L3G4200D_Unified::getEventFixed(gyroFixedEvent_t *event) {
+  return readFixedEvent(event, false);
+}
+
+bool L3G4200D_Unified::getEventMilliRad(gyroFixedEvent_t *event) {
+  return readFixedEvent(event, true);
+}
+
+bool L3G4200D_Unified::readFixedEvent(gyroFixedEvent_t *event,
+                                      bool milliRad) {
+
+  rawGyroSample sample;
+  if (!nextSample(sample)) {
+    return false;
+  }
+
+  int32_t scale = milliRad ? _milliRadScale : _fixedScale;
+  uint8_t shift = milliRad ? L3G4200D_MILLIRAD_SHIFT : L3G4200D_FIXED_SHIFT;
+  event->x = sampleToFixed(sample.x, scale, shift);
+  event->y = sampleToFixed(sample.y, scale, shift);
+  event->z = sampleToFixed(sample.z, scale, shift);
+
+  if (_autoRangeEnabled) {
+    autoRange(sample);
+  }
+
+  return true;
+}
+
+bool L3G4200D_Unified::nextSample(gyroSample_t &sample, bool onlyIfNew) {
+
+  if (_interruptCaptureEnabled) {
+    // The interrupt handler has already read the sensor for us.
+    if (!popCaptured(sample)) {
+      return false;
+    }
+  } else {
+    sample = rawXYZ();
+
+    // Reading faster than the output data rate gets the same sample again,
+    // and reading slower loses samples.
+    if (!(_lastStatus & STATUS_XYZ_NEW_DATA)) {
+      STATS_ADD(staleSamples, 1);
+      if (onlyIfNew) {
+        return false;
+      }
+    } else if (_lastStatus & STATUS_XYZ_OVERRUN) {
+      STATS_ADD(sampleOverruns, 1);
+
+      // We don't know how many samples we missed, so start counting again.
+      _sampleClock.reset(samplePeriodMicros());
+    }
+  }
+
+  bool fresh = _interruptCaptureEnabled || (_lastStatus & STATUS_XYZ_NEW_DATA);
+
+  if (isSettlingSample(fresh)) {
+    return false;
+  }
+
+  finishSamples(&sample, 1, fresh);
+  return true;
+}
 
+bool L3G4200D_Unified::nextAxesSample(gyroSample_t &sample, uint8_t firstAxis,
+                                      uint8_t lastAxis) {
+  if (_settlingSamples > 0 || _heldSampleSettling) {
+    // Only new samples count towards settling, and telling them apart takes
+    // STATUS_REG, so read all of it until the first good one.
+    bool fresh;
+    if (_interruptCaptureEnabled) {
+      fresh = popCaptured(sample);
+    } else {
+      sample = rawXYZ();
+      fresh = _lastStatus & STATUS_XYZ_NEW_DATA;
+    }
+    if (!fresh || isSettlingSample(true)) {
+      return false;
+    }
+  } else if (_interruptCaptureEnabled) {
+    if (!popCaptured(sample)) {
+      return false;
+    }
+  } else {
+    sample = rawAxes(firstAxis, lastAxis);
+  }
+
+  // Without STATUS_REG we can't tell new samples from ones we've already
+  // read, so direct reads are just stamped with the time they were read at.
+  if (_interruptCaptureEnabled) {
+    _lastTimestampMicros = _sampleClock.timestampMicros(stampSamples(1));
+  } else {
+    _lastTimestampMicros = micros();
+  }
+
+  finishSample(sample);
+  correctBias(sample, false, firstAxis, lastAxis);
   return true;
 }
 
+void L3G4200D_Unified::finishSample(const gyroSample_t &sample) {
+  _lastSampleSaturated = isSaturated(sample);
+  if (_lastSampleSaturated) {
+    STATS_ADD(saturatedSamples, 1);
+  }
+
+  if (_telemetry != NULL) {
+    recordTelemetry(sample, _lastTimestampMicros);
+  }
+}
+
+uint32_t L3G4200D_Unified::finishSamples(gyroSample_t *samples, size_t count,
+                                         bool fresh) {
+  // A sample we've already read keeps the timestamp it had.
+  uint32_t first = fresh ? stampSamples(count) : 0;
+
+  bool saturated = false;
+  for (size_t i = 0; i < count; i++) {
+    if (fresh) {
+      _lastTimestampMicros = _sampleClock.timestampMicros(first + i);
+    }
+
+    finishSample(samples[i]);
+    saturated |= _lastSampleSaturated;
+    correctBias(samples[i], true);
+  }
+  _lastSampleSaturated = saturated;
+
+  return first;
+}
+
+uint32_t L3G4200D_Unified::stampSamples(size_t count) {
+  if (_samplesLost) {
+    _samplesLost = false;
+    _sampleClock.reset(samplePeriodMicros());
+  }
+
+  // Samples from the capture buffer arrived when their interrupt came in,
+  // however long they waited there.
+  uint32_t arrivalMicros =
+      _interruptCaptureEnabled ? _capturedMicros : micros();
+  return _sampleClock.observe(arrivalMicros, count);
+}
+
+int32_t L3G4200D_Unified::eventTimestamp(uint32_t timestampMicros,
+                                         uint32_t nowMillis,
+                                         uint32_t nowMicros) {
+  // Events are timestamped in milliseconds, so count back from millis()
+  // rather than dividing micros(), which wraps much sooner. The fitted time
+  // can be a little after now, so the difference is signed.
+  return nowMillis - (int32_t)(nowMicros - timestampMicros) / 1000;
+}
+
+uint32_t L3G4200D_Unified::lastTimestampMicros() {
+  return _lastTimestampMicros;
+}
+
+float L3G4200D_Unified::measuredSamplePeriod() {
+  return _sampleClock.periodMicros();
+}
+
+bool L3G4200D_Unified::lastSampleSaturated() { return _lastSampleSaturated; }
+
+bool L3G4200D_Unified::lastSampleNew() {
+  return _lastStatus & STATUS_XYZ_NEW_DATA;
+}
+
+bool L3G4200D_Unified::lastSampleOverrun() {
+  return _lastStatus & STATUS_XYZ_OVERRUN;
+}
+
+void L3G4200D_Unified::setTelemetry(L3G4200D_Telemetry *telemetry) {
+  _telemetry = telemetry;
+}
+
+void L3G4200D_Unified::recordTelemetry(const gyroSample_t &sample,
+                                       uint32_t timestampMicros) {
+  uint8_t flags = (_range >> 4) & L3G4200D_TELEMETRY_FLAG_RANGE_MASK;
+  if (isSaturated(sample)) {
+    flags |= L3G4200D_TELEMETRY_FLAG_SATURATED;
+  }
+
+  _telemetry->record(_sensorId, timestampMicros, sample, flags);
+}
+
+void L3G4200D_Unified::getStats(gyroStats_t *stats) {
+  memcpy(stats, &_stats, sizeof(gyroStats_t));
+}
+
+void L3G4200D_Unified::resetStats() {
+  memset(&_stats, 0, sizeof(gyroStats_t));
+}
+
+void L3G4200D_Unified::recordLatency(uint32_t durationMicros) {
+  // Bucket 0 is under 32 us, and each bucket after that is twice as wide as
+  // the one before it. The last bucket takes everything else.
+  uint8_t bucket = 0;
+  uint32_t limit = 32;
+  while (bucket < L3G4200D_STATS_LATENCY_BUCKETS - 1 &&
+         durationMicros >= limit) {
+    bucket++;
+    limit <<= 1;
+  }
+
+  _stats.latencyHistogram[bucket]++;
+}
+
+bool L3G4200D_Unified::isSaturated(const gyroSample_t &sample) {
+  // Give it a little bit of lee-way, in case it doesn't hit exactly 32767.
+  // abs() of INT16_MIN doesn't fit in an int16_t, so compare against both
+  // ends explicitly.
+  const int16_t SATURATED_SAMPLE_VALUE = INT16_MAX - 10;
+  return sample.x >= SATURATED_SAMPLE_VALUE ||
+         sample.x <= -SATURATED_SAMPLE_VALUE ||
+         sample.y >= SATURATED_SAMPLE_VALUE ||
+         sample.y <= -SATURATED_SAMPLE_VALUE ||
+         sample.z >= SATURATED_SAMPLE_VALUE ||
+         sample.z <= -SATURATED_SAMPLE_VALUE;
+}
+
+size_t L3G4200D_Unified::axisBurstLength() {
+  // STATUS_REG, then two bytes for each axis up to the last enabled one.
+  uint8_t ctrl1 = _ctrlShadow[REG_CTRL_1 - REG_CTRL_1];
+  if (ctrl1 & CTRL1_Z_ENABLE) {
+    return 7;
+  } else if (ctrl1 & CTRL1_Y_ENABLE) {
+    return 5;
+  } else if (ctrl1 & CTRL1_X_ENABLE) {
+    return 3;
+  }
+  return 1;
+}
+
+uint32_t L3G4200D_Unified::samplePeriodMicros() {
+  // Bits 7:6 of CTRL_REG1 pick 100, 200, 400, or 800 Hz.
+  uint8_t rate = (_ctrlShadow[REG_CTRL_1 - REG_CTRL_1] >> 6) & 0b11;
+  return 10000UL >> rate;
+}
+
+void L3G4200D_Unified::autoRange(const gyroSample_t &sample) {
+  gyroRange_t range =
+      _autoRangeState.update(sample, _range, _lastSampleSaturated);
+
+  if (range != _range) {
+    setRange(range);
+    STATS_ADD(rangeSwitches, 1);
+  }
+}
+
+L3G4200D_AutoRange::L3G4200D_AutoRange() { reset(); }
+
+void L3G4200D_AutoRange::reset() {
+  _havePrevious = false;
+  _quietSamples = 0;
+}
+
+gyroRange_t L3G4200D_AutoRange::update(const gyroSample_t &sample,
+                                       gyroRange_t range, bool saturated) {
+
+  int32_t x = sample.x;
+  int32_t y = sample.y;
+  int32_t z = sample.z;
+
+  int32_t peak = largestMagnitude(x, y, z);
+
+  // Guess where each axis will be on the next sample by assuming it keeps
+  // changing at the same rate, so we can switch up before we saturate rather
+  // than after.
+  int32_t predicted = peak;
+  if (_havePrevious) {
+    int32_t next = largestMagnitude(2 * x - _previous.x, 2 * y - _previous.y,
+                                    2 * z - _previous.z);
+    if (next > predicted) {
+      predicted = next;
+    }
+  }
+
+  _previous = sample;
+  _havePrevious = true;
+
+  if (saturated || predicted >= L3G4200D_AUTO_RANGE_UP_THRESHOLD) {
+    _quietSamples = 0;
+
+    gyroRange_t higherRange;
+    switch (range) {
+    // Intentional fallthrough.
+    default:
+    case GYRO_RANGE_4_DOT_36_RAD_PER_SEC:
+      higherRange = GYRO_RANGE_8_DOT_73_RAD_PER_SEC;
+      break;
+
+    case GYRO_RANGE_8_DOT_73_RAD_PER_SEC:
+      higherRange = GYRO_RANGE_34_DOT_91_RAD_PER_SEC;
+      break;
+
+    case GYRO_RANGE_34_DOT_91_RAD_PER_SEC:
+      // We're already at maximum range; nothing to do here.
+      return range;
+    }
+
+    // The previous sample was at the old range, so it's no use for guessing
+    // anymore.
+    _havePrevious = false;
+    return higherRange;
+  }
+
+  // To come back down, the motion has to fit comfortably in the lower range
+  // (well under the threshold for switching back up) for a while. The lower
+  // ranges are about 1/2 and 1/4 of the ones above them, so scale the
+  // threshold into this range's counts with a shift.
+  gyroRange_t lowerRange;
+  int32_t quietThreshold;
+  switch (range) {
+  // Intentional fallthrough.
+  default:
+  case GYRO_RANGE_4_DOT_36_RAD_PER_SEC:
+    // We're already at minimum range; nothing to do here.
+    _quietSamples = 0;
+    return range;
+
+  case GYRO_RANGE_8_DOT_73_RAD_PER_SEC:
+    lowerRange = GYRO_RANGE_4_DOT_36_RAD_PER_SEC;
+    quietThreshold = L3G4200D_AUTO_RANGE_DOWN_THRESHOLD >> 1;
+    break;
+
+  case GYRO_RANGE_34_DOT_91_RAD_PER_SEC:
+    lowerRange = GYRO_RANGE_8_DOT_73_RAD_PER_SEC;
+    quietThreshold = L3G4200D_AUTO_RANGE_DOWN_THRESHOLD >> 2;
+    break;
+  }
+
+  if (predicted >= quietThreshold) {
+    _quietSamples = 0;
+    return range;
+  }
+
+  _quietSamples++;
+  if (_quietSamples >= L3G4200D_AUTO_RANGE_DOWN_HOLD) {
+    _quietSamples = 0;
+    _havePrevious = false;
+    return lowerRange;
+  }
+
+  return range;
+}
+
 void L3G4200D_Unified::getSensor(sensor_t *sensor) {
   // Clear out the sensor data.
   memset(sensor, 0, sizeof(sensor_t));
@@ -177,154 +605,1285 @@ void L3G4200D_Unified::getSensor(sensor_t *sensor) {
   // This value is also using the minimum range this gyroscope supports,
   // because the minimum range is what gives the maximum resolution.
   sensor->resolution = 4.36f / UINT16_MAX;
-  sensor->min_delay = 0;
+
+  // There's a new sample once per output data period, so reading any more
+  // often than that just gets the same sample again.
+  sensor->min_delay = samplePeriodMicros();
 }
 
 void L3G4200D_Unified::setRange(gyroRange_t range) {
+  bool changed = range != _range;
+
   _range = range;
-  spiWriteReg(REG_CTRL_4, CTRL4_UPDATE_MSB_AND_LSB_TOGETHER |
-                              CTRL4_LSB_AT_LOWER_ADDRESS | range);
+  updateScaleFactors();
+  updateCtrlReg(REG_CTRL_4, CTRL4_FULL_SCALE_MASK, range);
+
+  // Anything queued was taken at the old range, and would be scaled wrongly
+  // at the new one.
+  if (changed) {
+    discardQueuedSamples();
+  }
 }
 
-float L3G4200D_Unified::rangeInRadians() {
-  // Divided by 2 because we have both negative and positive values.
-  switch (_range) {
+void L3G4200D_Unified::setDataRate(gyroDataRate_t rate,
+                                   gyroBandwidth_t bandwidth) {
+  updateCtrlReg(REG_CTRL_1, CTRL1_RATE_CUTOFF_MASK,
+                (rate & CTRL1_RATE_MASK) | resolveBandwidth(rate, bandwidth));
+}
+
+uint8_t L3G4200D_Unified::resolveBandwidth(gyroDataRate_t rate,
+                                           gyroBandwidth_t bandwidth) {
+  if (bandwidth != GYRO_BANDWIDTH_AUTO) {
+    return bandwidth & CTRL1_CUTOFF_MASK;
+  }
+
+  // The highest cutoff no more than a quarter of the data rate. See the
+  // table in gyroBandwidth_t.
+  switch (rate) {
   // Intentional fallthrough.
   default:
-  case GYRO_RANGE_4_DOT_36_RAD_PER_SEC:
-    return 4.36f / 2;
+  case GYRO_DATA_RATE_100HZ:
+    return GYRO_BANDWIDTH_NARROW; // 25 Hz
 
-  case GYRO_RANGE_8_DOT_73_RAD_PER_SEC:
-    return 8.73f / 2;
+  case GYRO_DATA_RATE_200HZ:
+    return GYRO_BANDWIDTH_WIDE; // 50 Hz
 
-  case GYRO_RANGE_34_DOT_91_RAD_PER_SEC:
-    return 34.91f / 2;
-  }
-}
+  case GYRO_DATA_RATE_400HZ:
+    return GYRO_BANDWIDTH_WIDE; // 50 Hz
 
-uint8_t L3G4200D_Unified::rawReadReg(uint8_t regAddress) {
-  return spiReadReg(regAddress);
+  case GYRO_DATA_RATE_800HZ:
+    return GYRO_BANDWIDTH_WIDEST; // 110 Hz
+  }
 }
 
-void L3G4200D_Unified::rawWriteReg(uint8_t regAddress, uint8_t newValue) {
-  spiWriteReg(regAddress, newValue);
+void L3G4200D_Unified::getConfig(gyroConfig_t *config) {
+  uint8_t ctrl1 = _ctrlShadow[REG_CTRL_1 - REG_CTRL_1];
+  uint8_t ctrl4 = _ctrlShadow[REG_CTRL_4 - REG_CTRL_1];
+
+  config->range = _range;
+  config->dataRate = (gyroDataRate_t)(ctrl1 & CTRL1_RATE_MASK);
+  config->bandwidth = (gyroBandwidth_t)(ctrl1 & CTRL1_CUTOFF_MASK);
+  config->axes = (gyroAxes_t)(ctrl1 & CTRL1_POWER_AXES_MASK);
+  config->highPassMode = (gyroHighPassMode_t)(
+      _ctrlShadow[REG_CTRL_2 - REG_CTRL_1] & CTRL2_HIGH_PASS_MODE_MASK);
+  config->highPassDivisor =
+      _ctrlShadow[REG_CTRL_2 - REG_CTRL_1] & CTRL2_HIGH_PASS_DIV_MASK;
+  config->filtering =
+      _ctrlShadow[REG_CTRL_5 - REG_CTRL_1] & CTRL5_FILTERING_MASK;
+  config->blockDataUpdate = ctrl4 & CTRL4_BLOCK_DATA_UPDATE_MASK;
 }
 
-int16_t L3G4200D_Unified::rawX() {
-  uint8_t xLow = spiReadReg(REG_OUT_X_L);
-  uint8_t xHigh = spiReadReg(REG_OUT_X_H);
-  return (int16_t)((xHigh << 8) | xLow);
-}
+void L3G4200D_Unified::reconfigure(const gyroConfig_t &config) {
+  // Work out what all five control registers should be, keeping any bits the
+  // config doesn't cover.
+  uint8_t ctrl[5];
+  memcpy(ctrl, _ctrlShadow, sizeof(ctrl));
+
+  ctrl[REG_CTRL_1 - REG_CTRL_1] =
+      (config.dataRate & CTRL1_RATE_MASK) |
+      resolveBandwidth(config.dataRate, config.bandwidth) |
+      (config.axes & CTRL1_POWER_AXES_MASK);
+
+  ctrl[REG_CTRL_2 - REG_CTRL_1] =
+      (ctrl[REG_CTRL_2 - REG_CTRL_1] &
+       ~(CTRL2_HIGH_PASS_MODE_MASK | CTRL2_HIGH_PASS_DIV_MASK)) |
+      (config.highPassMode & CTRL2_HIGH_PASS_MODE_MASK) |
+      (config.highPassDivisor & CTRL2_HIGH_PASS_DIV_MASK);
+
+  ctrl[REG_CTRL_4 - REG_CTRL_1] =
+      (ctrl[REG_CTRL_4 - REG_CTRL_1] &
+       ~(CTRL4_FULL_SCALE_MASK | CTRL4_BLOCK_DATA_UPDATE_MASK)) |
+      config.range |
+      (config.blockDataUpdate ? CTRL4_UPDATE_MSB_AND_LSB_TOGETHER : 0);
+
+  ctrl[REG_CTRL_5 - REG_CTRL_1] =
+      (ctrl[REG_CTRL_5 - REG_CTRL_1] & ~CTRL5_FILTERING_MASK) |
+      (config.filtering & CTRL5_FILTERING_MASK);
+
+  // Only write from the first register that changed to the last one, which
+  // is still one burst.
+  size_t first = sizeof(ctrl);
+  size_t last = 0;
+  for (size_t i = 0; i < sizeof(ctrl); i++) {
+    if (ctrl[i] != _ctrlShadow[i]) {
+      if (first == sizeof(ctrl)) {
+        first = i;
+      }
+      last = i;
+    }
+  }
 
-int16_t L3G4200D_Unified::rawY() {
-  uint8_t yLow = spiReadReg(REG_OUT_Y_L);
-  uint8_t yHigh = spiReadReg(REG_OUT_Y_H);
-  return (int16_t)((yHigh << 8) | yLow);
-}
+  if (first == sizeof(ctrl)) {
+    return;
+  }
 
-int16_t L3G4200D_Unified::rawZ() {
-  uint8_t zLow = spiReadReg(REG_OUT_Z_L);
-  uint8_t zHigh = spiReadReg(REG_OUT_Z_H);
-  return (int16_t)((zHigh << 8) | zLow);
-}
+  spiWriteRegs(REG_CTRL_1 + first, &ctrl[first], last - first + 1);
 
-rawGyroSample L3G4200D_Unified::rawXYZ() {
+  bool settle = false;
+  for (size_t i = first; i <= last; i++) {
+    settle |= needsSettling(REG_CTRL_1 + i, _ctrlShadow[i], ctrl[i]);
+    _ctrlShadow[i] = ctrl[i];
+  }
 
-  /* L3G4200D SPI read command is:
-   * 1 bit:  always set HIGH to indicate we're reading
-   * 1 bit:  HIGH indicates auto-increment address across multiple reads;
-   *         we're reading 3 register values, so we assert HIGH.
-   * 5 bits: The address of the register we want to read from.
-   *
-   * So the byte we transfer over SPI is the address, but with the two most
-   * significant bits set to indicate a register read, and auto-incrementing
-   * address.
-   * This byte will be the same for each read, even though we're reading
-   * different registers, because we're using the auto-increment bit to
-   * change which register we're reading.
-   */
+  if (settle) {
+    startSettling(L3G4200D_SETTLING_SAMPLES);
+  }
 
-  uint8_t readCmd = REG_OUT_X_L | 0b11000000;
+  if (config.range != _range) {
+    _range = config.range;
+    updateScaleFactors();
 
-  beginTransaction();
+    // Settling has already thrown away anything taken at the old range.
+    if (!settle) {
+      discardQueuedSamples();
+    }
+  }
+}
 
-  // Ignore the first return value, since the gyroscope SPI peripheral hasn't
-  // gotten a chance to known what we're asking of it yet.
-  _spi->transfer(readCmd);
+void L3G4200D_Unified::setEnabledAxes(gyroAxes_t axes) {
+  updateCtrlReg(REG_CTRL_1, CTRL1_POWER_AXES_MASK, axes);
+}
 
-  // Now start storing values. Remember, the value that's returned by the SPI
-  // transfer is the value we asked for in the *last* call to _spi->transfer().
-  uint8_t xLow = _spi->transfer(readCmd);
-  uint8_t xHigh = _spi->transfer(readCmd);
-  uint8_t yLow = _spi->transfer(readCmd);
-  uint8_t yHigh = _spi->transfer(readCmd);
-  uint8_t zLow = _spi->transfer(readCmd);
-  uint8_t zHigh = _spi->transfer(readCmd);
+void L3G4200D_Unified::setRateAndCutoff(uint8_t rateAndCutoff) {
+  updateCtrlReg(REG_CTRL_1, CTRL1_RATE_CUTOFF_MASK, rateAndCutoff);
+}
 
-  endTransaction();
+void L3G4200D_Unified::setHighPassDivisor(uint8_t divisor) {
+  updateCtrlReg(REG_CTRL_2, CTRL2_HIGH_PASS_DIV_MASK, divisor);
+}
 
-  // Now populate the struct with the raw samples.
-  rawGyroSample sample;
-  sample.x = (int16_t)((xHigh << 8) | xLow);
-  sample.y = (int16_t)((yHigh << 8) | yLow);
-  sample.z = (int16_t)((zHigh << 8) | zLow);
+void L3G4200D_Unified::setHighPassFilter(gyroHighPassMode_t mode,
+                                         gyroHighPassDivisor_t divisor) {
+  updateCtrlReg(REG_CTRL_2,
+                CTRL2_HIGH_PASS_MODE_MASK | CTRL2_HIGH_PASS_DIV_MASK,
+                mode | divisor);
+}
 
-  // And return it.
-  return sample;
+void L3G4200D_Unified::setHighPassReference(uint8_t reference) {
+  spiWriteReg(REG_REFERENCE, reference);
 }
 
-void L3G4200D_Unified::beginTransaction() {
-  _spi->beginTransaction(_spiSettings);
-  digitalWrite(_spiCS, LOW);
+void L3G4200D_Unified::resetHighPassFilter() { spiReadReg(REG_REFERENCE); }
+
+void L3G4200D_Unified::setFilterPath(gyroFilterPath_t path) {
+  updateCtrlReg(REG_CTRL_5, CTRL5_FILTERING_MASK, path);
 }
 
-void L3G4200D_Unified::endTransaction() {
-  digitalWrite(_spiCS, HIGH);
-  _spi->endTransaction();
+void L3G4200D_Unified::setBlockDataUpdate(bool enabled) {
+  updateCtrlReg(REG_CTRL_4, CTRL4_BLOCK_DATA_UPDATE_MASK,
+                enabled ? CTRL4_UPDATE_MSB_AND_LSB_TOGETHER : 0);
 }
 
-uint8_t L3G4200D_Unified::spiReadReg(uint8_t regAddress) {
+float L3G4200D_Unified::rangeInRadians() {
+  // Divided by 2 because we have both negative and positive values.
+  switch (_range) {
+  // Intentional fallthrough.
+  default:
+  case GYRO_RANGE_4_DOT_36_RAD_PER_SEC:
+    return L3G4200D_HALF_RANGE_4_DOT_36;
 
-  beginTransaction();
+  case GYRO_RANGE_8_DOT_73_RAD_PER_SEC:
+    return L3G4200D_HALF_RANGE_8_DOT_73;
 
-  /* L3G4200D SPI read command is:
-   * 1 bit:  always set HIGH to indicate we're reading
-   * 1 bit:  HIGH indicates auto-increment address across multiple reads, so we
-   * assert LOW. 5 bits: The address of the register we want to read from.
-   *
-   * So the byte we transfer over SPI is the address, but with the most
-   * significant bit set to indicate a register read.
-   * In this case we don't care about the return value.
-   */
-  _spi->transfer(regAddress | 0x80);
+  case GYRO_RANGE_34_DOT_91_RAD_PER_SEC:
+    return L3G4200D_HALF_RANGE_34_DOT_91;
+  }
+}
 
-  // Now that we've sent the address over SPI, perform one more transfer to get
-  // the response from the peripheral.
-  uint8_t val = _spi->transfer(0);
+uint8_t L3G4200D_Unified::rawReadReg(uint8_t regAddress) {
+  if (isShadowed(regAddress)) {
+    return _ctrlShadow[regAddress - REG_CTRL_1];
+  }
 
-  endTransaction();
+  return spiReadReg(regAddress);
+}
 
-  return val;
+void L3G4200D_Unified::rawWriteReg(uint8_t regAddress, uint8_t newValue) {
+  if (isShadowed(regAddress)) {
+    writeCtrlReg(regAddress, newValue);
+  } else {
+    spiWriteReg(regAddress, newValue);
+  }
+  followRawWrite(regAddress, newValue);
 }
 
-void L3G4200D_Unified::spiWriteReg(uint8_t regAddress, uint8_t value) {
+void L3G4200D_Unified::rawReadRegs(uint8_t startAddress, uint8_t *buf,
+                                   size_t count) {
+  spiReadRegs(startAddress, buf, count);
+}
 
-  beginTransaction();
+void L3G4200D_Unified::rawWriteRegs(uint8_t startAddress,
+                                    const uint8_t *values, size_t count) {
+  spiWriteRegs(startAddress, values, count);
+
+  // Keep our copy of any control registers that were in the burst up to date.
+  bool settle = false;
+  for (size_t i = 0; i < count; i++) {
+    uint8_t regAddress = startAddress + i;
+    if (isShadowed(regAddress)) {
+      settle |= needsSettling(regAddress, _ctrlShadow[regAddress - REG_CTRL_1],
+                              values[i]);
+      _ctrlShadow[regAddress - REG_CTRL_1] = values[i];
+    }
+  }
 
-  /* L3G4200D SPI write command is:
-   * 1 bit:  always LOW to indicate we're writing
-   * 1 bit:  HIGH indicates auto-increment address across multiple reads, so we
-   * assert LOW 5 bits: The address of the register we want to read from. 8
-   * bits: The byte that is written to that register.
-   *
-   * So that's two bytes, one that's just the register address, anod
-   * another that's just the value to write to that register.
-   */
+  _ctrlShadow[REG_CTRL_5 - REG_CTRL_1] &= ~CTRL5_REBOOT_MEMORY;
 
-  _spi->transfer(regAddress);
-  _spi->transfer(value);
+  if (settle) {
+    startSettling(L3G4200D_SETTLING_SAMPLES);
+  }
 
-  endTransaction();
+  for (size_t i = 0; i < count; i++) {
+    followRawWrite(startAddress + i, values[i]);
+  }
+}
+
+void L3G4200D_Unified::followRawWrite(uint8_t regAddress, uint8_t value) {
+  switch (regAddress) {
+  case REG_CTRL_4: {
+    // Both of the top two full scale settings are 2000 deg/s.
+    uint8_t fullScale = value & CTRL4_FULL_SCALE_MASK;
+    gyroRange_t range = fullScale == CTRL4_FULL_SCALE_MASK
+                            ? GYRO_RANGE_34_DOT_91_RAD_PER_SEC
+                            : (gyroRange_t)fullScale;
+    if (range != _range) {
+      _range = range;
+      updateScaleFactors();
+
+      // Anything queued was taken at the old range, like in setRange().
+      discardQueuedSamples();
+    }
+    break;
+  }
+
+  case REG_CTRL_5:
+    _fifoEnabled = value & CTRL5_FIFO_ENABLE;
+    break;
+
+  case REG_FIFO_CTRL:
+    _fifoCtrl = value;
+    break;
+
+  default:
+    break;
+  }
+}
+
+bool L3G4200D_Unified::calibrate(uint16_t samples) {
+  if (samples == 0) {
+    return false;
+  }
+
+  // It reads the output registers directly, so anything else taking samples
+  // from the gyroscope would take them from under it, or it from them.
+  if (_fifoEnabled || _interruptCaptureEnabled ||
+      _dutyCycleState != DUTY_CYCLE_OFF) {
+    debugLog("Can't calibrate with the FIFO, interrupt capture, or duty "
+             "cycling on.\n");
+    return false;
+  }
+
+  // Give up if new samples stop coming, allowing twice as long as they
+  // should take, settling included.
+  uint32_t periodMicros = samplePeriodMicros();
+  uint32_t waitSamples = (uint32_t)samples + _settlingSamples;
+  uint32_t timeoutMillis = (waitSamples * periodMicros * 2) / 1000 + 100;
+  uint32_t startMillis = millis();
+
+  int32_t sum[3] = {0, 0, 0};
+  int16_t lowest[3] = {INT16_MAX, INT16_MAX, INT16_MAX};
+  int16_t highest[3] = {INT16_MIN, INT16_MIN, INT16_MIN};
+
+  uint16_t count = 0;
+  while (count < samples) {
+    gyroSample_t sample = rawXYZ();
+    if (!(_lastStatus & STATUS_XYZ_NEW_DATA)) {
+      if (millis() - startMillis > timeoutMillis) {
+        debugLog("Timed out waiting for samples to calibrate with.\n");
+        return false;
+      }
+      continue;
+    }
+
+    // Samples from while the filters settle after a change would throw the
+    // average off.
+    if (isSettlingSample(true)) {
+      continue;
+    }
+
+    int16_t values[3] = {sample.x, sample.y, sample.z};
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      sum[axis] += values[axis];
+      if (values[axis] < lowest[axis]) {
+        lowest[axis] = values[axis];
+      }
+      if (values[axis] > highest[axis]) {
+        highest[axis] = values[axis];
+      }
+    }
+    count++;
+
+    // Anything more than noise means we're not still, and the average would
+    // include real motion. This also keeps the sums from overflowing.
+    uint8_t shift = biasShift() - BIAS_FRACTION_BITS;
+    int32_t allowed = (2 * L3G4200D_STILL_THRESHOLD) >> shift;
+    if (highest[0] - lowest[0] > allowed || highest[1] - lowest[1] > allowed ||
+        highest[2] - lowest[2] > allowed) {
+      debugLog("The gyroscope moved while calibrating.\n");
+      return false;
+    }
+  }
+
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    _bias[axis] =
+        (int32_t)((int64_t)sum[axis] * (1L << biasShift()) / samples);
+  }
+  _biasTemperature = readTemperature();
+  _stillSamples = 0;
+  updateRangeBias();
+
+  return true;
+}
+
+void L3G4200D_Unified::clearCalibration() {
+  memset(_bias, 0, sizeof(_bias));
+  _biasTemperature = 0;
+  memset(&_rangeBias, 0, sizeof(gyroSample_t));
+}
+
+size_t L3G4200D_Unified::saveCalibration(uint8_t *blob, size_t size) {
+  if (size < L3G4200D_CALIBRATION_SIZE) {
+    return 0;
+  }
+
+  // Lay the blob out byte by byte, little-endian, like the telemetry frames,
+  // so it can be restored on a different board.
+  blob[0] = L3G4200D_CALIBRATION_VERSION;
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    uint32_t bias = (uint32_t)_bias[axis];
+    blob[1 + axis * 4] = (uint8_t)bias;
+    blob[2 + axis * 4] = (uint8_t)(bias >> 8);
+    blob[3 + axis * 4] = (uint8_t)(bias >> 16);
+    blob[4 + axis * 4] = (uint8_t)(bias >> 24);
+  }
+  blob[13] = (uint8_t)_biasTemperature;
+
+  uint8_t check = 0;
+  for (uint8_t i = 0; i < L3G4200D_CALIBRATION_SIZE - 1; i++) {
+    check ^= blob[i];
+  }
+  blob[14] = check;
+
+  return L3G4200D_CALIBRATION_SIZE;
+}
+
+bool L3G4200D_Unified::loadCalibration(const uint8_t *blob, size_t size,
+                                       uint8_t maxTemperatureChange) {
+  if (size < L3G4200D_CALIBRATION_SIZE ||
+      blob[0] != L3G4200D_CALIBRATION_VERSION) {
+    return false;
+  }
+
+  // Blank EEPROM (all 0xff) fails this too.
+  uint8_t check = 0;
+  for (uint8_t i = 0; i < L3G4200D_CALIBRATION_SIZE - 1; i++) {
+    check ^= blob[i];
+  }
+  if (check != blob[14]) {
+    return false;
+  }
+
+  int8_t temperature = (int8_t)blob[13];
+  int16_t change = (int16_t)readTemperature() - temperature;
+  if (change < 0) {
+    change = -change;
+  }
+  if (change > maxTemperatureChange) {
+    return false;
+  }
+
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    _bias[axis] = (int32_t)((uint32_t)blob[1 + axis * 4] |
+                            ((uint32_t)blob[2 + axis * 4] << 8) |
+                            ((uint32_t)blob[3 + axis * 4] << 16) |
+                            ((uint32_t)blob[4 + axis * 4] << 24));
+  }
+  _biasTemperature = temperature;
+  _stillSamples = 0;
+  updateRangeBias();
+
+  return true;
+}
+
+void L3G4200D_Unified::enableOnlineCalibration(bool enabled) {
+  _onlineCalibrationEnabled = enabled;
+  _stillSamples = 0;
+}
+
+int8_t L3G4200D_Unified::readTemperature() {
+  return (int8_t)spiReadReg(REG_OUT_TEMP);
+}
+
+uint8_t L3G4200D_Unified::biasShift() {
+  // The ranges are 1, 2, and 8 times the 4.36 rad/s range.
+  switch (_range) {
+  // Intentional fallthrough.
+  default:
+  case GYRO_RANGE_4_DOT_36_RAD_PER_SEC:
+    return BIAS_FRACTION_BITS;
+
+  case GYRO_RANGE_8_DOT_73_RAD_PER_SEC:
+    return BIAS_FRACTION_BITS + 1;
+
+  case GYRO_RANGE_34_DOT_91_RAD_PER_SEC:
+    return BIAS_FRACTION_BITS + 3;
+  }
+}
+
+void L3G4200D_Unified::updateRangeBias() {
+  uint8_t shift = biasShift();
+  int32_t half = 1L << (shift - 1);
+  _rangeBias.x = (int16_t)((_bias[0] + half) >> shift);
+  _rangeBias.y = (int16_t)((_bias[1] + half) >> shift);
+  _rangeBias.z = (int16_t)((_bias[2] + half) >> shift);
+}
+
+void L3G4200D_Unified::correctBias(gyroSample_t &sample, bool learn,
+                                   uint8_t firstAxis, uint8_t lastAxis) {
+  int32_t x = (int32_t)sample.x - _rangeBias.x;
+  int32_t y = (int32_t)sample.y - _rangeBias.y;
+  int32_t z = (int32_t)sample.z - _rangeBias.z;
+
+  if (learn && _onlineCalibrationEnabled) {
+    uint8_t shift = biasShift();
+    int32_t threshold =
+        L3G4200D_STILL_THRESHOLD >> (shift - BIAS_FRACTION_BITS);
+
+    if (largestMagnitude(x, y, z) >= threshold) {
+      _stillSamples = 0;
+    } else if (_stillSamples < L3G4200D_STILL_HOLD) {
+      _stillSamples++;
+    } else {
+      // Nudge the bias a little of the way towards this sample.
+      _bias[0] += ((int32_t)sample.x * (1L << shift) - _bias[0]) >>
+                  L3G4200D_ONLINE_CALIBRATION_SHIFT;
+      _bias[1] += ((int32_t)sample.y * (1L << shift) - _bias[1]) >>
+                  L3G4200D_ONLINE_CALIBRATION_SHIFT;
+      _bias[2] += ((int32_t)sample.z * (1L << shift) - _bias[2]) >>
+                  L3G4200D_ONLINE_CALIBRATION_SHIFT;
+      updateRangeBias();
+    }
+  }
+
+  // Only correct the enabled axes that were read, so the others still read
+  // as 0, and keep the result in range.
+  uint8_t axes = _ctrlShadow[REG_CTRL_1 - REG_CTRL_1];
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    if (axis < firstAxis || axis > lastAxis) {
+      axes &= ~(CTRL1_X_ENABLE << axis);
+    }
+  }
+  if (axes & CTRL1_X_ENABLE) {
+    sample.x = x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x);
+  }
+  if (axes & CTRL1_Y_ENABLE) {
+    sample.y = y > INT16_MAX ? INT16_MAX : (y < INT16_MIN ? INT16_MIN : y);
+  }
+  if (axes & CTRL1_Z_ENABLE) {
+    sample.z = z > INT16_MAX ? INT16_MAX : (z < INT16_MIN ? INT16_MIN : z);
+  }
+}
+
+void L3G4200D_Unified::sleep() { enterPowerMode(CTRL1_SLEEP); }
+
+void L3G4200D_Unified::powerDown() { enterPowerMode(CTRL1_POWER_DOWN); }
+
+void L3G4200D_Unified::enterPowerMode(uint8_t powerAxes) {
+  if (powerMode() == GYRO_POWER_NORMAL) {
+    _awakeAxes = _ctrlShadow[REG_CTRL_1 - REG_CTRL_1] & CTRL1_POWER_AXES_MASK;
+  }
+
+  updateCtrlReg(REG_CTRL_1, CTRL1_POWER_AXES_MASK, powerAxes);
+}
+
+uint32_t L3G4200D_Unified::wake() {
+  gyroPowerMode_t mode = powerMode();
+  if (mode == GYRO_POWER_NORMAL) {
+    return 0;
+  }
+
+  updateCtrlReg(REG_CTRL_1, CTRL1_POWER_AXES_MASK, _awakeAxes);
+
+  // Out of sleep, the filters just need to settle again. Out of power-down,
+  // the whole gyroscope has to start up, which takes a fixed time whatever
+  // the data rate is.
+  uint32_t periodMicros = samplePeriodMicros();
+  uint32_t settling = L3G4200D_SETTLING_SAMPLES;
+  if (mode == GYRO_POWER_DOWN) {
+    settling = (L3G4200D_POWER_DOWN_TURN_ON_MICROS + periodMicros - 1) /
+               periodMicros;
+  }
+  if (settling > UINT8_MAX) {
+    settling = UINT8_MAX;
+  }
+  startSettling(settling);
+
+  // The first sample comes a period after waking up, so the first good one
+  // comes a period after the last one thrown away.
+  return (settling + 1) * periodMicros;
+}
+
+gyroPowerMode_t L3G4200D_Unified::powerMode() {
+  uint8_t powerAxes =
+      _ctrlShadow[REG_CTRL_1 - REG_CTRL_1] & CTRL1_POWER_AXES_MASK;
+  if (powerAxes == CTRL1_POWER_DOWN) {
+    return GYRO_POWER_DOWN;
+  } else if (powerAxes == CTRL1_SLEEP) {
+    return GYRO_POWER_SLEEP;
+  }
+  return GYRO_POWER_NORMAL;
+}
+
+void L3G4200D_Unified::enableDutyCycle(uint32_t periodMillis,
+                                       uint8_t burstSamples,
+                                       gyroPowerMode_t idleMode) {
+  if (burstSamples > L3G4200D_FIFO_DEPTH) {
+    burstSamples = L3G4200D_FIFO_DEPTH;
+  }
+
+  _dutyCyclePeriodMillis = periodMillis;
+  _dutyCycleBurstSamples = burstSamples;
+  _dutyCycleIdleMode = idleMode;
+
+  if (idleMode == GYRO_POWER_DOWN) {
+    powerDown();
+  } else {
+    sleep();
+  }
+
+  // Start the first burst on the next serviceDutyCycle().
+  _dutyCycleStartMillis = millis() - periodMillis;
+  _dutyCycleState = DUTY_CYCLE_IDLE;
+}
+
+void L3G4200D_Unified::disableDutyCycle() {
+  if (_dutyCycleState == DUTY_CYCLE_OFF) {
+    return;
+  }
+
+  _dutyCycleState = DUTY_CYCLE_OFF;
+  disableFifo();
+  wake();
+}
+
+size_t L3G4200D_Unified::serviceDutyCycle(gyroSample_t *buf, size_t max) {
+  switch (_dutyCycleState) {
+  case DUTY_CYCLE_OFF:
+    return 0;
+
+  case DUTY_CYCLE_IDLE:
+    if (millis() - _dutyCycleStartMillis < _dutyCyclePeriodMillis) {
+      return 0;
+    }
+
+    // Count the period from when this burst was due, not from now, so the
+    // bursts don't drift later and later.
+    _dutyCycleStartMillis += _dutyCyclePeriodMillis;
+    _dutyCyclePhaseMicros = wake();
+    _dutyCyclePhaseStartMicros = micros();
+    _dutyCycleState = DUTY_CYCLE_WARMING_UP;
+    return 0;
+
+  case DUTY_CYCLE_WARMING_UP:
+    if (micros() - _dutyCyclePhaseStartMicros < _dutyCyclePhaseMicros) {
+      return 0;
+    }
+
+    // We've waited out the warm-up ourselves, so start the FIFO from empty
+    // (going through bypass clears it) and collect the burst.
+    _settlingSamples = 0;
+    _heldSampleSettling = false;
+    _sampleClock.reset(samplePeriodMicros());
+    enableFifo(GYRO_FIFO_BYPASS);
+    enableFifo(GYRO_FIFO_ONE_SHOT);
+    _dutyCyclePhaseMicros = _dutyCycleBurstSamples * samplePeriodMicros();
+    _dutyCyclePhaseStartMicros = micros();
+    _dutyCycleState = DUTY_CYCLE_COLLECTING;
+    return 0;
+
+  case DUTY_CYCLE_COLLECTING: {
+    if (micros() - _dutyCyclePhaseStartMicros < _dutyCyclePhaseMicros) {
+      return 0;
+    }
+
+    if (max > _dutyCycleBurstSamples) {
+      max = _dutyCycleBurstSamples;
+    }
+    size_t count = readFifo(buf, max);
+
+    if (_dutyCycleIdleMode == GYRO_POWER_DOWN) {
+      powerDown();
+    } else {
+      sleep();
+    }
+    _dutyCycleState = DUTY_CYCLE_IDLE;
+    return count;
+  }
+  }
+
+  return 0;
+}
+
+void L3G4200D_Unified::enableFifo(gyroFifoMode_t mode, uint8_t watermark) {
+  _fifoCtrl = mode | (watermark & FIFO_CTRL_WATERMARK_MASK);
+  spiWriteReg(REG_FIFO_CTRL, _fifoCtrl);
+
+  updateCtrlReg(REG_CTRL_5, CTRL5_FIFO_ENABLE, CTRL5_FIFO_ENABLE);
+
+  _fifoEnabled = true;
+}
+
+void L3G4200D_Unified::disableFifo() {
+  updateCtrlReg(REG_CTRL_5, CTRL5_FIFO_ENABLE, 0);
+
+  spiWriteReg(REG_FIFO_CTRL, FIFO_CTRL_MODE_BYPASS);
+
+  _fifoEnabled = false;
+}
+
+size_t L3G4200D_Unified::readFifo(gyroSample_t *buf, size_t max) {
+  startSpiTransaction();
+  size_t count = drainFifo(buf, max);
+  endSpiTransaction();
+
+  return count;
+}
+
+size_t L3G4200D_Unified::drainFifo(gyroSample_t *buf, size_t max) {
+
+  // Find out how many samples are waiting for us. The level bits only go up
+  // to 31, so a full FIFO is indicated by the overrun bit instead.
+  uint8_t fifoSrc;
+  frameReadRegs(REG_FIFO_SRC, &fifoSrc, 1);
+
+  size_t pending;
+  if (fifoSrc & FIFO_SRC_EMPTY) {
+    pending = 0;
+  } else if (fifoSrc & FIFO_SRC_OVERRUN) {
+    pending = L3G4200D_FIFO_DEPTH;
+    STATS_ADD(fifoOverruns, 1);
+
+    // Samples were lost, so the sample clock has to start counting again.
+    // This may be the interrupt handler, so leave the reset to
+    // stampSamples().
+    _samplesLost = true;
+  } else {
+    pending = fifoSrc & FIFO_SRC_LEVEL_MASK;
+  }
+
+  size_t count = pending < max ? pending : max;
+  if (count == 0) {
+    return 0;
+  }
+
+  // With the FIFO enabled, the auto-increment address wraps from OUT_Z_H back
+  // to OUT_X_L and pops the next sample, so one burst of six bytes per sample
+  // drains everything in a single frame. Read the bytes straight into the
+  // caller's buffer, and then unpack each sample in place.
+  uint8_t *bytes = (uint8_t *)buf;
+  frameReadRegs(REG_OUT_X_L, bytes, count * 6);
+
+  for (size_t i = 0; i < count; i++) {
+    uint8_t sampleBytes[6];
+    memcpy(sampleBytes, &bytes[i * 6], sizeof(sampleBytes));
+    buf[i] = sampleFromBytes(sampleBytes);
+  }
+
+  return count;
+}
+
+void L3G4200D_Unified::enableDataReadyInterrupt(int interruptNumber,
+                                                bool useWatermark) {
+  disableDataReadyInterrupt();
+
+#ifdef SPI_HAS_NOTUSINGINTERRUPT
+  _spi->usingInterrupt(interruptNumber);
+#endif
+  _interruptNumber = interruptNumber;
+
+  setDataReadyInterrupt(useWatermark ? CTRL3_I2_WATERMARK
+                                     : CTRL3_I2_DATA_READY);
+}
+
+void L3G4200D_Unified::disableDataReadyInterrupt() {
+  setDataReadyInterrupt(0);
+
+  if (_interruptNumber >= 0) {
+#ifdef SPI_HAS_NOTUSINGINTERRUPT
+    _spi->notUsingInterrupt(_interruptNumber);
+#endif
+    _interruptNumber = -1;
+  }
+}
+
+void L3G4200D_Unified::setDataReadyInterrupt(uint8_t interruptBits) {
+  // Stop the interrupt handler from touching the buffer before we clear out
+  // anything left over from last time.
+  _interruptCaptureEnabled = false;
+  _interruptPending = false;
+  _sampleRing.clear();
+
+  updateCtrlReg(REG_CTRL_3, CTRL3_I2_DATA_READY | CTRL3_I2_WATERMARK,
+                interruptBits);
+
+  _interruptCaptureEnabled = interruptBits != 0;
+}
+
+void L3G4200D_Unified::handleInterrupt() {
+  // The samples were ready when the interrupt came in, however long it takes
+  // to get round to reading them.
+  uint32_t interruptMicros = micros();
+
+  if (!_interruptCaptureEnabled) {
+    return;
+  }
+
+  // If the main loop is partway through a transaction, starting another one
+  // would corrupt both, so leave it to endSpiTransaction() to read them.
+  if (_busDepth > 0) {
+    if (!_interruptPending) {
+      _interruptMicros = interruptMicros;
+      _interruptPending = true;
+    }
+    return;
+  }
+
+  captureSamples(interruptMicros);
+}
+
+void L3G4200D_Unified::captureSamples(uint32_t interruptMicros) {
+  capturedSample_t captured;
+  captured.readMicros = interruptMicros;
+
+  if (_fifoEnabled) {
+    gyroSample_t samples[L3G4200D_FIFO_DEPTH];
+    size_t count = readFifo(samples, L3G4200D_FIFO_DEPTH);
+    for (size_t i = 0; i < count; i++) {
+      captured.sample = samples[i];
+      captured.newer = count - 1 - i;
+      if (!_sampleRing.push(captured)) {
+        STATS_ADD(captureOverruns, 1);
+      }
+    }
+    return;
+  }
+
+  // A handler that was put off can run just after the sample it was for
+  // has been read by another, so only keep new samples.
+  captured.sample = rawXYZ();
+  captured.newer = 0;
+  if (!(_lastStatus & STATUS_XYZ_NEW_DATA)) {
+    return;
+  }
+  if (!_sampleRing.push(captured)) {
+    STATS_ADD(captureOverruns, 1);
+  }
+}
+
+bool L3G4200D_Unified::popCaptured(gyroSample_t &sample) {
+  capturedSample_t captured;
+  if (!_sampleRing.pop(captured)) {
+    return false;
+  }
+
+  // Samples read together from the FIFO were taken a period apart, up to
+  // the newest, which had just been taken when the interrupt came in.
+  uint64_t newerMicrosQ16 =
+      (uint64_t)captured.newer * _sampleClock.periodMicrosQ16();
+  _capturedMicros = captured.readMicros - (uint32_t)(newerMicrosQ16 >> 16);
+
+  sample = captured.sample;
+  return true;
+}
+
+size_t L3G4200D_Unified::readSamples(gyroSample_t *buf, size_t max) {
+  if (max == 0) {
+    return 0;
+  }
+
+  if (_interruptCaptureEnabled) {
+    size_t count = 0;
+    while (count < max && popCaptured(buf[count])) {
+      count++;
+    }
+
+    return discardSettling(buf, count);
+  }
+
+  if (_fifoEnabled) {
+    return discardSettling(buf, readFifo(buf, max));
+  }
+
+  // Like getEventIfNew(), a sample we've already read doesn't count.
+  buf[0] = rawXYZ();
+  if (!(_lastStatus & STATUS_XYZ_NEW_DATA)) {
+    STATS_ADD(staleSamples, 1);
+    return 0;
+  }
+  if (_lastStatus & STATUS_XYZ_OVERRUN) {
+    STATS_ADD(sampleOverruns, 1);
+    _sampleClock.reset(samplePeriodMicros());
+  }
+  return discardSettling(buf, 1);
+}
+
+size_t L3G4200D_Unified::getEvents(sensors_event_t *events, size_t max) {
+
+  // Read in chunks the size of the FIFO, so we don't need a big buffer.
+  gyroSample_t samples[L3G4200D_FIFO_DEPTH];
+  size_t total = 0;
+
+  while (total < max) {
+    size_t wanted = max - total;
+    if (wanted > L3G4200D_FIFO_DEPTH) {
+      wanted = L3G4200D_FIFO_DEPTH;
+    }
+
+    // Everything readSamples() gives us is new.
+    size_t count = readSamples(samples, wanted);
+    uint32_t first = finishSamples(samples, count, true);
+    uint32_t nowMillis = millis();
+    uint32_t nowMicros = micros();
+
+    for (size_t i = 0; i < count; i++) {
+      sensors_event_t *event = &events[total + i];
+      memset(event, 0, sizeof(sensors_event_t));
+
+      event->version = sizeof(sensors_event_t);
+      event->sensor_id = _sensorId;
+      event->type = SENSOR_TYPE_GYROSCOPE;
+      event->timestamp = eventTimestamp(
+          _sampleClock.timestampMicros(first + i), nowMillis, nowMicros);
+
+      event->gyro.x = sampleToRad(samples[i].x);
+      event->gyro.y = sampleToRad(samples[i].y);
+      event->gyro.z = sampleToRad(samples[i].z);
+    }
+
+    // Everything above was converted at the range it was collected at, so
+    // only now check whether the range should change. Stop at the first
+    // change, since the rest of the samples are in the old range's counts.
+    if (_autoRangeEnabled) {
+      gyroRange_t range = _range;
+      for (size_t i = 0; i < count && _range == range; i++) {
+        autoRange(samples[i]);
+      }
+    }
+
+    total += count;
+
+    // Nothing more is waiting for us.
+    if (count < wanted) {
+      break;
+    }
+  }
+
+  return total;
+}
+
+bool L3G4200D_Unified::startRead(gyroReadCallback_t callback,
+                                 void *context) {
+  if (_asyncReadBusy) {
+    return false;
+  }
+
+  _asyncCallback = callback;
+  _asyncContext = context;
+
+  // Same read command as rawXYZ(), followed by six dummy bytes to clock the
+  // sample out.
+  memset(_asyncFrame, 0, sizeof(_asyncFrame));
+  _asyncFrame[0] = REG_OUT_X_L | 0b11000000;
+
+  beginTransaction();
+  STATS_ADD(spiBytes, sizeof(_asyncFrame));
+
+#ifdef L3G4200D_ASYNC_SPI
+  // The response overwrites the buffer as it goes, which is fine since the
+  // command byte has already been sent by the time its response comes back.
+  // Keep the transaction open until the transfer is done.
+  _spi->transfer(_asyncFrame, _asyncFrame, sizeof(_asyncFrame), false);
+  _asyncTransferOpen = true;
+#else
+  // The transfer is already done, so let go of the bus straight away and
+  // leave the sample for pollReadComplete().
+  _spi->transfer(_asyncFrame, sizeof(_asyncFrame));
+  endTransaction();
+#endif
+
+  _asyncReadBusy = true;
+  return true;
+}
+
+bool L3G4200D_Unified::pollReadComplete(gyroSample_t *sample) {
+  if (!_asyncReadBusy) {
+    return true;
+  }
+
+  if (_asyncTransferOpen) {
+#ifdef L3G4200D_ASYNC_SPI
+    if (_spi->isBusy()) {
+      return false;
+    }
+#endif
+    finishAsyncTransfer();
+  }
+
+  _asyncReadBusy = false;
+
+  // The first byte is the response to the command byte, which is garbage.
+  gyroSample_t newSample = sampleFromBytes(&_asyncFrame[1]);
+
+  if (sample != NULL) {
+    *sample = newSample;
+  }
+
+  if (_asyncCallback != NULL) {
+    _asyncCallback(newSample, _asyncContext);
+  }
+
+  return true;
+}
+
+void L3G4200D_Unified::finishAsyncTransfer() {
+#ifdef L3G4200D_ASYNC_SPI
+  while (_spi->isBusy()) {
+  }
+#endif
+
+  _asyncTransferOpen = false;
+  endTransaction();
+}
+
+int16_t L3G4200D_Unified::rawX() {
+  uint8_t bytes[2];
+  spiReadRegs(REG_OUT_X_L, bytes, sizeof(bytes));
+  return (int16_t)((bytes[1] << 8) | bytes[0]);
+}
+
+int16_t L3G4200D_Unified::rawY() {
+  uint8_t bytes[2];
+  spiReadRegs(REG_OUT_Y_L, bytes, sizeof(bytes));
+  return (int16_t)((bytes[1] << 8) | bytes[0]);
+}
+
+int16_t L3G4200D_Unified::rawZ() {
+  uint8_t bytes[2];
+  spiReadRegs(REG_OUT_Z_L, bytes, sizeof(bytes));
+  return (int16_t)((bytes[1] << 8) | bytes[0]);
+}
+
+rawGyroSample L3G4200D_Unified::rawXYZ() {
+  // STATUS_REG sits right before the output registers, which are laid out
+  // X low, X high, Y low, and so on, so one auto-increment read from
+  // STATUS_REG gets whether the sample is new along with every enabled axis.
+  // Axes after the last enabled one aren't read at all.
+  uint8_t bytes[7];
+  memset(bytes, 0, sizeof(bytes));
+  spiReadRegs(REG_STATUS, bytes, axisBurstLength());
+
+  // Disabled axes before the last enabled one still get read, but they hold
+  // whatever they had when they were disabled.
+  uint8_t ctrl1 = _ctrlShadow[REG_CTRL_1 - REG_CTRL_1];
+  if (!(ctrl1 & CTRL1_X_ENABLE)) {
+    bytes[1] = bytes[2] = 0;
+  }
+  if (!(ctrl1 & CTRL1_Y_ENABLE)) {
+    bytes[3] = bytes[4] = 0;
+  }
+
+  _lastStatus = bytes[0];
+  return sampleFromBytes(&bytes[1]);
+}
+
+gyroSample_t L3G4200D_Unified::rawAxes(uint8_t firstAxis, uint8_t lastAxis) {
+  // Each axis is two bytes, low byte first, starting at OUT_X_L.
+  uint8_t bytes[6];
+  memset(bytes, 0, sizeof(bytes));
+  spiReadRegs(REG_OUT_X_L + 2 * firstAxis, &bytes[2 * firstAxis],
+              2 * (lastAxis - firstAxis + 1));
+
+  return sampleFromBytes(bytes);
+}
+
+gyroSample_t L3G4200D_Unified::sampleFromBytes(const uint8_t *bytes) {
+  gyroSample_t sample;
+  sample.x = (int16_t)((bytes[1] << 8) | bytes[0]);
+  sample.y = (int16_t)((bytes[3] << 8) | bytes[2]);
+  sample.z = (int16_t)((bytes[5] << 8) | bytes[4]);
+  return sample;
+}
+
+void L3G4200D_Unified::beginTransaction() {
+  startSpiTransaction();
+  selectChip();
+}
+
+void L3G4200D_Unified::endTransaction() {
+  deselectChip();
+  endSpiTransaction();
+}
+
+void L3G4200D_Unified::startSpiTransaction() {
+  STATS_ADD(spiTransactions, 1);
+
+  // Count ourselves in before the transaction starts, so the interrupt
+  // handler can't start one of its own in between.
+  holdBus();
+  _spi->beginTransaction(_spiSettings);
+}
+
+void L3G4200D_Unified::endSpiTransaction() {
+  _spi->endTransaction();
+  releaseBus();
+}
+
+void L3G4200D_Unified::holdBus() {
+  // A background read from startRead() still has the bus, so let it finish
+  // first. Its sample is kept for pollReadComplete().
+  if (_asyncTransferOpen) {
+    finishAsyncTransfer();
+  }
+
+  _busDepth++;
+}
+
+void L3G4200D_Unified::releaseBus() {
+  _busDepth--;
+
+  if (_busDepth == 0 && _interruptPending) {
+    _interruptPending = false;
+    if (_interruptCaptureEnabled) {
+      captureSamples(_interruptMicros);
+    }
+  }
+}
+
+void L3G4200D_Unified::selectChip() {
+  STATS_ADD(chipSelects, 1);
+  digitalWrite(_spiCS, LOW);
+}
+
+void L3G4200D_Unified::deselectChip() { digitalWrite(_spiCS, HIGH); }
+
+uint8_t L3G4200D_Unified::spiReadReg(uint8_t regAddress) {
+  uint8_t val;
+  spiReadRegs(regAddress, &val, 1);
+  return val;
+}
+
+void L3G4200D_Unified::spiWriteReg(uint8_t regAddress, uint8_t value) {
+  spiWriteRegs(regAddress, &value, 1);
+}
+
+void L3G4200D_Unified::spiReadRegs(uint8_t startAddress, uint8_t *buf,
+                                   size_t count) {
+  startSpiTransaction();
+  frameReadRegs(startAddress, buf, count);
+  endSpiTransaction();
+}
+
+void L3G4200D_Unified::frameReadRegs(uint8_t startAddress, uint8_t *buf,
+                                     size_t count) {
+
+  /* L3G4200D SPI read command is:
+   * 1 bit:  always set HIGH to indicate we're reading
+   * 1 bit:  HIGH indicates auto-increment address across multiple reads, so we
+   *         only assert it if we're reading more than one register.
+   * 6 bits: The address of the register we want to start reading from.
+   *
+   * The response to the command byte itself is garbage, since the gyroscope
+   * hasn't gotten a chance to know what we're asking of it yet. Each byte
+   * after that is the next register.
+   */
+  uint8_t readCmd = startAddress | 0x80;
+  if (count > 1) {
+    readCmd |= 0x40;
+  }
+
+  uint8_t frame[1 + SPI_FRAME_DATA_MAX];
+
+  selectChip();
+  STATS_ADD(spiBytes, 1 + count);
+
+  if (count <= SPI_FRAME_DATA_MAX) {
+    // Send the command and clock out the response in one buffer transfer.
+    memset(frame, 0, sizeof(frame));
+    frame[0] = readCmd;
+    _spi->transfer(frame, 1 + count);
+    memcpy(buf, &frame[1], count);
+  } else {
+    // Too big for our frame (e.g. a FIFO drain), so clock the response
+    // straight into the caller's buffer instead.
+    _spi->transfer(readCmd);
+    memset(buf, 0, count);
+    _spi->transfer(buf, count);
+  }
+
+  deselectChip();
+}
+
+void L3G4200D_Unified::spiWriteRegs(uint8_t startAddress,
+                                    const uint8_t *values, size_t count) {
+
+  /* L3G4200D SPI write command is:
+   * 1 bit:  always LOW to indicate we're writing
+   * 1 bit:  HIGH indicates auto-increment address across multiple writes, so
+   *         we only assert it if we're writing more than one register.
+   * 6 bits: The address of the register we want to start writing to.
+   *
+   * That's followed by one byte for each register we're writing.
+   */
+  uint8_t frame[1 + SPI_FRAME_DATA_MAX];
+  frame[0] = startAddress;
+  if (count > 1) {
+    frame[0] |= 0x40;
+  }
+
+  beginTransaction();
+  STATS_ADD(spiBytes, 1 + count);
+
+  // transfer(buf, len) overwrites the buffer with the response, so copy the
+  // values into our own frame rather than sending the caller's buffer. This
+  // is one transfer unless more than SPI_FRAME_DATA_MAX registers are written.
+  size_t framed = 1;
+  while (count > 0) {
+    size_t chunk = sizeof(frame) - framed;
+    if (chunk > count) {
+      chunk = count;
+    }
+
+    memcpy(&frame[framed], values, chunk);
+    _spi->transfer(frame, framed + chunk);
+
+    values += chunk;
+    count -= chunk;
+    framed = 0;
+  }
+
+  endTransaction();
+}
+
+bool L3G4200D_Unified::isShadowed(uint8_t regAddress) {
+  return regAddress >= REG_CTRL_1 && regAddress <= REG_CTRL_5;
+}
+
+void L3G4200D_Unified::writeCtrlReg(uint8_t regAddress, uint8_t value) {
+  uint8_t &shadow = _ctrlShadow[regAddress - REG_CTRL_1];
+  if (shadow == value) {
+    return;
+  }
+
+  spiWriteReg(regAddress, value);
+
+  // The reboot bit clears itself, so don't remember it as set.
+  if (regAddress == REG_CTRL_5) {
+    value &= ~CTRL5_REBOOT_MEMORY;
+  }
+  bool settle = needsSettling(regAddress, shadow, value);
+  shadow = value;
+
+  if (settle) {
+    startSettling(L3G4200D_SETTLING_SAMPLES);
+  }
+}
+
+bool L3G4200D_Unified::needsSettling(uint8_t regAddress, uint8_t oldValue,
+                                     uint8_t newValue) {
+  uint8_t mask;
+  switch (regAddress) {
+  case REG_CTRL_1:
+    mask = CTRL1_RATE_CUTOFF_MASK;
+    break;
+
+  case REG_CTRL_2:
+    mask = CTRL2_HIGH_PASS_MODE_MASK | CTRL2_HIGH_PASS_DIV_MASK;
+    break;
+
+  case REG_CTRL_5:
+    mask = CTRL5_FILTERING_MASK;
+    break;
+
+  default:
+    return false;
+  }
+
+  return (oldValue ^ newValue) & mask;
+}
+
+void L3G4200D_Unified::startSettling(uint8_t samples) {
+  // Anything already queued is from before the change and is still good, but
+  // it would be counted towards settling instead of the new samples that
+  // need throwing away, so drop it and only count what comes after.
+  discardQueuedSamples();
+
+  if (samples > _settlingSamples) {
+    _settlingSamples = samples;
+  }
+}
+
+void L3G4200D_Unified::discardQueuedSamples() {
+  // Going through bypass empties the FIFO, and then it carries on in the
+  // mode it was in.
+  if (_fifoEnabled) {
+    spiWriteReg(REG_FIFO_CTRL, FIFO_CTRL_MODE_BYPASS);
+    spiWriteReg(REG_FIFO_CTRL, _fifoCtrl);
+  } else if (!_interruptCaptureEnabled) {
+    // Without either, an unread sample waits in the output registers, still
+    // flagged as new. Reading it clears the flag.
+    rawXYZ();
+  }
+  _sampleRing.clear();
+
+  // That leaves a gap, and the data rate may have changed too, so the sample
+  // clock starts again.
+  _sampleClock.reset(samplePeriodMicros());
+}
+
+bool L3G4200D_Unified::isSettlingSample(bool fresh) {
+  if (!fresh) {
+    // Reading faster than the output data rate gets the same sample again,
+    // which is no better the second time.
+    return _settlingSamples > 0 || _heldSampleSettling;
+  }
+
+  _heldSampleSettling = _settlingSamples > 0;
+  if (_heldSampleSettling) {
+    _settlingSamples--;
+  }
+  return _heldSampleSettling;
+}
+
+size_t L3G4200D_Unified::discardSettling(gyroSample_t *buf, size_t count) {
+  size_t discard = _settlingSamples;
+  if (discard == 0) {
+    return count;
+  }
+
+  if (discard > count) {
+    discard = count;
+  }
+
+  memmove(buf, &buf[discard], (count - discard) * sizeof(gyroSample_t));
+  _settlingSamples -= discard;
+
+  return count - discard;
+}
+
+void L3G4200D_Unified::updateCtrlReg(uint8_t regAddress, uint8_t mask,
+                                     uint8_t bits) {
+  uint8_t value = _ctrlShadow[regAddress - REG_CTRL_1];
+  writeCtrlReg(regAddress, (value & ~mask) | (bits & mask));
 }
 
 float L3G4200D_Unified::sampleToRad(int16_t fullScaleSample) {
@@ -332,5 +1891,44 @@ float L3G4200D_Unified::sampleToRad(int16_t fullScaleSample) {
   // rawSample / INT16_MAX = radValue / gyroRange
   // Solving for radValue:
   // radValue = (rawSample * gyroRange) / INT16_MAX
-  return (fullScaleSample * rangeInRadians()) / INT16_MAX;
+  // gyroRange / INT16_MAX only changes with the range, so updateScaleFactors()
+  // works it out ahead of time.
+  return fullScaleSample * _radiansPerCount;
+}
+
+int32_t L3G4200D_Unified::sampleToFixed(int16_t fullScaleSample,
+                                        int32_t scale, uint8_t shift) {
+  // Same as sampleToRad(), but with the range and INT16_MAX folded into one
+  // integer scale that has shift extra bits of precision, rounding to the
+  // nearest value as we drop those bits.
+  int32_t scaled = (int32_t)fullScaleSample * scale;
+  return (scaled + (1L << (shift - 1))) >> shift;
+}
+
+void L3G4200D_Unified::updateScaleFactors() {
+  updateRangeBias();
+
+  // Every scale is a constant, so that auto-ranging in the fixed-point path
+  // doesn't need any floating point math.
+  switch (_range) {
+  // Intentional fallthrough.
+  default:
+  case GYRO_RANGE_4_DOT_36_RAD_PER_SEC:
+    _radiansPerCount = L3G4200D_HALF_RANGE_4_DOT_36 / INT16_MAX;
+    _fixedScale = L3G4200D_FIXED_SCALE(L3G4200D_HALF_RANGE_4_DOT_36);
+    _milliRadScale = L3G4200D_MILLIRAD_SCALE(L3G4200D_HALF_RANGE_4_DOT_36);
+    break;
+
+  case GYRO_RANGE_8_DOT_73_RAD_PER_SEC:
+    _radiansPerCount = L3G4200D_HALF_RANGE_8_DOT_73 / INT16_MAX;
+    _fixedScale = L3G4200D_FIXED_SCALE(L3G4200D_HALF_RANGE_8_DOT_73);
+    _milliRadScale = L3G4200D_MILLIRAD_SCALE(L3G4200D_HALF_RANGE_8_DOT_73);
+    break;
+
+  case GYRO_RANGE_34_DOT_91_RAD_PER_SEC:
+    _radiansPerCount = L3G4200D_HALF_RANGE_34_DOT_91 / INT16_MAX;
+    _fixedScale = L3G4200D_FIXED_SCALE(L3G4200D_HALF_RANGE_34_DOT_91);
+    _milliRadScale = L3G4200D_MILLIRAD_SCALE(L3G4200D_HALF_RANGE_34_DOT_91);
+    break;
+  }
 }
@@ -77,462 +77,530 @@
 #include <Adafruit_Sensor.h>
 #include <SPI.h>
 
-/*! @defgroup sensor Sensor
- *
- * @brief This contains the types used for typical operation of this L3G4200D
- * sensor.
- */
+#include "L3G4200D_Registers.h"
+#include "L3G4200D_RingBuffer.h"
+#include "L3G4200D_SampleClock.h"
 
-/*!
- * @defgroup registers Registers
- *
- * @brief This contains advanced functionality for reading and writing to raw
- * gyroscope registers. If you just want to read gyro data, you probably want
- * @ref usage or @ref sensor instead.
+/*! @brief The number of samples buffered between the interrupt handler and
+ * L3G4200D_Unified::getEvent when using interrupt-driven capture. Must be a
+ * power of two no larger than 128.
  *
- * @see L3G4200D_Unified
- *
- * @{
+ * This changes the size of L3G4200D_Unified, so it must be set for the whole
+ * build (for example with a `-DL3G4200D_SAMPLE_RING_CAPACITY=64` build flag).
+ * A `#define` in a sketch doesn't reach the library's own source files.
  */
+#ifndef L3G4200D_SAMPLE_RING_CAPACITY
+#define L3G4200D_SAMPLE_RING_CAPACITY (32)
+#endif
 
-/*! @name Addresses
- * @anchor reg_addresses
- * @{
+/*! @def L3G4200D_ASYNC_SPI
+ * @brief Define this to make L3G4200D_Unified::startRead use the
+ * non-blocking `transfer(txbuf, rxbuf, count, false)` and `isBusy()` methods
+ * of `SPIClass`, which some cores (such as Adafruit's SAMD core) implement
+ * with DMA. Without it, L3G4200D_Unified::startRead does one blocking buffer
+ * transfer and the read is complete as soon as it returns.
  */
+#ifdef DOXYGEN
+#define L3G4200D_ASYNC_SPI
+#endif
 
-/*! @brief The address of the chip ID register. Should always read as `0xd3`.
- *
- * @see L3G42000D_CHIP_ID
- */
-#define REG_WHO_AM_I (0x0F)
-
-/*! @brief The address of CTRL_REG1, which is used for bandwidth, data rate, and
- * power selection.
- *
- * @see CTRL1.
+/*! @brief Set this to 0 to compile out all debug logging, so
+ * L3G4200D_Unified::enableDebugLogging does nothing and costs nothing.
  */
-#define REG_CTRL_1 (0x20)
+#ifndef L3G4200D_DEBUG_LOGGING
+#define L3G4200D_DEBUG_LOGGING (1)
+#endif
 
-/*! @brief The address of CTRL_REG2, which is used for configuring the high pass
- * filter.
- *
- * @see CTRL2.
+/*! @brief When auto-ranging, the raw sample magnitude (out of 32767) that the
+ * next sample is predicted to reach before switching to a higher range.
  */
-#define REG_CTRL_2 (0x21)
+#ifndef L3G4200D_AUTO_RANGE_UP_THRESHOLD
+#define L3G4200D_AUTO_RANGE_UP_THRESHOLD (24576)
+#endif
 
-/*! @brief The address of CTRL_REG3, which is used for configuring the
- * electrical characteristics of the pins on the chip.
- *
- * @see CTRL3.
+/*! @brief When auto-ranging, the raw sample magnitude (out of 32767) that
+ * samples must stay under, as measured in the next lower range, before
+ * switching down to it. Keep this well under
+ * @ref L3G4200D_AUTO_RANGE_UP_THRESHOLD so the range doesn't flip back and
+ * forth.
  */
-#define REG_CTRL_3 (0x22)
+#ifndef L3G4200D_AUTO_RANGE_DOWN_THRESHOLD
+#define L3G4200D_AUTO_RANGE_DOWN_THRESHOLD (16384)
+#endif
 
-/*! @brief The address of CTRL_REG4, which is used for setting the gyroscope
+/*! @brief When auto-ranging, the number of samples in a row that must be
+ * under @ref L3G4200D_AUTO_RANGE_DOWN_THRESHOLD before switching to a lower
  * range.
- *
- * @see CTRL4.
  */
-#define REG_CTRL_4 (0x23)
+#ifndef L3G4200D_AUTO_RANGE_DOWN_HOLD
+#define L3G4200D_AUTO_RANGE_DOWN_HOLD (64)
+#endif
 
-/*! @brief The address of CTRL_REG5, which is used for enabling different kinds
- * of filtering.
- *
- * @see CTRL5.
+/*! @brief Set this to 1 to have L3G4200D_Unified count SPI traffic, range
+ * switches, and other events, and time L3G4200D_Unified::getEvent. See
+ * L3G4200D_Unified::getStats. When this is 0 (the default), none of the
+ * counting code is compiled in.
  */
-#define REG_CTRL_5 (0x24)
+#ifndef L3G4200D_STATS
+#define L3G4200D_STATS (0)
+#endif
 
-/*! @brief The address of OUT_X_L, which contains the low byte of the X-axis
- * angular data, as two's complement.
- */
-#define REG_OUT_X_L (0x28)
+/*! @brief The number of buckets in gyroStats_t::latencyHistogram. */
+#define L3G4200D_STATS_LATENCY_BUCKETS (8)
 
-/*! @brief The address of OUT_X_L, which contains the high byte of the X-axis
- * angular data, as two's complement.
+/*! @brief The number of new samples thrown away after the data rate,
+ * bandwidth, or filtering is changed, while the gyroscope's filters settle.
  */
-#define REG_OUT_X_H (0x29)
+#ifndef L3G4200D_SETTLING_SAMPLES
+#define L3G4200D_SETTLING_SAMPLES (5)
+#endif
 
-/*! @brief The address of OUT_X_H, which contains the low byte of the Y-axis
- * angular data, as two's complement.
+/*! @brief How long the gyroscope takes to give good samples after coming out
+ * of power-down, in microseconds. Coming out of sleep only takes
+ * @ref L3G4200D_SETTLING_SAMPLES samples.
  */
-#define REG_OUT_Y_L (0x2a)
+#ifndef L3G4200D_POWER_DOWN_TURN_ON_MICROS
+#define L3G4200D_POWER_DOWN_TURN_ON_MICROS (250000UL)
+#endif
 
-/*! @brief The address of OUT_Y_L, which contains the high byte of the Y-axis
- * angular data, as two's complement.
+/*! @brief The raw sample magnitude, in counts at the 4.36 rad/s range, that
+ * every axis must stay under (after bias correction) for the gyroscope to be
+ * considered still. The default is about 0.017 rad/s (1 deg/s).
  */
-#define REG_OUT_Y_H (0x2b)
+#ifndef L3G4200D_STILL_THRESHOLD
+#define L3G4200D_STILL_THRESHOLD (114)
+#endif
 
-/*! @brief The address of OUT_X_L, which contains the low byte of the Z-axis
- * angular data, as two's complement.
+/*! @brief The number of samples in a row that must be still before the online
+ * bias estimator starts refining the bias. See
+ * L3G4200D_Unified::enableOnlineCalibration.
  */
-#define REG_OUT_Z_L (0x2c)
+#ifndef L3G4200D_STILL_HOLD
+#define L3G4200D_STILL_HOLD (50)
+#endif
 
-/*! @brief The address of OUT_X_L, which contains the high byte of the Z-axis
- * angular data, as two's complement.
+/*! @brief How slowly the online bias estimator follows the samples. Each
+ * still sample moves the bias 1/2^N of the way towards it.
  */
-#define REG_OUT_Z_H (0x2d)
+#ifndef L3G4200D_ONLINE_CALIBRATION_SHIFT
+#define L3G4200D_ONLINE_CALIBRATION_SHIFT (8)
+#endif
 
-/*! @brief The chip ID constant value of [REG_WHO_AM_I](@ref REG_WHO_AM_I):
- * `0xd3`.
+/*! @brief The size of the blob written by
+ * L3G4200D_Unified::saveCalibration, in bytes. */
+#define L3G4200D_CALIBRATION_SIZE (15)
+
+/*! @brief The first byte of a calibration blob. This changes if the layout of
+ * the blob ever does. */
+#define L3G4200D_CALIBRATION_VERSION (0xc1)
+
+/*! @brief The value of 1 rad/s from L3G4200D_Unified::getEventFixed, which
+ * is Q16.16 rad/s. */
+#define L3G4200D_FIXED_ONE (65536L)
+/*! @private Extra bits of precision in the per-range Q16.16 scale. */
+#define L3G4200D_FIXED_SHIFT (8)
+
+/*! @brief The value of 1 rad/s from L3G4200D_Unified::getEventMilliRad. */
+#define L3G4200D_MILLIRAD_ONE (1000L)
+/*! @private Extra bits of precision in the per-range milliradian scale. */
+#define L3G4200D_MILLIRAD_SHIFT (16)
+
+/*! @private Half of each range, in rad/s, which is what a sample of
+ * INT16_MAX counts is. Both L3G4200D_Unified and L3G4200D scale samples from
+ * these, so they always agree. */
+#define L3G4200D_HALF_RANGE_4_DOT_36 (4.36 / 2)
+/*! @private See @ref L3G4200D_HALF_RANGE_4_DOT_36. */
+#define L3G4200D_HALF_RANGE_8_DOT_73 (8.73 / 2)
+/*! @private See @ref L3G4200D_HALF_RANGE_4_DOT_36. */
+#define L3G4200D_HALF_RANGE_34_DOT_91 (34.91 / 2)
+
+/*! @private An integer scale for a range, worked out at compile time from
+ * its half-range so no floating point is needed at run time. A sample
+ * multiplied by it and shifted right by @p shift is in units of 1/@p one
+ * rad/s. */
+#define L3G4200D_SCALE(halfRangeRadians, one, shift)                           \
+  ((int32_t)((halfRangeRadians) * (one) * (1L << (shift)) / INT16_MAX + 0.5))
+
+/*! @private The Q16.16 scale for a range. */
+#define L3G4200D_FIXED_SCALE(halfRangeRadians)                                 \
+  L3G4200D_SCALE(halfRangeRadians, L3G4200D_FIXED_ONE, L3G4200D_FIXED_SHIFT)
+
+/*! @private The milliradian scale for a range. */
+#define L3G4200D_MILLIRAD_SCALE(halfRangeRadians)                              \
+  L3G4200D_SCALE(halfRangeRadians, L3G4200D_MILLIRAD_ONE,                      \
+                 L3G4200D_MILLIRAD_SHIFT)
+
+/*! @defgroup sensor Sensor
  *
- * This should be the only value ever read from @ref REG_WHO_AM_I.
- * If you get a different value, your wires may not be connected correctly.
+ * @brief This contains the types used for typical operation of this L3G4200D
+ * sensor.
  */
-#define L3G4200D_CHIP_ID (0xd3)
 
 /*!
- * @}
+ * @ingroup sensor
+ * @{
  */
 
 /*!
- * @addtogroup CTRL1
- * @ingroup registers
- *
- * @brief Values for @ref REG_CTRL_1, which is used for bandwidth, data rate,
- * and power selection.
- *
- * @{
+ * @brief One raw sample of all three axes, as two's complement fractions of
+ * the full scale of the range the sample was taken at.
  */
+typedef struct rawGyroSample {
+  int16_t x; /*!< The raw X-axis sample. */
+  int16_t y; /*!< The raw Y-axis sample. */
+  int16_t z; /*!< The raw Z-axis sample. */
+} gyroSample_t;
 
-/*! @name Output data rate and filtering
- * @anchor rate_filtering
- *
- * These values of @ref REG_CTRL_1 set the output data rate and the "low-pass"
- * filtering bandwidth. The low-pass filtering is for "smoothing out" changes
- * that occur too quickly to be useful.
- *
- * These values can be or'd with other `CTRL1_` values when writing to
- * @ref REG_CTRL_1.
+/*!
+ * @brief Optional sensititity settings. If not specified in
+ * L3G4200D_Unified::begin, defaults to ::GYRO_RANGE_4_DOT_36_RAD_PER_SEC.
  *
- * @{
+ * Using a higher range lowers the resolution of the sensor, and using a lower
+ * range increases the resolution of the sensor.
  */
+typedef enum {
+  /*! A range of 4.36 rad/s, or 250 deg/s. */
+  GYRO_RANGE_4_DOT_36_RAD_PER_SEC = CTRL4_FULL_SCALE_250DPS,
 
-// Bits 7:6 set the output data rate, and bits 5:4 set the "low-pass" filtering
-// bandwidth.
-
-/*! @brief REG_CTRL_1 value for a 100 Hz data rate and a 12.5 Hz cutoff. */
-#define CTRL1_RATE_100HZ_CUTOFF_12HZ5 (0b0000 << 4)
-
-/*! @brief REG_CTRL_1 value for a 100 Hz data rate and a 25 Hz cutoff. */
-#define CTRL1_RATE_100HZ_CUTOFF_25HZ (0b0001 << 4)
-
-/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 12.5 Hz cutoff. */
-#define CTRL1_RATE_200HZ_CUTOFF_12HZ5 (0b0100 << 4)
-
-/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 25 Hz cutoff. */
-#define CTRL1_RATE_200HZ_CUTOFF_25HZ (0b0101 << 4)
-
-/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 50 Hz cutoff. */
-#define CTRL1_RATE_200HZ_CUTOFF_50HZ (0b0110 << 4)
-
-/*! @brief REG_CTRL_1 value for a 200 Hz data rate and a 70 Hz cutoff. */
-#define CTRL1_RATE_200HZ_CUTOFF_70HZ (0b0111 << 4)
-
-/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 20 Hz cutoff. */
-#define CTRL1_RATE_400HZ_CUTOFF_20HZ (0b1000 << 4)
-
-/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 2 Hz cutoff. */
-#define CTRL1_RATE_400HZ_CUTOFF_25HZ (0b1001 << 4)
-
-/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 50 Hz cutoff. */
-#define CTRL1_RATE_400HZ_CUTOFF_50HZ (0b1010 << 4)
-
-/*! @brief REG_CTRL_1 value for a 400 Hz data rate and a 110 Hz cutoff. */
-#define CTRL1_RATE_400HZ_CUTOFF_110HZ (0b1011 << 4)
+  /*! A range of 8.73 rad/s, or 500 deg/s. */
+  GYRO_RANGE_8_DOT_73_RAD_PER_SEC = CTRL4_FULL_SCALE_500DPS,
 
-/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 30 Hz cutoff. */
-#define CTRL1_RATE_800HZ_CUTOFF_30HZ (0b1100 << 4)
+  /*! A range of 34.91 rad/s, or 2000 deg/s. */
+  GYRO_RANGE_34_DOT_91_RAD_PER_SEC = CTRL4_FULL_SCALE_2000DPS,
+} gyroRange_t;
 
-/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 35 Hz cutoff. */
-#define CTRL1_RATE_800HZ_CUTOFF_35HZ (0b1101 << 4)
+/*!
+ * @brief Output data rates for L3G4200D_Unified::setDataRate. Faster rates
+ * allow faster motion to be tracked but use more power.
+ */
+typedef enum {
+  /*! 100 samples per second. */
+  GYRO_DATA_RATE_100HZ = CTRL1_RATE_100HZ_CUTOFF_12HZ5,
 
-/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 50 Hz cutoff. */
-#define CTRL1_RATE_800HZ_CUTOFF_50HZ (0b1110 << 4)
+  /*! 200 samples per second. */
+  GYRO_DATA_RATE_200HZ = CTRL1_RATE_200HZ_CUTOFF_12HZ5,
 
-/*! @brief REG_CTRL_1 value for a 800 Hz data rate and a 110 Hz cutoff. */
-#define CTRL1_RATE_800HZ_CUTOFF_110HZ (0b1111 << 4)
+  /*! 400 samples per second. This is the default. */
+  GYRO_DATA_RATE_400HZ = CTRL1_RATE_400HZ_CUTOFF_20HZ,
 
-/*! @} */ // End member group rate_filtering.
+  /*! 800 samples per second. */
+  GYRO_DATA_RATE_800HZ = CTRL1_RATE_800HZ_CUTOFF_30HZ,
+} gyroDataRate_t;
 
-/*! @name Power and axes settings
- * @anchor power_axes
- *
- * These values of @ref REG_CTRL_1 set the power mode of the chip as a whole
- * and for each of the X, Y, and Z axes.
- * Turning off unncesseary axes saves power.
+/*!
+ * @brief Low-pass filter cutoffs for L3G4200D_Unified::setDataRate.
  *
- * These values can be or'd with other `CTRL1_` values when writing to
- * @ref REG_CTRL_1
+ * What each cutoff works out to depends on the data rate:
  *
- * @{
+ * | Bandwidth                    | 100 Hz  | 200 Hz  | 400 Hz | 800 Hz |
+ * | ---------------------------- | ------- | ------- | ------ | ------ |
+ * | ::GYRO_BANDWIDTH_NARROWEST   | 12.5 Hz | 12.5 Hz | 20 Hz  | 30 Hz  |
+ * | ::GYRO_BANDWIDTH_NARROW      | 25 Hz   | 25 Hz   | 25 Hz  | 35 Hz  |
+ * | ::GYRO_BANDWIDTH_WIDE        | 25 Hz   | 50 Hz   | 50 Hz  | 50 Hz  |
+ * | ::GYRO_BANDWIDTH_WIDEST      | 25 Hz   | 70 Hz   | 110 Hz | 110 Hz |
  */
+typedef enum {
+  /*! The lowest cutoff for the data rate. */
+  GYRO_BANDWIDTH_NARROWEST = (0b00 << 4),
 
-// Bit 3 sets the power mode for the chip as a whole.
-// Bit 2 enables or disables the Z-axis.
-// Bit 1 enables or disables the Y-axis.
-// Bit 0 enables or disables the X-axis.
+  /*! The second lowest cutoff for the data rate. */
+  GYRO_BANDWIDTH_NARROW = (0b01 << 4),
 
-/*! @brief REG_CTRL_1 value to power down the gyroscope. */
-#define CTRL1_POWER_DOWN (0b0000 << 0)
+  /*! The second highest cutoff for the data rate. */
+  GYRO_BANDWIDTH_WIDE = (0b10 << 4),
 
-/*! @brief REG_CTRL_1 value to put the gyroscope in sleep mode - on, but with no
- * gyroscope axes enabled.
- */
-#define CTRL1_SLEEP (0b1000 << 0)
+  /*! The highest cutoff for the data rate. */
+  GYRO_BANDWIDTH_WIDEST = (0b11 << 4),
 
-/*! @brief REG_CTRL_1 value to enable the X-axis only. */
-#define CTRL1_X_ONLY (0b1001 << 0)
+  /*! Let L3G4200D_Unified::setDataRate pick the highest cutoff that is no
+   * more than a quarter of the data rate, which keeps noise down without
+   * lagging behind the motion. */
+  GYRO_BANDWIDTH_AUTO = 0xff,
+} gyroBandwidth_t;
 
-/*! @brief REG_CTRL_1 value to enable the Y-axis only. */
-#define CTRL1_Y_ONLY (0b1010 << 0)
+/*!
+ * @brief Which axes to measure, for L3G4200D_Unified::setEnabledAxes. Axes
+ * that aren't enabled don't use any power, always read as 0, and are left
+ * out of reads where possible.
+ */
+typedef enum {
+  /*! Only the X-axis. */
+  GYRO_AXES_X = CTRL1_X_ONLY,
 
-/*! @brief REG_CTRL_1 value to enable the Z-axis only. */
-#define CTRL1_Z_ONLY (0b1100 << 0)
+  /*! Only the Y-axis. */
+  GYRO_AXES_Y = CTRL1_Y_ONLY,
 
-/*! @brief REG_CTRL_1 value to enable the X and Y axes only. */
-#define CTRL1_XY (0b1011 << 0)
+  /*! Only the Z-axis. */
+  GYRO_AXES_Z = CTRL1_Z_ONLY,
 
-/*! @brief REG_CTRL_1 value to enable the Y and Z axes only. */
-#define CTRL1_YZ (0b1110 << 0)
+  /*! The X and Y axes. */
+  GYRO_AXES_XY = CTRL1_XY,
 
-/*! @brief REG_CTRL_1 value to enable the X and Z axes only. */
-#define CTRL1_XZ (0b1101 << 0)
+  /*! The X and Z axes. */
+  GYRO_AXES_XZ = CTRL1_XZ,
 
-/*! @brief REG_CTRL_1 value to enable all axes. This is probably what you want.
- */
-#define CTRL1_XYZ (0b1111 << 0)
+  /*! The Y and Z axes. */
+  GYRO_AXES_YZ = CTRL1_YZ,
 
-/*! @} */ // End member group power_axes.
-/*! @} */ // End group CTRL1.
+  /*! All three axes. This is the default. */
+  GYRO_AXES_XYZ = CTRL1_XYZ,
+} gyroAxes_t;
 
 /*!
- * @addtogroup CTRL2
- * @ingroup registers
- *
- * @brief Values for @ref REG_CTRL_2, which is used for configuring the
- * high pass filter.
+ * @brief FIFO modes for L3G4200D_Unified::enableFifo.
  *
- * @{
+ * @see FIFO_CTRL
  */
+typedef enum {
+  /*! Only the newest sample is kept. This is the default. */
+  GYRO_FIFO_BYPASS = FIFO_CTRL_MODE_BYPASS,
 
-/*! @name High pass filter setting
- * @anchor high_pass_divisor
- *
- * @brief Values for @ref REG_CTRL_2 that control the high pass filter.
- *
- * The high pass filter rejects movements that are too slow to be useful.
- * The value used for filtering is expressed as a fraction of the clock rate.
- * To figure out the filter frequency, divide the output data rate by the
- * number at the end of these constants.
- *
- * For example, if you want to detect gestures, you might not be interested
- * in various slow movements (which wouldn't be part of a sharp gesture).
- * If your data rate were 200 Hz, and you don't care about gestures that happen
- * over less than 1 second, then you might want HIGH_PASS_DIV_200,
- * since 200 Hz / 200 = 1 Hz.
- *
- * @{
- */
+  /*! Collect samples until the FIFO is full, then stop until it is read. */
+  GYRO_FIFO_ONE_SHOT = FIFO_CTRL_MODE_FIFO,
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 12.
- */
-#define CTRL2_HIGH_PASS_DIV_12 (0b0000 << 0)
+  /*! Keep collecting samples, discarding the oldest when the FIFO is full.
+   * This is probably what you want for continuous capture.
+   */
+  GYRO_FIFO_STREAM = FIFO_CTRL_MODE_STREAM,
+} gyroFifoMode_t;
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 25.
+/*!
+ * @brief Gyroscope data in fixed point, for boards without a floating point
+ * unit.
+ *
+ * From L3G4200D_Unified::getEventFixed, each value is Q16.16 rad/s, so divide
+ * by @ref L3G4200D_FIXED_ONE to get rad/s. From
+ * L3G4200D_Unified::getEventMilliRad, each value is in milliradians per
+ * second.
  */
-#define CTRL2_HIGH_PASS_DIV_25 (0b0001 << 0)
+typedef struct {
+  int32_t x; /*!< X-axis angular rate. */
+  int32_t y; /*!< Y-axis angular rate. */
+  int32_t z; /*!< Z-axis angular rate. */
+} gyroFixedEvent_t;
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 50.
+/*!
+ * @brief Power modes for L3G4200D_Unified::powerMode and
+ * L3G4200D_Unified::enableDutyCycle.
  */
-#define CTRL2_HIGH_PASS_DIV_50 (0b0010 << 0)
+typedef enum {
+  /*! Measuring the enabled axes. */
+  GYRO_POWER_NORMAL,
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 100.
- */
-#define CTRL2_HIGH_PASS_DIV_100 (0b0011 << 0)
+  /*! Sleep: no axes are measured, but the gyroscope wakes up again quickly.
+   * See @ref CTRL1_SLEEP. */
+  GYRO_POWER_SLEEP,
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 200.
- */
-#define CTRL2_HIGH_PASS_DIV_200 (0b0100 << 0)
+  /*! Power-down: the lowest power mode, but it takes
+   * @ref L3G4200D_POWER_DOWN_TURN_ON_MICROS to wake up from. See
+   * @ref CTRL1_POWER_DOWN. */
+  GYRO_POWER_DOWN,
+} gyroPowerMode_t;
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by 500.
+/*!
+ * @brief How the high pass filter is reset, for
+ * L3G4200D_Unified::setHighPassFilter.
  */
-#define CTRL2_HIGH_PASS_DIV_500 (0b0101 << 0)
-
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
- * 1000. */
-#define CTRL2_HIGH_PASS_DIV_1000 (0b0110 << 0)
-
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
- * 2000. */
-#define CTRL2_HIGH_PASS_DIV_2000 (0b0111 << 0)
+typedef enum {
+  /*! Normal mode, reset by L3G4200D_Unified::resetHighPassFilter. This is
+   * the default. */
+  GYRO_HIGH_PASS_NORMAL_RESET = CTRL2_HIGH_PASS_MODE_NORMAL_RESET,
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
- * 5000. */
-#define CTRL2_HIGH_PASS_DIV_5000 (0b1000 << 0)
+  /*! Filter relative to the value set with
+   * L3G4200D_Unified::setHighPassReference. */
+  GYRO_HIGH_PASS_REFERENCE = CTRL2_HIGH_PASS_MODE_REFERENCE,
 
-/*! @brief REG_CTRL_2 value for filtering based on the data rate divided by
- * 10000. */
-#define CTRL2_HIGH_PASS_DIV_10000 (0b1001 << 0)
+  /*! Normal mode. */
+  GYRO_HIGH_PASS_NORMAL = CTRL2_HIGH_PASS_MODE_NORMAL,
 
-/*! @} */ // End member group high_pass_divisor
-/*! @} */ // End group CTRL2
+  /*! Reset automatically on an interrupt event. */
+  GYRO_HIGH_PASS_AUTORESET = CTRL2_HIGH_PASS_MODE_AUTORESET,
+} gyroHighPassMode_t;
 
 /*!
- * @addtogroup CTRL3
- * @ingroup registers
+ * @brief High pass filter cutoffs, as roughly the output data rate divided
+ * by the number at the end, for L3G4200D_Unified::setHighPassFilter.
  *
- * @brief Values for @ref REG_CTRL_3, which is used for configuring the
- * electrical characteristics of the pins on the chip.
+ * What each cutoff works out to, from the datasheet, depends on the data
+ * rate:
  *
- * @{
- */
-
-/*! @brief REG_CTRL_3 value to indicate that the gyro chip should drive output
- * pins HIGH and LOW, instead of using a pull-up resistor for logic HIGH.
- */
-#define CTRL3_DRIVE_HIGH_AND_LOW (0b0 << 4)
-
-/*! @brief REG_CTRL_3 value to indicate that the gyro chip should not drive
- * output pins HIGH, and instead use a pull-up resistor for logic HIGH.
+ * | Divisor                      | 100 Hz  | 200 Hz  | 400 Hz  | 800 Hz  |
+ * | ---------------------------- | ------- | ------- | ------- | ------- |
+ * | ::GYRO_HIGH_PASS_DIV_12      | 8 Hz    | 15 Hz   | 30 Hz   | 56 Hz   |
+ * | ::GYRO_HIGH_PASS_DIV_25      | 4 Hz    | 8 Hz    | 15 Hz   | 30 Hz   |
+ * | ::GYRO_HIGH_PASS_DIV_50      | 2 Hz    | 4 Hz    | 8 Hz    | 15 Hz   |
+ * | ::GYRO_HIGH_PASS_DIV_100     | 1 Hz    | 2 Hz    | 4 Hz    | 8 Hz    |
+ * | ::GYRO_HIGH_PASS_DIV_200     | 0.5 Hz  | 1 Hz    | 2 Hz    | 4 Hz    |
+ * | ::GYRO_HIGH_PASS_DIV_500     | 0.2 Hz  | 0.5 Hz  | 1 Hz    | 2 Hz    |
+ * | ::GYRO_HIGH_PASS_DIV_1000    | 0.1 Hz  | 0.2 Hz  | 0.5 Hz  | 1 Hz    |
+ * | ::GYRO_HIGH_PASS_DIV_2000    | 0.05 Hz | 0.1 Hz  | 0.2 Hz  | 0.5 Hz  |
+ * | ::GYRO_HIGH_PASS_DIV_5000    | 0.02 Hz | 0.05 Hz | 0.1 Hz  | 0.2 Hz  |
+ * | ::GYRO_HIGH_PASS_DIV_10000   | 0.01 Hz | 0.02 Hz | 0.05 Hz | 0.1 Hz  |
+ *
+ * @see high_pass_divisor
  */
-#define CTRL3_USE_PULL_UP_FOR_HIGH (0b1 << 4)
-
-/*! @} */ // End group CTRL3.
+typedef enum {
+  GYRO_HIGH_PASS_DIV_12 = CTRL2_HIGH_PASS_DIV_12,       /*!< ODR / 12. */
+  GYRO_HIGH_PASS_DIV_25 = CTRL2_HIGH_PASS_DIV_25,       /*!< ODR / 25. */
+  GYRO_HIGH_PASS_DIV_50 = CTRL2_HIGH_PASS_DIV_50,       /*!< ODR / 50. */
+  GYRO_HIGH_PASS_DIV_100 = CTRL2_HIGH_PASS_DIV_100,     /*!< ODR / 100. */
+  GYRO_HIGH_PASS_DIV_200 = CTRL2_HIGH_PASS_DIV_200,     /*!< ODR / 200. */
+  GYRO_HIGH_PASS_DIV_500 = CTRL2_HIGH_PASS_DIV_500,     /*!< ODR / 500. */
+  GYRO_HIGH_PASS_DIV_1000 = CTRL2_HIGH_PASS_DIV_1000,   /*!< ODR / 1000. */
+  GYRO_HIGH_PASS_DIV_2000 = CTRL2_HIGH_PASS_DIV_2000,   /*!< ODR / 2000. */
+  GYRO_HIGH_PASS_DIV_5000 = CTRL2_HIGH_PASS_DIV_5000,   /*!< ODR / 5000. */
+  GYRO_HIGH_PASS_DIV_10000 = CTRL2_HIGH_PASS_DIV_10000, /*!< ODR / 10000. */
+} gyroHighPassDivisor_t;
 
 /*!
- * @addtogroup CTRL4
- * @ingroup registers
+ * @brief Which filters the samples go through before they reach the output
+ * registers and the FIFO, for L3G4200D_Unified::setFilterPath.
  *
- * @brief Values for @ref REG_CTRL_4, which is used for setting the gyroscope
- * range.
- *
- * @{
+ * Every sample goes through the first low pass filter, which is set by the
+ * bandwidth in L3G4200D_Unified::setDataRate. After that it can go through
+ * the high pass filter, set with L3G4200D_Unified::setHighPassFilter, and a
+ * second low pass filter, whose cutoff is also set by the bandwidth.
  */
+typedef enum {
+  /*! Only the first low pass filter. This is the default. */
+  GYRO_FILTER_PATH_LPF1 = CTRL5_NO_FILTERING,
 
-/*! @name Output register configuration
- * @anchor out_reg_config
- *
- * These values of @ref REG_CTRL_4 control how the X, Y, and Z axis output
- * registers contain and update their values.
- *
- * These values can be or'd with other `CTRL_4` values when writing to
- * @ref REG_CTRL_4.
- *
- * @{
- */
+  /*! The first low pass filter, then the high pass filter. */
+  GYRO_FILTER_PATH_HPF = CTRL5_HIGH_PASS_FILTERING,
 
-/*! @brief REG_CTRL_4 value to indicate that the high byte and low byte of each
- * output register should not update when we've read one but not the other.
- */
-#define CTRL4_UPDATE_MSB_AND_LSB_TOGETHER (0b1 << 7)
+  /*! Both low pass filters. */
+  GYRO_FILTER_PATH_LPF2 = CTRL5_LOW_PASS_FILTERING,
 
-/*! @brief REG_CTRL_4 value to indicate that the low byte of each output
- * register is at the lower address (as is displayed in the datasheet).
- */
-#define CTRL4_LSB_AT_LOWER_ADDRESS (0b0 << 6)
+  /*! The first low pass filter, the high pass filter, then the second low
+   * pass filter. */
+  GYRO_FILTER_PATH_HPF_LPF2 = CTRL5_BAND_PASS_FILTERING,
+} gyroFilterPath_t;
 
-/*! @brief REG_CTRL_4 value to indicate that the high byte of each output
- * register is at the higher address.
+/*!
+ * @brief A whole gyroscope configuration, for L3G4200D_Unified::reconfigure.
+ *
+ * Get the current configuration with L3G4200D_Unified::getConfig, change
+ * what you need, and pass it to L3G4200D_Unified::reconfigure.
  */
-#define CTRL4_MSB_AT_LOWER_ADDRESS (0b1 << 6)
+typedef struct {
+  /*! The range. */
+  gyroRange_t range;
 
-/*! @} */ // End member group out_reg_config.
+  /*! The output data rate. */
+  gyroDataRate_t dataRate;
 
-/*! @name Gyro range settings
- * @anchor gyro_range
- *
- * These values of @ref REG_CTRL_4 control the current range of the gyroscope
- *
- * These values can be or'd with other `CTRL4_` values when writing to
- * @ref REG_CTRL_4
- *
- * @see ::gyroRange_t
- *
- * @{
- */
+  /*! The low-pass cutoff for @ref dataRate. */
+  gyroBandwidth_t bandwidth;
 
-/*! @brief REG_CTRL_4 value for a gyroscope range of 250 deg/s. Corresponds to
- * ::GYRO_RANGE_4_DOT_36_RAD_PER_SEC (4.36 rad/s).
- */
-#define CTRL4_FULL_SCALE_250DPS (0b00 << 4)
+  /*! Which axes to measure. */
+  gyroAxes_t axes;
 
-/*! @brief REG_CTRL_4 value for a gyroscope range of 500 deg/s. Corresponds to
- * ::GYRO_RANGE_8_DOT_73_RAD_PER_SEC (8.73 rad/s).
- */
-#define CTRL4_FULL_SCALE_500DPS (0b01 << 4)
+  /*! One of the ::gyroHighPassMode_t values. */
+  gyroHighPassMode_t highPassMode;
 
-/*! @brief REG_CTRL_4 value for a gyroscope range of 2000 deg/s. Corresponds to
- * ::GYRO_RANGE_34_DOT_91_RAD_PER_SEC (34.91 rad/s).
- */
-#define CTRL4_FULL_SCALE_2000DPS (0b10 << 4)
+  /*! One of the ::gyroHighPassDivisor_t values, or equivalently one of the
+   * [CTRL2_HIGH_PASS_DIV_](@ref high_pass_divisor) values. */
+  uint8_t highPassDivisor;
 
-/*! @} */ // End member group gyro_range.
+  /*! One of the ::gyroFilterPath_t values, or equivalently one of the
+   * `CTRL5_` filtering values, like @ref CTRL5_NO_FILTERING. */
+  uint8_t filtering;
 
-/*! @} */ // End group CTRL4.
+  /*! Whether block data update is enabled. See
+   * L3G4200D_Unified::setBlockDataUpdate. */
+  bool blockDataUpdate;
+} gyroConfig_t;
+
+class L3G4200D_Telemetry;
 
 /*!
- * @addtogroup CTRL5
- * @ingroup registers
- *
- * @brief Values for @ref REG_CTRL_5, which is used for enabling different
- * kinds of filtering.
+ * @brief Counters and timings collected when @ref L3G4200D_STATS is enabled.
+ * See L3G4200D_Unified::getStats.
  *
- * @{
+ * Counts made from L3G4200D_Unified::handleInterrupt can occasionally be
+ * lost if they happen while the main loop is counting the same thing.
  */
+typedef struct {
+  /*! The number of SPI transactions started. */
+  uint32_t spiTransactions;
 
-/*! @brief REG_CTRL_5 value to disable both the low pass and high pass filter.
- */
-#define CTRL5_NO_FILTERING ((0b00 << 0) | (0b0 << 4))
+  /*! The number of times Chip Select was asserted. A transaction for a
+   * L3G4200D_BusGroup asserts several, and reading the FIFO asserts two. */
+  uint32_t chipSelects;
 
-/*! @brief REG_CTRL_5 value to enable the high pass filter only. */
-#define CTRL5_HIGH_PASS_FILTERING ((0b01 << 0) | (0b0 << 4))
+  /*! The number of bytes sent over SPI, including command bytes. */
+  uint32_t spiBytes;
 
-/*! @brief REG_CTRL_5 value to enable the low pass filter only. */
-#define CTRL5_LOW_PASS_FILTERING ((0b10 << 0) | (0b0 << 4))
+  /*! The number of times auto-ranging changed the range. */
+  uint32_t rangeSwitches;
 
-/*! @brief REG_CTRL_5 value to enable both the band pass filter (both high pass
- * and low pass).
- */
-#define CTRL5_BAND_PASS_FILTERING ((0b10 << 0) | (0b1 << 4))
+  /*! The number of samples that were at the limit of their range. */
+  uint32_t saturatedSamples;
 
-// End group CTRL5.
-/*!
- * @}
- */
+  /*! The number of times the hardware FIFO was found full. */
+  uint32_t fifoOverruns;
 
-// End group registers.
-/*!
- * @}
- */
+  /*! The number of samples dropped because the interrupt capture buffer was
+   * full. */
+  uint32_t captureOverruns;
 
-/*! @private */
-typedef struct rawGyroSample {
-  int16_t x; /*!< @private */
-  int16_t y; /*!< @private */
-  int16_t z; /*!< @private */
-} gyroSample_t;
+  /*! The number of direct reads that got a sample that had already been
+   * read, meaning the sensor was read faster than its output data rate. */
+  uint32_t staleSamples;
+
+  /*! The number of direct reads that found samples had been overwritten
+   * without being read, meaning the sensor was read slower than its output
+   * data rate. */
+  uint32_t sampleOverruns;
+
+  /*! How long successful L3G4200D_Unified::getEvent calls took. Bucket 0
+   * counts calls under 32 microseconds, bucket 1 under 64, and so on,
+   * doubling each time, with the last bucket counting everything longer. */
+  uint32_t latencyHistogram[L3G4200D_STATS_LATENCY_BUCKETS];
+} gyroStats_t;
 
 /*!
- * @ingroup sensor
- * @{
+ * @brief A function to be called when a read started with
+ * L3G4200D_Unified::startRead completes.
+ *
+ * The first argument is the sample that was read, and the second argument is
+ * the context pointer that was passed to L3G4200D_Unified::startRead.
  */
+typedef void (*gyroReadCallback_t)(const gyroSample_t &sample, void *context);
 
 /*!
- * @brief Optional sensititity settings. If not specified in
- * L3G4200D_Unified::begin, defaults to ::GYRO_RANGE_4_DOT_36_RAD_PER_SEC.
+ * @brief Decides when to change range, for L3G4200D_Unified::enableAutoRange.
  *
- * Using a higher range lowers the resolution of the sensor, and using a lower
- * range increases the resolution of the sensor.
+ * Give it every sample, in order, and it returns the range the next sample
+ * should be taken at. See L3G4200D_Unified::enableAutoRange for how it
+ * decides.
  */
-typedef enum {
-  /*! A range of 4.36 rad/s, or 250 deg/s. */
-  GYRO_RANGE_4_DOT_36_RAD_PER_SEC = CTRL4_FULL_SCALE_250DPS,
+class L3G4200D_AutoRange {
 
-  /*! A range of 8.73 rad/s, or 500 deg/s. */
-  GYRO_RANGE_8_DOT_73_RAD_PER_SEC = CTRL4_FULL_SCALE_500DPS,
+public:
+  /*! @brief Create a new auto-ranger with no samples seen yet. */
+  L3G4200D_AutoRange();
 
-  /*! A range of 34.91 rad/s, or 2000 deg/s. */
-  GYRO_RANGE_34_DOT_91_RAD_PER_SEC = CTRL4_FULL_SCALE_2000DPS,
-} gyroRange_t;
+  /*! @brief Forgets all the samples seen so far. */
+  void reset();
+
+  /*! @brief Looks at the next sample and decides what range to use.
+   *
+   * @param sample The raw sample.
+   * @param range The range @p sample was taken at.
+   * @param saturated Whether @p sample was saturated.
+   *
+   * @returns The range to take the next sample at, which is @p range if it
+   * shouldn't change.
+   */
+  gyroRange_t update(const gyroSample_t &sample, gyroRange_t range,
+                     bool saturated);
+
+private:
+  bool _havePrevious;
+  gyroSample_t _previous;
+  uint16_t _quietSamples;
+};
 
 /*!
  * @brief Class for interfacing with an L3G4200D gyroscope, using the Adafruit
@@ -543,6 +611,12 @@ typedef enum {
  */
 class L3G4200D_Unified : public Adafruit_Sensor {
 
+  // Reads several gyroscopes within one SPI transaction.
+  friend class L3G4200D_BusGroup;
+
+  // The compile-time configured driver, which shares some helpers.
+  template <typename Config, typename Transport> friend class L3G4200D;
+
 public:
   /*! @brief Create a new object representing an @htmlonly L3G4200D @endhtmlonly
    * gyroscope.
@@ -556,6 +630,10 @@ public:
   // Default to the global default SPI connector, which is often brought out
   // and labeled as labeled SPI connectors on Arduino boards.
   /*! @brief Initializes this L3G4200D gyroscope using SPI.
+   *
+   * Calling this again starts over with the default settings, turning off
+   * the FIFO, interrupt-driven capture, and duty cycling. Detach the
+   * interrupt handler first.
    *
    * @param spiChipSelect
    * @parblock
@@ -596,16 +674,28 @@ public:
              gyroRange_t range = GYRO_RANGE_4_DOT_36_RAD_PER_SEC,
              SPIClass &spi = SPI, uint32_t spiFrequency = 5L * 1000L * 1000L);
 
-  /*! @brief Enables automatic range increasing if the sensor seems to be
-   * saturating its current range.
+  /*! @brief Enables automatic range changing.
    *
-   * The range will not automatically decrease after being increased.
+   * Each sample from @ref getEvent or @ref getEventFixed is checked after it
+   * is converted, and the range is increased if the next sample looks likely
+   * to saturate the current range, judging by how large the sample is and how
+   * fast it is changing. Once samples have stayed small enough for the next
+   * lower range for @ref L3G4200D_AUTO_RANGE_DOWN_HOLD samples, the range is
+   * decreased again to get back the resolution.
+   *
+   * Samples are never re-read after a range change. If a sample did saturate,
+   * @ref lastSampleSaturated returns true for it. Samples still waiting in the
+   * FIFO or the capture buffer were taken at the old range, so they are
+   * thrown away when the range changes.
    *
    * @param enabled Set to true to enable auto range, false to disable it.
    */
   void enableAutoRange(bool enabled);
 
   /*! @brief Enables or disables debug logging to the Serial console.
+   *
+   * This does nothing if the library was built with
+   * @ref L3G4200D_DEBUG_LOGGING set to 0.
    *
    * @param enabled Set to true to enable debug logging, false to disable it.
    */
@@ -631,11 +721,150 @@ public:
    *     Serial.print(", ");
    *     Serial.println(event.gyro.z);
    *
+   * If interrupt-driven capture is enabled with
+   * @ref enableDataReadyInterrupt, this takes the oldest captured sample
+   * instead of reading the sensor.
+   *
    * @returns True if this sensor was successfully read from, false if it was
-   * not.
+   * not, or if interrupt-driven capture is enabled and no new sample has been
+   * captured yet.
    */
   bool getEvent(sensors_event_t *event);
 
+  /*! @brief Like @ref getEvent, but returns right away without converting
+   * anything if the sensor hasn't produced a new sample since the last read.
+   *
+   * This lets you call it as often as you like without re-processing the
+   * same sample. Use @ref lastSampleOverrun to check whether samples were
+   * missed because it wasn't called often enough.
+   *
+   * @param event [out] A pointer to a sensors_event_t object for this method to
+   * populate with the X, Y, and Z gyro data.
+   *
+   * @returns True if @p event was populated with a new sample, false if there
+   * was no new sample or the sensor could not be read from.
+   */
+  bool getEventIfNew(sensors_event_t *event);
+
+  /*! @brief Like @ref getEvent, but only reads and converts the axes in
+   * @p Axes.
+   *
+   * Only the output registers from the first to the last axis in @p Axes are
+   * read, in one burst, so reading just the Z-axis is 2 bytes instead of 7.
+   * Which registers to read and which axes to convert is worked out at
+   * compile time. STATUS_REG isn't read, so @ref lastSampleNew and
+   * @ref lastSampleOverrun aren't updated.
+   *
+   * Enable the same axes with @ref setEnabledAxes first. Axes not in @p Axes
+   * are left untouched in @p event.
+   *
+   * @code{.cpp}
+   * gyro.setEnabledAxes(GYRO_AXES_Z);
+   * gyro.getEventAxes<GYRO_AXES_Z>(&event);
+   * Serial.println(event.gyro.z);
+   * @endcode
+   *
+   * @tparam Axes One of the ::gyroAxes_t values.
+   * @param event [out] A pointer to a sensors_event_t object for this method to
+   * populate with the gyro data for @p Axes.
+   *
+   * @returns True if this sensor was successfully read from, false if it was
+   * not.
+   */
+  template <gyroAxes_t Axes> bool getEventAxes(sensors_event_t *event);
+
+  /*! @brief Like @ref getEvent, but gets the X, Y, and Z gyro data as
+   * integers, without using any floating point math.
+   *
+   * This is much faster than @ref getEvent on boards without a floating point
+   * unit, like AVR and Cortex-M0 boards.
+   *
+   * @param event [out] A pointer to a ::gyroFixedEvent_t for this method to
+   * populate with the X, Y, and Z gyro data, in Q16.16 rad/s.
+   *
+   * @returns True if this sensor was successfully read from, false if it was
+   * not.
+   */
+  bool getEventFixed(gyroFixedEvent_t *event);
+
+  /*! @brief Like @ref getEventFixed, but in whole milliradians per second,
+   * which is easier to print or send on and still fine enough for every
+   * range.
+   *
+   * @param event [out] A pointer to a ::gyroFixedEvent_t for this method to
+   * populate with the X, Y, and Z gyro data, in mrad/s.
+   *
+   * @returns True if this sensor was successfully read from, false if it was
+   * not.
+   */
+  bool getEventMilliRad(gyroFixedEvent_t *event);
+
+  /*! @brief Returns whether the last sample from @ref getEvent or
+   * @ref getEventFixed was at (or very near) the limit of the range it was
+   * taken at, meaning the real angular rate may have been even higher.
+   * @returns True if the last sample was saturated.
+   */
+  bool lastSampleSaturated();
+
+  /*! @brief Returns whether the last sample read directly from the sensor
+   * was new, rather than one that had already been read.
+   * @returns True if the last sample was new.
+   */
+  bool lastSampleNew();
+
+  /*! @brief Returns whether any samples were overwritten without being read
+   * before the last sample read directly from the sensor.
+   * @returns True if samples were missed.
+   */
+  bool lastSampleOverrun();
+
+  /*! @brief Returns the time the last sample from @ref getEvent,
+   * @ref getEventFixed, or @ref getEvents was taken at.
+   *
+   * Rather than the time the sample happened to be read at, this is worked
+   * out from its place in the stream of samples and the measured data rate
+   * (see L3G4200D_SampleClock), so it doesn't jitter with your loop, the
+   * FIFO, or the capture buffer. The `timestamp` of each event is the same
+   * time, in milliseconds.
+   *
+   * @returns The `micros()` time the last sample was taken at.
+   */
+  uint32_t lastTimestampMicros();
+
+  /*! @brief Returns the gyroscope's real sample period, as measured against
+   * `micros()`. This drifts a little from the nominal data rate with the
+   * gyroscope's oscillator.
+   * @returns The time between samples, in microseconds.
+   */
+  float measuredSamplePeriod();
+
+  /*! @brief Records a binary telemetry frame for every sample read with
+   * @ref getEvent, @ref getEventFixed, or @ref getEvents.
+   *
+   * Unlike @ref enableDebugLogging, this never waits on the serial port, so it
+   * can be left on at full sample rates. Call L3G4200D_Telemetry::flush
+   * regularly to write the frames out. See @ref telemetry.
+   *
+   * @param telemetry The telemetry buffer to record frames into, or NULL to
+   * stop recording. It can be shared between several gyroscopes.
+   */
+  void setTelemetry(L3G4200D_Telemetry *telemetry);
+
+  /*! @brief Gets the counters and timings collected since @ref begin or the
+   * last call to @ref resetStats.
+   *
+   * These are only collected when the library is built with
+   * @ref L3G4200D_STATS set to 1 (for example with a `-DL3G4200D_STATS=1`
+   * build flag). Otherwise everything is 0.
+   *
+   * @param stats [out] A pointer to a ::gyroStats_t to populate.
+   */
+  void getStats(gyroStats_t *stats);
+
+  /*! @brief Sets all the counters and timings from @ref getStats back to 0.
+   */
+  void resetStats();
+
   /*! @brief The Unified Sensor API method to get information about this sensor.
    * @param sensor [out] A pointer to a sensor_t object for this method to
    * populate with information about this sensor.
@@ -643,19 +872,398 @@ public:
   void getSensor(sensor_t *sensor);
 
   /*! @brief Sets the range for this gyroscope.
+   *
+   * Changing the range throws away any samples waiting in the FIFO or the
+   * capture buffer, since they were taken at the old range.
+   *
    * @param range One of the values of gyroRange_t to set as the new range
    * for this gyroscope.
    */
   void setRange(gyroRange_t range);
 
+  /*! @brief Gets the current configuration.
+   *
+   * This is remembered by this object, so it does not use the SPI bus.
+   *
+   * @param config [out] A pointer to a ::gyroConfig_t to populate.
+   */
+  void getConfig(gyroConfig_t *config);
+
+  /*! @brief Changes to a whole new configuration at once.
+   *
+   * Only the control registers that actually change are written, in a single
+   * auto-increment burst, so switching between profiles is one short SPI
+   * transaction. Nothing is written if nothing changed.
+   *
+   * If the data rate, bandwidth, high pass filter, or filter path change, the
+   * next @ref L3G4200D_SETTLING_SAMPLES new samples are thrown away while the
+   * filters settle, and @ref getEvent returns false for them.
+   *
+   * @param config The new configuration.
+   */
+  void reconfigure(const gyroConfig_t &config);
+
+  /*! @brief Sets the output data rate and low-pass cutoff frequency.
+   *
+   * @param rate One of the ::gyroDataRate_t values.
+   * @param bandwidth One of the ::gyroBandwidth_t values. Defaults to
+   * ::GYRO_BANDWIDTH_AUTO, which picks a cutoff that suits @p rate.
+   */
+  void setDataRate(gyroDataRate_t rate,
+                   gyroBandwidth_t bandwidth = GYRO_BANDWIDTH_AUTO);
+
+  /*! @brief Sets which axes are measured.
+   *
+   * Reads start at STATUS_REG and stop at the last enabled axis, so with only
+   * the X-axis, or only the X and Y axes, enabled, each read is shorter.
+   *
+   * @param axes One of the ::gyroAxes_t values.
+   */
+  void setEnabledAxes(gyroAxes_t axes);
+
+  /*! @brief Sets the output data rate and low-pass cutoff frequency.
+   * @param rateAndCutoff One of the [CTRL1_RATE_](@ref rate_filtering)
+   * values.
+   */
+  void setRateAndCutoff(uint8_t rateAndCutoff);
+
+  /*! @brief Sets the high pass filter cutoff, as a divisor of the output data
+   * rate. The high pass filter itself is enabled with @ref setFilterPath.
+   * @param divisor One of the [CTRL2_HIGH_PASS_DIV_](@ref high_pass_divisor)
+   * values.
+   */
+  void setHighPassDivisor(uint8_t divisor);
+
+  /*! @brief Sets up the high pass filter. It only affects samples if it's in
+   * the path set with @ref setFilterPath.
+   *
+   * @param mode One of the ::gyroHighPassMode_t values.
+   * @param divisor One of the ::gyroHighPassDivisor_t values. The cutoff is
+   * roughly the output data rate divided by this.
+   */
+  void setHighPassFilter(gyroHighPassMode_t mode,
+                         gyroHighPassDivisor_t divisor);
+
+  /*! @brief Sets the value the high pass filter works relative to in
+   * ::GYRO_HIGH_PASS_REFERENCE mode.
+   * @param reference The raw reference value.
+   */
+  void setHighPassReference(uint8_t reference);
+
+  /*! @brief Resets the high pass filter, in ::GYRO_HIGH_PASS_NORMAL_RESET
+   * mode, so it starts over from the current angular rate. */
+  void resetHighPassFilter();
+
+  /*! @brief Sets which of the gyroscope's filters samples go through. This
+   * applies to both the output registers and the FIFO.
+   *
+   * Filtering in the gyroscope means your board doesn't have to, for
+   * example, a high pass filter to remove slow drift, or the second low pass
+   * filter for anti-aliasing.
+   *
+   * @param path One of the ::gyroFilterPath_t values.
+   */
+  void setFilterPath(gyroFilterPath_t path);
+
+  /*! @brief Sets whether the high and low bytes of the output registers are
+   * kept from updating until both have been read. This is enabled by
+   * @ref begin.
+   * @param enabled Set to true to enable block data update, false to disable
+   * it.
+   */
+  void setBlockDataUpdate(bool enabled);
+
   /*! @brief Returns the full scale of the current range in the SI unit rad/s.
    * @returns The current range, in radians.
    */
   float rangeInRadians();
 
+  /*! @brief Measures the zero-rate bias of each axis, and from then on
+   * subtracts it from every sample before converting it.
+   *
+   * The gyroscope must be kept still while this runs. It waits for @p samples
+   * new samples, so it takes @p samples output data periods (half a second
+   * for 200 samples at 400 Hz), plus any still needed for the filters to
+   * settle after a change. Call it before enabling interrupt-driven capture,
+   * the FIFO, or duty cycling.
+   *
+   * The bias is measured at the current range and scaled to the others, so
+   * it only needs to be done once. Use @ref saveCalibration to keep it for
+   * the next boot.
+   *
+   * @param samples How many samples to average. Defaults to 200.
+   *
+   * @returns True if the bias was measured, false if the gyroscope moved
+   * (in which case the old bias is kept), could not be read from, or is
+   * using the FIFO, interrupt-driven capture, or duty cycling.
+   */
+  bool calibrate(uint16_t samples = 200);
+
+  /*! @brief Stops correcting for bias. */
+  void clearCalibration();
+
+  /*! @brief Writes the current bias calibration to @p blob, so it can be
+   * stored (in EEPROM, for example) and restored with @ref loadCalibration on
+   * the next boot.
+   *
+   * The blob is @ref L3G4200D_CALIBRATION_SIZE bytes, and is the same on
+   * every board.
+   *
+   * @param blob [out] Where to write the calibration.
+   * @param size The size of @p blob.
+   *
+   * @returns The number of bytes written, or 0 if @p blob is too small.
+   */
+  size_t saveCalibration(uint8_t *blob, size_t size);
+
+  /*! @brief Restores a bias calibration written by @ref saveCalibration.
+   *
+   * @param blob The calibration.
+   * @param size The size of @p blob.
+   * @param maxTemperatureChange The most the gyroscope's temperature may have
+   * changed since the calibration was measured, in degrees Celsius. The bias
+   * drifts with temperature, so this lets you calibrate again instead of
+   * using a stale bias. Defaults to 255, which always accepts it.
+   *
+   * @returns True if the calibration was restored, false if @p blob isn't a
+   * valid calibration or the temperature has changed too much.
+   */
+  bool loadCalibration(const uint8_t *blob, size_t size,
+                       uint8_t maxTemperatureChange = 255);
+
+  /*! @brief Enables or disables refining the bias in the background.
+   *
+   * While enabled, whenever the gyroscope has been still (see
+   * @ref L3G4200D_STILL_THRESHOLD) for @ref L3G4200D_STILL_HOLD samples in a
+   * row, each sample read from @ref getEvent, @ref getEventFixed, or
+   * @ref getEvents nudges the bias towards it, so the bias keeps up with
+   * temperature drift without stopping to @ref calibrate again.
+   *
+   * @param enabled Set to true to enable, false to disable.
+   */
+  void enableOnlineCalibration(bool enabled);
+
+  /*! @brief Reads the gyroscope's temperature sensor.
+   * @returns The temperature, as -1 per degree Celsius from an uncalibrated
+   * offset. Only useful for comparing against another reading.
+   */
+  int8_t readTemperature();
+
+  /*! @brief Puts the gyroscope in sleep mode, where it stops measuring but
+   * can wake up again quickly. Call @ref wake to start measuring again.
+   */
+  void sleep();
+
+  /*! @brief Powers the gyroscope down, which uses the least power but takes
+   * @ref L3G4200D_POWER_DOWN_TURN_ON_MICROS to wake up from. Call @ref wake to
+   * start measuring again. The configuration is kept.
+   */
+  void powerDown();
+
+  /*! @brief Wakes the gyroscope up from @ref sleep or @ref powerDown, with
+   * the same axes enabled as before.
+   *
+   * The samples taken while the gyroscope is turning on aren't accurate, so
+   * they are thrown away, and @ref getEvent returns false for them.
+   *
+   * @returns How long until the first good sample, in microseconds, or 0 if
+   * the gyroscope was already awake.
+   */
+  uint32_t wake();
+
+  /*! @brief Returns the current power mode.
+   * @returns One of the ::gyroPowerMode_t values.
+   */
+  gyroPowerMode_t powerMode();
+
+  /*! @brief Starts duty cycling: the gyroscope is kept in @p idleMode, and
+   * every @p periodMillis it is woken up, a burst of @p burstSamples samples
+   * is collected in the FIFO, and it goes back to @p idleMode.
+   *
+   * Call @ref serviceDutyCycle regularly, at least once per output data
+   * period while a burst is being collected, to drive this along. Don't use
+   * the other read methods while duty cycling.
+   *
+   * @param periodMillis The time from the start of one burst to the start of
+   * the next, in milliseconds.
+   * @param burstSamples The number of samples in each burst, up to
+   * @ref L3G4200D_FIFO_DEPTH.
+   * @param idleMode ::GYRO_POWER_SLEEP or ::GYRO_POWER_DOWN. Power-down uses
+   * less power between bursts, but takes longer to wake up from.
+   */
+  void enableDutyCycle(uint32_t periodMillis, uint8_t burstSamples,
+                       gyroPowerMode_t idleMode = GYRO_POWER_SLEEP);
+
+  /*! @brief Stops duty cycling, disables the FIFO, and wakes the gyroscope
+   * up. */
+  void disableDutyCycle();
+
+  /*! @brief Moves duty cycling along, returning the burst once it has been
+   * collected.
+   *
+   * @param buf [out] The array to store the burst's raw samples in.
+   * @param max The number of samples @p buf has room for.
+   *
+   * @returns The number of samples stored in @p buf, which is 0 except when
+   * a burst has just finished.
+   */
+  size_t serviceDutyCycle(gyroSample_t *buf, size_t max);
+
+  /*! @brief Enables the gyroscope's 32-sample hardware FIFO, so samples are
+   * kept even when you don't read them right away.
+   *
+   * Use @ref readFifo to read the samples that have been collected.
+   *
+   * @param mode One of the ::gyroFifoMode_t values. Defaults to
+   * ::GYRO_FIFO_STREAM.
+   * @param watermark The FIFO level (0 to 31) at which the watermark flag is
+   * set. Defaults to 0, which disables the watermark.
+   */
+  void enableFifo(gyroFifoMode_t mode = GYRO_FIFO_STREAM,
+                  uint8_t watermark = 0);
+
+  /*! @brief Disables the hardware FIFO, going back to only keeping the newest
+   * sample.
+   */
+  void disableFifo();
+
+  /*! @brief Reads all the samples that are waiting in the hardware FIFO, up to
+   * @p max.
+   *
+   * The FIFO level is read once, and then all of the pending samples are read
+   * in one auto-increment burst, which is much cheaper than reading them one
+   * at a time. Samples are in the order they were collected, oldest first.
+   *
+   * @param buf [out] The array to store the raw samples in.
+   * @param max The number of samples @p buf has room for. There is never more
+   * than @ref L3G4200D_FIFO_DEPTH samples in the FIFO.
+   *
+   * @returns The number of samples stored in @p buf.
+   */
+  size_t readFifo(gyroSample_t *buf, size_t max);
+
+  /*! @brief Enables interrupt-driven capture using the gyroscope's INT2/DRDY
+   * pin.
+   *
+   * The gyroscope signals on INT2/DRDY (when a new sample is ready, or when
+   * the FIFO reaches its watermark if @p useWatermark is set) and
+   * @ref handleInterrupt stores the new samples in a buffer that
+   * @ref getEvent and @ref readSamples take from, so the main loop never has
+   * to poll the sensor. You need to attach @ref handleInterrupt to the pin
+   * yourself, for example:
+   *
+   * @code{.cpp}
+   * gyro.begin(10);
+   * gyro.enableDataReadyInterrupt(digitalPinToInterrupt(2));
+   * attachInterrupt(digitalPinToInterrupt(2), [] { gyro.handleInterrupt(); },
+   *                 RISING);
+   * @endcode
+   *
+   * The interrupt handler uses the SPI bus, so it must never run while
+   * anything else is partway through using the bus, including this object
+   * from the main loop (for example to change the range or read the
+   * temperature). Where the core supports it, this calls
+   * `SPIClass::usingInterrupt()` with @p interruptNumber, which holds the
+   * interrupt off during every SPI transaction on the bus. Otherwise, this
+   * object puts off any interrupt that comes in while it is using the bus
+   * until it is done, but other devices on the bus must keep the interrupt
+   * off themselves while they use it.
+   *
+   * @param interruptNumber The interrupt @ref handleInterrupt is attached to,
+   * from `digitalPinToInterrupt()`.
+   * @param useWatermark Set to true to signal on the FIFO watermark instead of
+   * on every new sample. Use this together with @ref enableFifo.
+   */
+  void enableDataReadyInterrupt(int interruptNumber, bool useWatermark = false);
+
+  /*! @brief Disables interrupt-driven capture, going back to reading the
+   * sensor in @ref getEvent. Detach the interrupt handler after calling
+   * this. */
+  void disableDataReadyInterrupt();
+
+  /*! @brief Reads the newly available samples into the capture buffer. Call
+   * this from the interrupt handler attached to the INT2/DRDY pin.
+   *
+   * If the capture buffer is full, new samples are dropped. The samples are
+   * timestamped from the time this is called, however long they then wait
+   * in the buffer, so call it straight from the interrupt.
+   *
+   * @see enableDataReadyInterrupt
+   */
+  void handleInterrupt();
+
+  /*! @brief Reads up to @p max raw samples at once, oldest first.
+   *
+   * If interrupt-driven capture is enabled with
+   * @ref enableDataReadyInterrupt, the samples come from the capture buffer.
+   * Otherwise, if the FIFO is enabled with @ref enableFifo, the samples come
+   * from the FIFO. Otherwise one sample is read from the sensor, and only
+   * kept if it is new.
+   *
+   * @param buf [out] The array to store the raw samples in.
+   * @param max The number of samples @p buf has room for.
+   *
+   * @returns The number of new samples stored in @p buf.
+   */
+  size_t readSamples(gyroSample_t *buf, size_t max);
+
+  /*! @brief Like @ref getEvent, but gets all the samples that are available
+   * at once (from the capture buffer or the FIFO, like @ref readSamples), up
+   * to @p max.
+   *
+   * Each event is fully filled in, including its `timestamp`, which is the
+   * time the sample was taken at, like @ref lastTimestampMicros.
+   *
+   * If auto-ranging is enabled, the whole batch is converted at the range it
+   * was collected at, and then checked for whether the range should change.
+   *
+   * @param events [out] The array of events to populate.
+   * @param max The number of events @p events has room for.
+   *
+   * @returns The number of events populated.
+   */
+  size_t getEvents(sensors_event_t *events, size_t max);
+
+  /*! @brief Starts reading a sample without waiting for the read to finish,
+   * so your code can do other work while the SPI bus is busy.
+   *
+   * The whole read is sent as one buffer transfer. If @ref L3G4200D_ASYNC_SPI
+   * is defined, the transfer runs in the background (with DMA where your
+   * board supports it). Otherwise it is done right away, and the read is
+   * already complete when this returns.
+   *
+   * Call @ref pollReadComplete until it returns true to finish the read.
+   * While a background transfer is running, other methods of this object wait
+   * for it to finish before using the bus, and @ref handleInterrupt is put
+   * off until it has, but other devices on the same SPI bus mustn't be used
+   * until then.
+   *
+   * @param callback An optional function to call with the sample once the
+   * read completes. It is called from @ref pollReadComplete.
+   * @param context An optional pointer that is passed to @p callback.
+   *
+   * @returns True if the read was started, false if a previous read hasn't
+   * been completed with @ref pollReadComplete yet.
+   */
+  bool startRead(gyroReadCallback_t callback = NULL, void *context = NULL);
+
+  /*! @brief Checks whether a read started with @ref startRead has finished,
+   * and if it has, finishes it up.
+   *
+   * @param sample [out] An optional pointer to store the raw sample in once
+   * the read completes.
+   *
+   * @returns True if the read has completed (or if no read was in progress),
+   * false if the SPI bus is still busy.
+   */
+  bool pollReadComplete(gyroSample_t *sample = NULL);
+
   /*! @brief Advanced functionality: reads a raw value from a raw address.
    * See @ref registers for more information.
    *
+   * CTRL_REG1 through CTRL_REG5 are remembered by this object, so reading
+   * them does not use the SPI bus.
+   *
    * @param regAddress The address of the gyroscope register to read from.
    * One of the values of [register addresses](@ref reg_addresses).
    *
@@ -666,6 +1274,11 @@ public:
   /*! @brief Advanced functionality: writes a raw value to a raw address.
     See @ref registers for more information.
    *
+   * Writing CTRL_REG1 through CTRL_REG5 with the value they already have
+   * does not use the SPI bus. The range in CTRL_REG4, the FIFO enable bit in
+   * CTRL_REG5, and FIFO_CTRL_REG are picked up as if they had been set with
+   * @ref setRange, @ref enableFifo, or @ref disableFifo.
+   *
    * @param regAddress The address of the gyroscope register to read from.
    * One of the values of [register addresses](@ref reg_addresses).
    *
@@ -674,14 +1287,133 @@ public:
    */
   void rawWriteReg(uint8_t regAddress, uint8_t newValue);
 
+  /*! @brief Advanced functionality: reads several consecutive registers in
+   * one transaction, using the gyroscope's address auto-increment.
+   *
+   * @param startAddress The address of the first register to read from.
+   * One of the values of [register addresses](@ref reg_addresses).
+   * @param buf [out] The array to store the raw register values in.
+   * @param count The number of registers to read.
+   */
+  void rawReadRegs(uint8_t startAddress, uint8_t *buf, size_t count);
+
+  /*! @brief Advanced functionality: writes several consecutive registers in
+   * one transaction, using the gyroscope's address auto-increment.
+   *
+   * @param startAddress The address of the first register to write to.
+   * One of the values of [register addresses](@ref reg_addresses).
+   * @param values The raw values to write, starting with the value for
+   * @p startAddress.
+   * @param count The number of registers to write.
+   *
+   * @see rawWriteReg
+   */
+  void rawWriteRegs(uint8_t startAddress, const uint8_t *values, size_t count);
+
 private:
+  /*! @brief The most register bytes that spiReadRegs and spiWriteRegs send
+   * in a single buffer transfer along with the command byte. */
+  static const size_t SPI_FRAME_DATA_MAX = 16;
+
   SPIClass *_spi;
   int _spiCS;
   int32_t _sensorId;
   bool _autoRangeEnabled;
+  L3G4200D_AutoRange _autoRangeState;
+  bool _lastSampleSaturated;
+  uint8_t _lastStatus;
   gyroRange_t _range;
   SPISettings _spiSettings;
   bool _debugLoggingEnabled;
+  bool _fifoEnabled;
+  uint8_t _fifoCtrl;
+  volatile bool _interruptCaptureEnabled;
+  int _interruptNumber;
+
+  // A sample the interrupt handler read, with the micros() time the
+  // interrupt came in, and how many newer samples it read along with it
+  // from the FIFO.
+  struct capturedSample_t {
+    gyroSample_t sample;
+    uint32_t readMicros;
+    uint8_t newer;
+  };
+  L3G4200D_RingBuffer<capturedSample_t, L3G4200D_SAMPLE_RING_CAPACITY>
+      _sampleRing;
+
+  // When the newest sample taken from _sampleRing was taken, for the sample
+  // clock.
+  uint32_t _capturedMicros;
+
+  // How many SPI transactions we're inside of, and whether handleInterrupt()
+  // came in during one and has to be run when it ends, and when it came in.
+  volatile uint8_t _busDepth;
+  volatile bool _interruptPending;
+  volatile uint32_t _interruptMicros;
+
+  // One command byte plus six sample bytes.
+  uint8_t _asyncFrame[7];
+  bool _asyncReadBusy;
+  bool _asyncTransferOpen;
+  gyroReadCallback_t _asyncCallback;
+  void *_asyncContext;
+
+  // What we last wrote to CTRL_REG1 through CTRL_REG5, so we don't have to ask
+  // the gyroscope.
+  uint8_t _ctrlShadow[5];
+
+  // Works out when each sample was taken. See lastTimestampMicros().
+  L3G4200D_SampleClock _sampleClock;
+  uint32_t _lastTimestampMicros;
+
+  // Set when drainFifo() finds that samples were lost, which can be in the
+  // interrupt handler, so the main loop knows to reset _sampleClock.
+  volatile bool _samplesLost;
+
+  // How many more new samples to throw away while the filters settle, and
+  // whether the one in the output registers was thrown away.
+  volatile uint8_t _settlingSamples;
+  bool _heldSampleSettling;
+
+  // The zero-rate bias of each axis, in 1/256 counts at the 4.36 rad/s range
+  // (see biasShift()), and the temperature it was measured at.
+  int32_t _bias[3];
+  int8_t _biasTemperature;
+  bool _onlineCalibrationEnabled;
+  uint16_t _stillSamples;
+
+  // _bias in counts at the current range. Recalculated with the scale
+  // factors.
+  gyroSample_t _rangeBias;
+
+  // The CTRL_REG1 power and axes bits to go back to when woken up.
+  uint8_t _awakeAxes;
+
+  // Where duty cycling is up to. See serviceDutyCycle().
+  enum {
+    DUTY_CYCLE_OFF,
+    DUTY_CYCLE_IDLE,
+    DUTY_CYCLE_WARMING_UP,
+    DUTY_CYCLE_COLLECTING,
+  } _dutyCycleState;
+  gyroPowerMode_t _dutyCycleIdleMode;
+  uint32_t _dutyCyclePeriodMillis;
+  uint8_t _dutyCycleBurstSamples;
+  uint32_t _dutyCycleStartMillis;
+  uint32_t _dutyCyclePhaseMicros;
+  uint32_t _dutyCyclePhaseStartMicros;
+
+  // The current range's scale factors. See sampleToRad() and
+  // sampleToFixed().
+  float _radiansPerCount;
+  int32_t _fixedScale;
+  int32_t _milliRadScale;
+
+  L3G4200D_Telemetry *_telemetry;
+
+  // Always here, even when L3G4200D_STATS is 0, so the size of this class
+  // doesn't depend on the flags a sketch was built with.
+  gyroStats_t _stats;
 
   /*! @brief Reads the raw sample for the X-axis. */
   int16_t rawX();
@@ -692,16 +1424,66 @@ private:
   /*! @brief Reads the raw sample for the Z-axis. */
   int16_t rawZ();
 
-  /*! @brief Reads samples for the X, Y, and Z axes all at once as one
-   * transaction. */
+  /*! @brief Reads samples for the enabled axes all at once as one
+   * transaction, along with STATUS_REG, which is stored in _lastStatus.
+   * Disabled axes are 0. */
   rawGyroSample rawXYZ();
 
+  /*! @brief Reads the output registers of axes @p firstAxis through
+   * @p lastAxis (0 for X, 1 for Y, 2 for Z) in one transaction. The other
+   * axes are 0. */
+  gyroSample_t rawAxes(uint8_t firstAxis, uint8_t lastAxis);
+
+  /*! @brief Builds a sample from six bytes in OUT_X_L to OUT_Z_H order. */
+  static gyroSample_t sampleFromBytes(const uint8_t *bytes);
+
   /*! @brief Starts an Arduino SPI transaction, and asserts Chip Select. */
   void beginTransaction();
 
   /*! @brief De-asserts Chip Select, and ends the Arduino SPI transaction. */
   void endTransaction();
 
+  /*! @brief Starts an Arduino SPI transaction, without asserting Chip
+   * Select. */
+  void startSpiTransaction();
+
+  /*! @brief Ends an Arduino SPI transaction, without de-asserting Chip
+   * Select. */
+  void endSpiTransaction();
+
+  /*! @brief Marks the bus as in use, so handleInterrupt() is put off until
+   * releaseBus(), after letting a background read from startRead() finish.
+   * L3G4200D_BusGroup does this for every gyroscope in a group. */
+  void holdBus();
+
+  /*! @brief Undoes holdBus(), and then does what handleInterrupt() put off
+   * if it came in while the bus was in use. */
+  void releaseBus();
+
+  /*! @brief Reads the new samples into the capture buffer, for
+   * handleInterrupt(), noting that the interrupt for them came in at
+   * @p interruptMicros. */
+  void captureSamples(uint32_t interruptMicros);
+
+  /*! @brief Takes the oldest sample from the capture buffer, noting when it
+   * was taken for stampSamples().
+   * @returns False if the buffer is empty. */
+  bool popCaptured(gyroSample_t &sample);
+
+  /*! @brief Waits for the background transfer started by startRead() to
+   * finish, and ends its transaction. */
+  void finishAsyncTransfer();
+
+  /*! @brief Sets the INT2 interrupt bits in CTRL_REG3 and starts or stops
+   * interrupt-driven capture, starting from an empty capture buffer. */
+  void setDataReadyInterrupt(uint8_t interruptBits);
+
+  /*! @brief Asserts Chip Select, without starting an SPI transaction. */
+  void selectChip();
+
+  /*! @brief De-asserts Chip Select, without ending the SPI transaction. */
+  void deselectChip();
+
   /*! @brief Starts a transaction, reads a register, and ends the transaction.
    */
   uint8_t spiReadReg(uint8_t regAddress);
@@ -710,9 +1492,155 @@ private:
    * transaction. */
   void spiWriteReg(uint8_t regAddress, uint8_t value);
 
+  /*! @brief Starts a transaction, reads @p count consecutive registers with
+   * auto-increment, and ends the transaction. */
+  void spiReadRegs(uint8_t startAddress, uint8_t *buf, size_t count);
+
+  /*! @brief Like spiReadRegs, but only asserts and de-asserts Chip Select,
+   * for use inside an SPI transaction that has already been started. */
+  void frameReadRegs(uint8_t startAddress, uint8_t *buf, size_t count);
+
+  /*! @brief Like readFifo, but for use inside an SPI transaction that has
+   * already been started. */
+  size_t drainFifo(gyroSample_t *buf, size_t max);
+
+  /*! @brief Starts a transaction, writes @p count consecutive registers with
+   * auto-increment, and ends the transaction. */
+  void spiWriteRegs(uint8_t startAddress, const uint8_t *values, size_t count);
+
+  /*! @brief Returns true if @p regAddress is one of the control registers
+   * remembered in _ctrlShadow. */
+  static bool isShadowed(uint8_t regAddress);
+
+  /*! @brief Writes a control register, unless it already has @p value. */
+  void writeCtrlReg(uint8_t regAddress, uint8_t value);
+
+  /*! @brief Replaces the bits in @p mask of a control register with
+   * @p bits, writing it only if that changes its value. */
+  void updateCtrlReg(uint8_t regAddress, uint8_t mask, uint8_t bits);
+
+  /*! @brief Returns true if changing a control register from @p oldValue to
+   * @p newValue means the filters need to settle. */
+  static bool needsSettling(uint8_t regAddress, uint8_t oldValue,
+                            uint8_t newValue);
+
+  /*! @brief Throws away anything queued, and then at least the next
+   * @p samples new samples while the filters settle. Call it after
+   * _ctrlShadow has been updated. */
+  void startSettling(uint8_t samples);
+
+  /*! @brief Empties the FIFO and the capture buffer, and restarts the sample
+   * clock. */
+  void discardQueuedSamples();
+
+  /*! @brief Returns true if the sample just read from the output registers
+   * is from while the filters settle, counting it towards settling if it's
+   * @p fresh. */
+  bool isSettlingSample(bool fresh);
+
+  /*! @brief Throws away the samples at the start of @p buf that are needed
+   * for settling, and returns how many are left. */
+  size_t discardSettling(gyroSample_t *buf, size_t count);
+
+  /*! @brief Keeps this object's idea of the range and the FIFO in step with
+   * a raw write of @p value to @p regAddress. */
+  void followRawWrite(uint8_t regAddress, uint8_t value);
+
+  /*! @brief Subtracts the bias from the enabled axes of @p sample from
+   * @p firstAxis to @p lastAxis, after refining the bias with it if @p learn
+   * is set and online calibration is enabled. */
+  void correctBias(gyroSample_t &sample, bool learn, uint8_t firstAxis = 0,
+                   uint8_t lastAxis = 2);
+
+  /*! @brief Returns how far to shift a count at the current range left to
+   * get the 1/256 counts at the 4.36 rad/s range that _bias is kept in. */
+  uint8_t biasShift();
+
+  /*! @brief Recalculates _rangeBias. */
+  void updateRangeBias();
+
+  /*! @brief Puts the gyroscope in sleep or power-down, remembering which
+   * axes to enable when woken up. */
+  void enterPowerMode(uint8_t powerAxes);
+
+  /*! @brief Turns ::GYRO_BANDWIDTH_AUTO into a real cutoff for @p rate. */
+  static uint8_t resolveBandwidth(gyroDataRate_t rate,
+                                  gyroBandwidth_t bandwidth);
+
+  /*! @brief Implements @ref getEvent and @ref getEventIfNew. */
+  bool readEvent(sensors_event_t *event, bool onlyIfNew);
+
+  /*! @brief Implements @ref getEventFixed, or @ref getEventMilliRad if
+   * @p milliRad is set. */
+  bool readFixedEvent(gyroFixedEvent_t *event, bool milliRad);
+
+  /*! @brief Gets the next raw sample, from the sensor or from the interrupt
+   * capture buffer. If @p onlyIfNew is set, returns false if the sensor's
+   * sample has already been read. */
+  bool nextSample(gyroSample_t &sample, bool onlyIfNew = false);
+
+  /*! @brief Like nextSample, but only reads axes @p firstAxis through
+   * @p lastAxis from the sensor. See rawAxes. */
+  bool nextAxesSample(gyroSample_t &sample, uint8_t firstAxis,
+                      uint8_t lastAxis);
+
+  /*! @brief Checks a sample for saturation and records it, once it has been
+   * read. */
+  void finishSample(const gyroSample_t &sample);
+
+  /*! @brief Timestamps (if @p fresh), finishes, and bias-corrects @p count
+   * samples that have just been read for @ref getEvent or @ref getEvents.
+   * Samples that aren't fresh keep the timestamp they had.
+   * @returns The sample clock index of the first sample.
+   */
+  uint32_t finishSamples(gyroSample_t *samples, size_t count, bool fresh);
+
+  /*! @brief Returns the time between samples at the current output data
+   * rate, in microseconds. */
+  uint32_t samplePeriodMicros();
+
+  /*! @brief Gives @p count new samples that have just been read their place
+   * in the sample clock, returning the index of the oldest. The newest of
+   * them arrived now, or, from the capture buffer, when its interrupt came
+   * in. This is the only place the clock is reset after lost samples, so
+   * only call it from the main loop. */
+  uint32_t stampSamples(size_t count);
+
+  /*! @brief Converts a `micros()` timestamp to the `millis()` timestamp of an
+   * event, given the time now in both. */
+  static int32_t eventTimestamp(uint32_t timestampMicros, uint32_t nowMillis,
+                                uint32_t nowMicros);
+
+  /*! @brief Returns how many bytes rawXYZ reads, starting at STATUS_REG, to
+   * get every enabled axis. */
+  size_t axisBurstLength();
+
+  /*! @brief Returns true if any axis of @p sample is at the limit of its
+   * range. */
+  static bool isSaturated(const gyroSample_t &sample);
+
+  /*! @brief Adds a frame for @p sample to the telemetry buffer. */
+  void recordTelemetry(const gyroSample_t &sample, uint32_t timestampMicros);
+
+  /*! @brief Adds a getEvent duration to the latency histogram. */
+  void recordLatency(uint32_t durationMicros);
+
+  /*! @brief Changes the range if @p sample suggests we should. See
+   * @ref enableAutoRange. */
+  void autoRange(const gyroSample_t &sample);
+
   /*! @brief Converts a raw sample to the SI unit radians per second (rad/s). */
   float sampleToRad(int16_t fullScaleSample);
 
+  /*! @brief Converts a raw sample to fixed point with @p scale, one of the
+   * current range's integer scales, which has @p shift extra bits. See
+   * ::gyroFixedEvent_t. */
+  static int32_t sampleToFixed(int16_t fullScaleSample, int32_t scale,
+                               uint8_t shift);
+
+  /*! @brief Recalculates the scale factors for the current range. */
+  void updateScaleFactors();
+
   /*! @brief Logs if enabled with @ref enableDebugLogging, prepending the sensor
    * ID first. */
   void debugLog(const char str[]);
@@ -728,8 +1656,46 @@ private:
   /*! @brief Logs if enabled with @ref enableDebugLogging, without prepending
    * the sensor ID first. */
   void debugAppend(int val);
+
+  /*! @brief Logs a raw sample if enabled with @ref enableDebugLogging. */
+  void debugLogSample(const gyroSample_t &sample);
 };
 
+template <gyroAxes_t Axes>
+bool L3G4200D_Unified::getEventAxes(sensors_event_t *event) {
+  // The first and last axis in Axes, so we read the shortest burst that
+  // covers them. These are constants, so the compiler drops the conversions
+  // we don't need below.
+  const uint8_t firstAxis = (Axes & CTRL1_X_ENABLE)   ? 0
+                            : (Axes & CTRL1_Y_ENABLE) ? 1
+                                                      : 2;
+  const uint8_t lastAxis = (Axes & CTRL1_Z_ENABLE)   ? 2
+                           : (Axes & CTRL1_Y_ENABLE) ? 1
+                                                     : 0;
+
+  gyroSample_t sample;
+  if (!nextAxesSample(sample, firstAxis, lastAxis)) {
+    return false;
+  }
+
+  if (Axes & CTRL1_X_ENABLE) {
+    event->gyro.x = sampleToRad(sample.x);
+  }
+  if (Axes & CTRL1_Y_ENABLE) {
+    event->gyro.y = sampleToRad(sample.y);
+  }
+  if (Axes & CTRL1_Z_ENABLE) {
+    event->gyro.z = sampleToRad(sample.z);
+  }
+  event->timestamp = eventTimestamp(_lastTimestampMicros, millis(), micros());
+
+  if (_autoRangeEnabled) {
+    autoRange(sample);
+  }
+
+  return true;
+}
+
 /*! @} */ // End group sensor.
 
 #endif
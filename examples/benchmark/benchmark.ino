@@ -0,0 +1,291 @@
+#include <L3G4200D_U.h>
+#include <L3G4200D.h>
+#include <L3G4200D_I2C.h>
+
+/* Measures how long the different ways of reading the L3G4200D take on your
+   board, and prints the results to the serial console as JSON, one object
+   per line, so they can be saved and compared between driver versions or
+   boards.
+
+   Each line looks like:
+
+   {"path":"getEvent","iterations":1000,"total_us":412000,"ns_per_call":412000}
+
+   Build with L3G4200D_STATS set to 1 (for example with a -DL3G4200D_STATS=1
+   build flag) to also get how much bus traffic each path needs per call,
+   from L3G4200D_Unified::getStats():
+
+   {"path":"getEvent","iterations":1000,"total_us":412000,"ns_per_call":412000,"transactions_per_call":1,"chip_selects_per_call":1,"bytes_per_call":8}
+
+   and per sample for each transport of the compile-time configured driver:
+
+   {"path":"L3G4200D_I2C","samples":1000,"transactions_per_sample":1,"bytes_per_sample":9}
+
+   Connections
+   ===========
+   Connect board SCK to sensor SCK.
+   Connect board CIPO (MISO) to sensor CIPO (MISO).
+   Connect board COPI (MOSI) to sensor COPI (MOSI).
+   Connect board 3V3 to sensor Vdd_IO.
+   Connect board GND to sensor GND (or a common ground).
+   Connect any free board GPIO pin of your choosing to sensor CS (Chip Select).
+
+   This example uses pin 10 as the Chip Select pin.
+
+   The I2C transport is only measured if the sensor is wired for I2C instead:
+   connect board SCL to sensor SCL/SPC, board SDA to sensor SDA/SDI, and
+   sensor CS to 3V3.
+*/
+
+L3G4200D_Unified gyro = L3G4200D_Unified(2113);
+
+/* The same sensor through the compile-time configured driver, with the same
+   settings, to compare against getEvent and getEventFixed. */
+L3G4200D<> leanGyro;
+
+/* The same again, through the other transports. */
+L3G4200D<L3G4200D_DefaultConfig, L3G4200D_SoftwareSPI> softSpiGyro;
+L3G4200D<L3G4200D_DefaultConfig, L3G4200D_I2C<>> i2cGyro;
+
+/* How many times to run each path. More iterations give steadier numbers. */
+const uint32_t ITERATIONS = 1000;
+
+/*
+   Prints the timing part of a result.
+*/
+void printTiming(const char *path, uint32_t iterations, uint32_t totalMicros) {
+  Serial.print("{\"path\":\""); Serial.print(path);
+  Serial.print("\",\"iterations\":"); Serial.print(iterations);
+  Serial.print(",\"total_us\":"); Serial.print(totalMicros);
+  Serial.print(",\"ns_per_call\":"); Serial.print((uint32_t)((uint64_t)totalMicros * 1000 / iterations));
+}
+
+/*
+   Prints one result as a line of JSON.
+*/
+void printResult(const char *path, uint32_t iterations, uint32_t totalMicros) {
+  printTiming(path, iterations, totalMicros);
+  Serial.println("}");
+}
+
+/*
+   Prints one result of gyro as a line of JSON, along with the bus traffic it
+   took since the last gyro.resetStats(), if it was counted.
+*/
+void printUnifiedResult(const char *path, uint32_t iterations, uint32_t totalMicros) {
+  gyroStats_t stats;
+  gyro.getStats(&stats);
+
+  printTiming(path, iterations, totalMicros);
+  if (stats.spiTransactions != 0) {
+    Serial.print(",\"transactions_per_call\":"); Serial.print((float)stats.spiTransactions / iterations);
+    Serial.print(",\"chip_selects_per_call\":"); Serial.print((float)stats.chipSelects / iterations);
+    Serial.print(",\"bytes_per_call\":"); Serial.print((float)stats.spiBytes / iterations);
+  }
+  Serial.println("}");
+}
+
+/*
+   Prints the bus traffic a transport needed for some samples as a line of
+   JSON, if it was counted.
+*/
+void printTraffic(const char *path, uint32_t samples, const gyroTransportStats_t &stats) {
+  if (stats.transactions == 0) {
+    return;
+  }
+
+  Serial.print("{\"path\":\""); Serial.print(path);
+  Serial.print("\",\"samples\":"); Serial.print(samples);
+  Serial.print(",\"transactions_per_sample\":"); Serial.print((float)stats.transactions / samples);
+  Serial.print(",\"bytes_per_sample\":"); Serial.print((float)stats.bytes / samples);
+  Serial.println("}");
+}
+
+/*
+   Reads samples through one of the compile-time configured drivers, and
+   prints how long they took and how much bus traffic they needed.
+*/
+template <typename Gyro>
+void benchmarkTransport(const char *path, Gyro &lean) {
+  sensors_event_t event;
+  lean.transport().resetStats();
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    lean.getEvent(&event);
+  }
+  printResult(path, ITERATIONS, micros() - start);
+  printTraffic(path, ITERATIONS, lean.transport().stats());
+}
+
+void benchmarkGetEvent() {
+  sensors_event_t event;
+  gyro.resetStats();
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    gyro.getEvent(&event);
+  }
+  printUnifiedResult("getEvent", ITERATIONS, micros() - start);
+}
+
+void benchmarkGetEventFixed() {
+  gyroFixedEvent_t event;
+  gyro.resetStats();
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    gyro.getEventFixed(&event);
+  }
+  printUnifiedResult("getEventFixed", ITERATIONS, micros() - start);
+}
+
+/*
+   Reading only the Z-axis (yaw), which is a 2-byte burst instead of 7.
+*/
+void benchmarkGetEventZ() {
+  sensors_event_t event;
+  gyro.setEnabledAxes(GYRO_AXES_Z);
+  gyro.resetStats();
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    gyro.getEventAxes<GYRO_AXES_Z>(&event);
+  }
+  printUnifiedResult("getEventAxes<Z>", ITERATIONS, micros() - start);
+  gyro.setEnabledAxes(GYRO_AXES_XYZ);
+}
+
+/*
+   Reading the status and all three axes in one burst, which is what getEvent
+   (and the private rawXYZ) does.
+*/
+void benchmarkBurstRead() {
+  uint8_t bytes[7];
+  gyro.resetStats();
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    gyro.rawReadRegs(REG_STATUS, bytes, sizeof(bytes));
+  }
+  printUnifiedResult("rawReadRegs(STATUS,7)", ITERATIONS, micros() - start);
+}
+
+/*
+   Reading each axis separately, as the private rawX, rawY and rawZ would, to
+   show what the single burst saves.
+*/
+void benchmarkPerAxisReads() {
+  uint8_t bytes[2];
+  gyro.resetStats();
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    gyro.rawReadRegs(REG_OUT_X_L, bytes, sizeof(bytes));
+    gyro.rawReadRegs(REG_OUT_Y_L, bytes, sizeof(bytes));
+    gyro.rawReadRegs(REG_OUT_Z_L, bytes, sizeof(bytes));
+  }
+  printUnifiedResult("rawReadRegs(OUT_X/Y/Z_L,2)", ITERATIONS, micros() - start);
+}
+
+/*
+   Switching back and forth between two ranges, which is what auto-ranging
+   does in the worst case.
+*/
+void benchmarkSetRange() {
+  gyro.resetStats();
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    gyro.setRange((i & 1) ? GYRO_RANGE_8_DOT_73_RAD_PER_SEC : GYRO_RANGE_4_DOT_36_RAD_PER_SEC);
+  }
+  printUnifiedResult("setRange", ITERATIONS, micros() - start);
+  gyro.setRange(GYRO_RANGE_4_DOT_36_RAD_PER_SEC);
+}
+
+/*
+   Draining a full FIFO in one burst, per sample.
+*/
+void benchmarkFifoDrain() {
+  gyroSample_t samples[L3G4200D_FIFO_DEPTH];
+  uint32_t drained = 0;
+  uint32_t totalMicros = 0;
+
+  gyro.enableFifo(GYRO_FIFO_STREAM);
+  gyro.resetStats();
+  for (uint32_t i = 0; i < ITERATIONS / L3G4200D_FIFO_DEPTH; i++) {
+    /* Give the FIFO time to fill up at the default 400 Hz. */
+    delay(100);
+    uint32_t start = micros();
+    drained += gyro.readFifo(samples, L3G4200D_FIFO_DEPTH);
+    totalMicros += micros() - start;
+  }
+
+  if (drained > 0) {
+    printUnifiedResult("readFifo", drained, totalMicros);
+  }
+  gyro.disableFifo();
+}
+
+/*
+   The compile-time configured driver. This reconfigures the sensor with the
+   same settings as gyro.begin(), so run it last.
+*/
+void benchmarkTemplate() {
+  if (!leanGyro.begin(10)) {
+    return;
+  }
+
+  sensors_event_t event;
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    leanGyro.getEvent(&event);
+  }
+  printResult("L3G4200D<>::getEvent", ITERATIONS, micros() - start);
+
+  gyroFixedEvent_t fixedEvent;
+  start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    leanGyro.getEventFixed(&fixedEvent);
+  }
+  printResult("L3G4200D<>::getEventFixed", ITERATIONS, micros() - start);
+
+  benchmarkTransport("L3G4200D_HardwareSPI", leanGyro);
+}
+
+/*
+   The software SPI transport, bit-banged on the same pins, so the hardware
+   SPI peripheral has to let go of them first.
+*/
+void benchmarkSoftwareSPI() {
+  SPI.end();
+  if (softSpiGyro.begin(10, SCK, MOSI, MISO)) {
+    benchmarkTransport("L3G4200D_SoftwareSPI", softSpiGyro);
+  }
+}
+
+/*
+   The I2C transport at the default 400 kHz, if the sensor answers on I2C.
+*/
+void benchmarkI2C() {
+  if (i2cGyro.begin(Wire, L3G4200D_I2C_ADDRESS_SDO_HIGH)) {
+    benchmarkTransport("L3G4200D_I2C", i2cGyro);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  if (!gyro.begin(10)) {
+    /* Maybe it's wired for I2C. */
+    benchmarkI2C();
+    Serial.println("Ooops, no L3G4200D detected on SPI. Check your wiring or CS pin.");
+    while (1) { }
+  }
+
+  benchmarkGetEvent();
+  benchmarkGetEventFixed();
+  benchmarkGetEventZ();
+  benchmarkBurstRead();
+  benchmarkPerAxisReads();
+  benchmarkSetRange();
+  benchmarkFifoDrain();
+  benchmarkTemplate();
+  benchmarkSoftwareSPI();
+}
+
+void loop() {
+}
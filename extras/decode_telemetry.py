@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Decodes a binary L3G4200D telemetry stream (see L3G4200D_Telemetry.h).
+
+Reads the raw bytes captured from the serial port from a file (or stdin) and
+prints one line of CSV per frame. Bytes that don't form a valid frame are
+skipped, and gaps in the sequence number are reported on stderr.
+
+Example:
+
+    python3 decode_telemetry.py capture.bin > samples.csv
+"""
+
+import argparse
+import struct
+import sys
+
+FRAME_SIZE = 16
+SYNC = 0xA5
+FLAG_RANGE_MASK = 0b11
+FLAG_SATURATED = 0b1 << 2
+
+# Full scale in rad/s for each range code, matching
+# L3G4200D_Unified::rangeInRadians().
+RANGE_RADIANS = {
+    0b00: 4.36 / 2,
+    0b01: 8.73 / 2,
+    0b10: 34.91 / 2,
+}
+
+FRAME = struct.Struct("<BBHIhhhBB")
+
+
+def frames(data):
+    """Yields each valid frame in data as a tuple of its fields."""
+    i = 0
+    while i + FRAME_SIZE <= len(data):
+        if data[i] != SYNC:
+            i += 1
+            continue
+
+        raw = data[i : i + FRAME_SIZE]
+        check = 0
+        for byte in raw[:-1]:
+            check ^= byte
+
+        if check != raw[-1]:
+            # Not actually the start of a frame; resynchronize.
+            i += 1
+            continue
+
+        yield FRAME.unpack(raw)
+        i += FRAME_SIZE
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "capture",
+        nargs="?",
+        type=argparse.FileType("rb"),
+        default=sys.stdin.buffer,
+        help="raw capture file (default: stdin)",
+    )
+    parser.add_argument(
+        "--raw", action="store_true", help="print raw counts instead of rad/s"
+    )
+    args = parser.parse_args()
+
+    data = args.capture.read()
+
+    print("sensor_id,timestamp_us,x,y,z,range,saturated")
+
+    # The sequence number counts frames from one L3G4200D_Telemetry buffer,
+    # which may be shared by several sensors.
+    expected = None
+    for _, sequence, sensor_id, timestamp, x, y, z, flags, _ in frames(data):
+        if expected is not None and sequence != expected:
+            missing = (sequence - expected) % 256
+            print(
+                f"{missing} frame(s) dropped before t={timestamp}",
+                file=sys.stderr,
+            )
+        expected = (sequence + 1) % 256
+
+        range_code = flags & FLAG_RANGE_MASK
+        saturated = 1 if flags & FLAG_SATURATED else 0
+        full_scale = RANGE_RADIANS.get(range_code, RANGE_RADIANS[0])
+
+        if args.raw:
+            values = (x, y, z)
+        else:
+            values = tuple(f"{v * full_scale / 32767:.6f}" for v in (x, y, z))
+
+        print(
+            f"{sensor_id},{timestamp},{values[0]},{values[1]},{values[2]},"
+            f"{full_scale * 2:.2f},{saturated}"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,264 @@
+#include "L3G4200D_LinuxCapture.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// How many edge events to read from the GPIO line at once. Only the newest
+// one matters.
+#define EVENT_BATCH (16)
+
+L3G4200D_LinuxCapture::L3G4200D_LinuxCapture()
+    : _running(false), _droppedSamples(0), _fifoOverruns(0), _lastError(0) {
+  _gyro = NULL;
+  _watermark = 0;
+  _periodMicros = 0;
+  _savedCtrl3 = 0;
+  _savedCtrl5 = 0;
+  _savedFifoCtrl = 0;
+  _lineFd = -1;
+  _stopFd = -1;
+  _clockStarted = false;
+  _lastEdgeNanos = 0;
+}
+
+L3G4200D_LinuxCapture::~L3G4200D_LinuxCapture() { stop(); }
+
+bool L3G4200D_LinuxCapture::start(L3G4200D_Spidev &gyro, const char *gpioChip,
+                                  unsigned int line, uint8_t watermark) {
+  stop();
+
+  if (watermark < 1 || watermark >= L3G4200D_FIFO_DEPTH) {
+    errno = EINVAL;
+    return false;
+  }
+
+  _gyro = &gyro;
+  _watermark = watermark;
+  _periodMicros = _gyro->samplePeriodMicros();
+  if (_periodMicros == 0) {
+    return false;
+  }
+
+  if (!_gyro->readRegs(REG_CTRL_3, &_savedCtrl3, 1) ||
+      !_gyro->readRegs(REG_CTRL_5, &_savedCtrl5, 1) ||
+      !_gyro->readRegs(REG_FIFO_CTRL, &_savedFifoCtrl, 1)) {
+    return false;
+  }
+
+  // Ask for the edges before turning the interrupt on, so the first one
+  // isn't missed.
+  _stopFd = eventfd(0, EFD_CLOEXEC);
+  if (_stopFd < 0 || !requestLine(gpioChip, line)) {
+    closeFds();
+    return false;
+  }
+
+  // Start the FIFO from empty (going through bypass clears it), then stream
+  // into it with the watermark interrupt on INT2.
+  uint8_t bypass = FIFO_CTRL_MODE_BYPASS;
+  uint8_t ctrl3 = _savedCtrl3 | CTRL3_I2_WATERMARK;
+  uint8_t ctrl5 = _savedCtrl5 | CTRL5_FIFO_ENABLE;
+  uint8_t stream = FIFO_CTRL_MODE_STREAM | watermark;
+  if (!_gyro->writeRegs(REG_FIFO_CTRL, &bypass, 1) ||
+      !_gyro->writeRegs(REG_CTRL_3, &ctrl3, 1) ||
+      !_gyro->writeRegs(REG_CTRL_5, &ctrl5, 1) ||
+      !_gyro->writeRegs(REG_FIFO_CTRL, &stream, 1)) {
+    closeFds();
+    return false;
+  }
+
+  _sampleClock.reset(_periodMicros);
+  _clockStarted = false;
+  _lastError = 0;
+  _running = true;
+  _thread = std::thread(&L3G4200D_LinuxCapture::run, this);
+
+  return true;
+}
+
+void L3G4200D_LinuxCapture::stop() {
+  if (!_thread.joinable()) {
+    return;
+  }
+
+  // Wake the thread up to see that it should stop. Even if that fails, it
+  // checks _running after its next timeout.
+  _running = false;
+  uint64_t one = 1;
+  ssize_t written = write(_stopFd, &one, sizeof(one));
+  (void)written;
+  _thread.join();
+  closeFds();
+
+  uint8_t bypass = FIFO_CTRL_MODE_BYPASS;
+  _gyro->writeRegs(REG_FIFO_CTRL, &bypass, 1);
+  _gyro->writeRegs(REG_CTRL_3, &_savedCtrl3, 1);
+  _gyro->writeRegs(REG_CTRL_5, &_savedCtrl5, 1);
+  _gyro->writeRegs(REG_FIFO_CTRL, &_savedFifoCtrl, 1);
+}
+
+bool L3G4200D_LinuxCapture::running() const { return _running; }
+
+bool L3G4200D_LinuxCapture::pop(gyroLinuxSample_t &sample) {
+  return _queue.pop(sample);
+}
+
+size_t L3G4200D_LinuxCapture::available() const { return _queue.size(); }
+
+uint32_t L3G4200D_LinuxCapture::droppedSamples() const {
+  return _droppedSamples;
+}
+
+uint32_t L3G4200D_LinuxCapture::fifoOverruns() const { return _fifoOverruns; }
+
+int L3G4200D_LinuxCapture::lastError() const { return _lastError; }
+
+void L3G4200D_LinuxCapture::run() {
+  struct pollfd fds[2];
+  fds[0].fd = _lineFd;
+  fds[0].events = POLLIN;
+  fds[1].fd = _stopFd;
+  fds[1].events = POLLIN;
+
+  // If an edge is ever missed, INT2 could stay high with the FIFO full and
+  // never make another one. So if there's been no edge for a few watermarks'
+  // worth of samples, drain the FIFO anyway.
+  int timeoutMillis = (int)(4 * _watermark * _periodMicros / 1000) + 1;
+
+  while (_running) {
+    int ready = poll(fds, 2, timeoutMillis);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    if (fds[1].revents & POLLIN) {
+      return;
+    }
+
+    uint64_t edgeNanos = 0;
+    if (fds[0].revents & POLLIN) {
+      struct gpio_v2_line_event events[EVENT_BATCH];
+      ssize_t bytes = read(_lineFd, events, sizeof(events));
+      if (bytes < (ssize_t)sizeof(events[0])) {
+        break;
+      }
+      edgeNanos = events[bytes / sizeof(events[0]) - 1].timestamp_ns;
+    }
+
+    if (!drain(edgeNanos)) {
+      break;
+    }
+  }
+
+  if (_running) {
+    _lastError = errno;
+    _running = false;
+  }
+}
+
+bool L3G4200D_LinuxCapture::drain(uint64_t edgeNanos) {
+  gyroLinuxSample_t samples[L3G4200D_FIFO_DEPTH];
+
+  // The edge means the FIFO has just reached the watermark, so that many are
+  // certainly there, and the last of them arrived at the edge. After a
+  // timeout, we don't know anything until we've read FIFO_SRC_REG.
+  size_t count = (edgeNanos != 0) ? _watermark : 0;
+  bool atEdge = (edgeNanos != 0);
+
+  for (;;) {
+    uint8_t fifoSrc;
+    ssize_t got = _gyro->readFifo(samples, count, &fifoSrc);
+    if (got < 0) {
+      return false;
+    }
+
+    if (fifoSrc & FIFO_SRC_OVERRUN) {
+      // Samples were lost, so count from scratch again, and the edge (if
+      // any) doesn't line up with these samples.
+      _fifoOverruns++;
+      _sampleClock.reset(_periodMicros);
+      _clockStarted = false;
+      atEdge = false;
+    }
+
+    uint32_t first;
+    if (atEdge && (size_t)got == count) {
+      first = _sampleClock.observe((uint32_t)(edgeNanos / 1000), got);
+      _clockStarted = true;
+      _lastEdgeNanos = edgeNanos;
+    } else {
+      first = _sampleClock.advance(got);
+    }
+    atEdge = false;
+
+    uint32_t edgeMicros = (uint32_t)(_lastEdgeNanos / 1000);
+    for (ssize_t i = 0; i < got; i++) {
+      if (_clockStarted) {
+        uint32_t micros = _sampleClock.timestampMicros(first + i);
+        samples[i].timestampNanos =
+            _lastEdgeNanos + (int64_t)(int32_t)(micros - edgeMicros) * 1000;
+      }
+
+      if (!_queue.push(samples[i])) {
+        _droppedSamples++;
+      }
+    }
+
+    // Only read what FIFO_SRC_REG said was already there, so we never take
+    // a sample that arrives partway through a read. Whatever arrives during
+    // the reads is well under the watermark, so INT2 goes low again and the
+    // next edge comes when the watermark is reached.
+    size_t remaining = L3G4200D_Spidev::fifoLevel(fifoSrc) - got;
+    if (remaining == 0) {
+      return true;
+    }
+    count = remaining;
+  }
+}
+
+bool L3G4200D_LinuxCapture::requestLine(const char *gpioChip,
+                                        unsigned int line) {
+  int chipFd = open(gpioChip, O_RDWR | O_CLOEXEC);
+  if (chipFd < 0) {
+    return false;
+  }
+
+  struct gpio_v2_line_request request;
+  memset(&request, 0, sizeof(request));
+  request.offsets[0] = line;
+  request.num_lines = 1;
+  strncpy(request.consumer, "l3g4200d", sizeof(request.consumer) - 1);
+  request.config.flags =
+      GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING;
+
+  int result = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request);
+  int error = errno;
+  close(chipFd);
+  if (result < 0) {
+    errno = error;
+    return false;
+  }
+
+  _lineFd = request.fd;
+  return true;
+}
+
+void L3G4200D_LinuxCapture::closeFds() {
+  if (_lineFd >= 0) {
+    close(_lineFd);
+    _lineFd = -1;
+  }
+  if (_stopFd >= 0) {
+    close(_stopFd);
+    _stopFd = -1;
+  }
+}
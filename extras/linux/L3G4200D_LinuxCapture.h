@@ -0,0 +1,154 @@
+/*!
+ * @file L3G4200D_LinuxCapture.h
+ *
+ * Collecting L3G4200D samples on a background thread on Linux, woken by the
+ * gyroscope's interrupt pin through the GPIO character device.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_LINUX_CAPTURE_H
+#define L3G4200D_LINUX_CAPTURE_H
+
+#include <atomic>
+#include <thread>
+
+#include "L3G4200D_SampleClock.h"
+#include "L3G4200D_SpscQueue.h"
+#include "L3G4200D_Spidev.h"
+
+/*! @brief The number of samples buffered between the capture thread and
+ * L3G4200D_LinuxCapture::pop. Must be a power of two. At 800 Hz, the default
+ * is over a second of samples.
+ */
+#ifndef L3G4200D_LINUX_QUEUE_CAPACITY
+#define L3G4200D_LINUX_QUEUE_CAPACITY (1024)
+#endif
+
+/*!
+ * @brief Reads an L3G4200D_Spidev gyroscope on its own thread, and hands the
+ * samples over through a lock-free queue.
+ *
+ * The gyroscope's FIFO collects samples in stream mode, and its INT2 pin
+ * goes high when the FIFO reaches the watermark. The thread sleeps until the
+ * GPIO character device reports that edge, then drains the FIFO with one
+ * ioctl per read. Any thread can then take the samples with @ref pop, without
+ * blocking the capture thread.
+ *
+ * Each sample is timestamped from the kernel's timestamp of the edge, which
+ * marks exactly when the watermark sample arrived, smoothed over many edges
+ * with L3G4200D_SampleClock.
+ *
+ * @code{.cpp}
+ * L3G4200D_Spidev gyro;
+ * L3G4200D_LinuxCapture capture;
+ *
+ * gyro.begin("/dev/spidev0.0");
+ * capture.start(gyro, "/dev/gpiochip0", 17);
+ *
+ * gyroLinuxSample_t sample;
+ * while (capture.pop(sample)) {
+ *   // ...
+ * }
+ * @endcode
+ */
+class L3G4200D_LinuxCapture {
+
+public:
+  L3G4200D_LinuxCapture();
+  ~L3G4200D_LinuxCapture();
+
+  /*! @brief Sets up the FIFO and the interrupt, and starts the capture
+   * thread.
+   *
+   * Don't use @p gyro from any other thread until @ref stop.
+   *
+   * @param gyro The gyroscope to read, already set up with
+   * L3G4200D_Spidev::begin.
+   * @param gpioChip The GPIO chip the gyroscope's INT2 pin is connected to,
+   * such as `/dev/gpiochip0`.
+   * @param line The line offset of INT2 on @p gpioChip.
+   * @param watermark How many samples to collect in the FIFO before waking
+   * the thread, from 1 to 31. Fewer means lower latency, more means fewer
+   * wake-ups.
+   *
+   * @returns True if the thread was started. Otherwise, `errno` says why.
+   */
+  bool start(L3G4200D_Spidev &gyro, const char *gpioChip, unsigned int line,
+             uint8_t watermark = 16);
+
+  /*! @brief Stops the capture thread, and puts the FIFO and interrupt
+   * settings back the way they were. Samples already queued can still be
+   * popped. */
+  void stop();
+
+  /*! @brief Returns whether the capture thread is running. It stops by
+   * itself on errors; see @ref lastError. */
+  bool running() const;
+
+  /*! @brief Takes the oldest captured sample.
+   * @param sample [out] The sample taken.
+   * @returns True if there was a sample, false if none are waiting.
+   */
+  bool pop(gyroLinuxSample_t &sample);
+
+  /*! @brief Returns the number of captured samples waiting to be popped. */
+  size_t available() const;
+
+  /*! @brief Returns the number of samples thrown away because the queue was
+   * full, meaning @ref pop isn't being called often enough. */
+  uint32_t droppedSamples() const;
+
+  /*! @brief Returns the number of times the gyroscope's FIFO overflowed
+   * before the thread could drain it, losing samples. */
+  uint32_t fifoOverruns() const;
+
+  /*! @brief Returns the `errno` that stopped the capture thread, or 0. */
+  int lastError() const;
+
+private:
+  L3G4200D_Spidev *_gyro;
+  uint8_t _watermark;
+  uint32_t _periodMicros;
+
+  // CTRL_REG3, CTRL_REG5, and FIFO_CTRL_REG from before start(), to put back.
+  uint8_t _savedCtrl3;
+  uint8_t _savedCtrl5;
+  uint8_t _savedFifoCtrl;
+
+  int _lineFd;
+  int _stopFd;
+  std::thread _thread;
+  std::atomic<bool> _running;
+
+  L3G4200D_SpscQueue<gyroLinuxSample_t, L3G4200D_LINUX_QUEUE_CAPACITY> _queue;
+  std::atomic<uint32_t> _droppedSamples;
+  std::atomic<uint32_t> _fifoOverruns;
+  std::atomic<int> _lastError;
+
+  // Only touched by the capture thread. _sampleClock works in 32-bit
+  // microseconds, so its times are turned back into nanoseconds relative to
+  // the last edge. It can't timestamp anything until it has seen an edge
+  // since it was last reset.
+  L3G4200D_SampleClock _sampleClock;
+  bool _clockStarted;
+  uint64_t _lastEdgeNanos;
+
+  /*! @brief The capture thread. */
+  void run();
+
+  /*! @brief Drains the FIFO after an edge at @p edgeNanos, or after a
+   * timeout if @p edgeNanos is 0. */
+  bool drain(uint64_t edgeNanos);
+
+  /*! @brief Requests @p line of @p gpioChip as a rising-edge event source. */
+  bool requestLine(const char *gpioChip, unsigned int line);
+
+  /*! @brief Closes the GPIO line and the stop event. */
+  void closeFds();
+
+  L3G4200D_LinuxCapture(const L3G4200D_LinuxCapture &);
+  L3G4200D_LinuxCapture &operator=(const L3G4200D_LinuxCapture &);
+};
+
+#endif
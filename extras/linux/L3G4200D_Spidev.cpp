@@ -0,0 +1,191 @@
+#include "L3G4200D_Spidev.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/spi/spidev.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// What L3G4200D_Unified::begin writes to CTRL_REG1 through CTRL_REG5, at the
+// 250 dps range.
+static const uint8_t DEFAULT_CTRL[5] = {
+    L3G4200D_DEFAULT_CTRL1, L3G4200D_DEFAULT_CTRL2, L3G4200D_DEFAULT_CTRL3,
+    L3G4200D_DEFAULT_CTRL4 | CTRL4_FULL_SCALE_250DPS, L3G4200D_DEFAULT_CTRL5};
+
+// One command byte plus a whole FIFO of samples.
+#define FRAME_MAX (1 + 6 * L3G4200D_FIFO_DEPTH)
+
+L3G4200D_Spidev::L3G4200D_Spidev() {
+  _fd = -1;
+  _speedHz = 0;
+}
+
+L3G4200D_Spidev::~L3G4200D_Spidev() { end(); }
+
+bool L3G4200D_Spidev::begin(const char *device, uint32_t speedHz) {
+  end();
+
+  _fd = open(device, O_RDWR | O_CLOEXEC);
+  if (_fd < 0) {
+    return false;
+  }
+  _speedHz = speedHz;
+
+  uint8_t mode = SPI_MODE_3;
+  uint8_t bits = 8;
+  if (ioctl(_fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+      ioctl(_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+      ioctl(_fd, SPI_IOC_WR_MAX_SPEED_HZ, &_speedHz) < 0) {
+    end();
+    return false;
+  }
+
+  uint8_t chipId;
+  if (!readRegs(REG_WHO_AM_I, &chipId, 1)) {
+    end();
+    return false;
+  }
+  if (chipId != L3G4200D_CHIP_ID) {
+    end();
+    errno = ENODEV;
+    return false;
+  }
+
+  if (!writeRegs(REG_CTRL_1, DEFAULT_CTRL, sizeof(DEFAULT_CTRL))) {
+    end();
+    return false;
+  }
+
+  return true;
+}
+
+void L3G4200D_Spidev::end() {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+bool L3G4200D_Spidev::readRegs(uint8_t startAddress, uint8_t *buf,
+                               size_t count) {
+  if (count + 1 > FRAME_MAX) {
+    errno = EINVAL;
+    return false;
+  }
+
+  // Same command as L3G4200D_Unified::frameReadRegs(). The response to the
+  // command byte is garbage.
+  uint8_t tx[FRAME_MAX];
+  uint8_t rx[FRAME_MAX];
+  memset(tx, 0, count + 1);
+  tx[0] = startAddress | 0x80 | (count > 1 ? 0x40 : 0);
+
+  struct spi_ioc_transfer xfer;
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.tx_buf = (uintptr_t)tx;
+  xfer.rx_buf = (uintptr_t)rx;
+  xfer.len = count + 1;
+  xfer.speed_hz = _speedHz;
+  xfer.bits_per_word = 8;
+
+  if (ioctl(_fd, SPI_IOC_MESSAGE(1), &xfer) < 0) {
+    return false;
+  }
+
+  memcpy(buf, &rx[1], count);
+  return true;
+}
+
+bool L3G4200D_Spidev::writeRegs(uint8_t startAddress, const uint8_t *values,
+                                size_t count) {
+  if (count + 1 > FRAME_MAX) {
+    errno = EINVAL;
+    return false;
+  }
+
+  uint8_t tx[FRAME_MAX];
+  tx[0] = startAddress | (count > 1 ? 0x40 : 0);
+  memcpy(&tx[1], values, count);
+
+  struct spi_ioc_transfer xfer;
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.tx_buf = (uintptr_t)tx;
+  xfer.len = count + 1;
+  xfer.speed_hz = _speedHz;
+  xfer.bits_per_word = 8;
+
+  return ioctl(_fd, SPI_IOC_MESSAGE(1), &xfer) >= 0;
+}
+
+ssize_t L3G4200D_Spidev::readFifo(gyroLinuxSample_t *buf, size_t count,
+                                 uint8_t *fifoSrc) {
+  if (count > L3G4200D_FIFO_DEPTH) {
+    count = L3G4200D_FIFO_DEPTH;
+  }
+
+  // Two transfers in one message: FIFO_SRC_REG, then a burst from OUT_X_L.
+  // cs_change on the first one releases CS in between, since each read
+  // command needs its own CS frame. In FIFO mode the burst wraps from
+  // OUT_Z_H back to OUT_X_L, moving on to the next sample each time.
+  uint8_t srcTx[2] = {REG_FIFO_SRC | 0x80, 0};
+  uint8_t srcRx[2];
+  uint8_t tx[FRAME_MAX];
+  uint8_t rx[FRAME_MAX];
+  size_t len = 1 + 6 * count;
+  memset(tx, 0, len);
+  tx[0] = REG_OUT_X_L | 0b11000000;
+
+  struct spi_ioc_transfer xfers[2];
+  memset(xfers, 0, sizeof(xfers));
+  xfers[0].tx_buf = (uintptr_t)srcTx;
+  xfers[0].rx_buf = (uintptr_t)srcRx;
+  xfers[0].len = sizeof(srcTx);
+  xfers[0].speed_hz = _speedHz;
+  xfers[0].bits_per_word = 8;
+  xfers[0].cs_change = 1;
+  xfers[1].tx_buf = (uintptr_t)tx;
+  xfers[1].rx_buf = (uintptr_t)rx;
+  xfers[1].len = len;
+  xfers[1].speed_hz = _speedHz;
+  xfers[1].bits_per_word = 8;
+
+  // Without any samples to read, just read FIFO_SRC_REG.
+  if (ioctl(_fd, SPI_IOC_MESSAGE(count > 0 ? 2 : 1), xfers) < 0) {
+    return -1;
+  }
+  *fifoSrc = srcRx[1];
+
+  size_t level = fifoLevel(*fifoSrc);
+  if (count > level) {
+    count = level;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t *bytes = &rx[1 + 6 * i];
+    buf[i].x = (int16_t)((bytes[1] << 8) | bytes[0]);
+    buf[i].y = (int16_t)((bytes[3] << 8) | bytes[2]);
+    buf[i].z = (int16_t)((bytes[5] << 8) | bytes[4]);
+    buf[i].timestampNanos = 0;
+  }
+
+  return count;
+}
+
+size_t L3G4200D_Spidev::fifoLevel(uint8_t fifoSrc) {
+  // The level only counts to 31, so a full FIFO shows up as an overrun.
+  if (fifoSrc & FIFO_SRC_OVERRUN) {
+    return L3G4200D_FIFO_DEPTH;
+  }
+  return fifoSrc & FIFO_SRC_LEVEL_MASK;
+}
+
+uint32_t L3G4200D_Spidev::samplePeriodMicros() {
+  uint8_t ctrl1;
+  if (!readRegs(REG_CTRL_1, &ctrl1, 1)) {
+    return 0;
+  }
+
+  // Bits 7:6 of CTRL_REG1 pick 100, 200, 400, or 800 Hz.
+  return 10000UL >> ((ctrl1 >> 6) & 0b11);
+}
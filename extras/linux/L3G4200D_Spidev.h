@@ -0,0 +1,117 @@
+/*!
+ * @file L3G4200D_Spidev.h
+ *
+ * Talking to an L3G4200D from Linux userspace through spidev, for embedded
+ * Linux boards where the Arduino core isn't available. See
+ * L3G4200D_LinuxCapture.h for reading samples in the background.
+ *
+ * Build it along with L3G4200D_LinuxCapture.cpp and the library's
+ * L3G4200D_SampleClock.cpp, for example:
+ *
+ *     g++ -std=c++11 -O2 -pthread -I../.. -o l3g4200d_capture \
+ *         l3g4200d_capture.cpp L3G4200D_Spidev.cpp L3G4200D_LinuxCapture.cpp \
+ *         ../../L3G4200D_SampleClock.cpp
+ *
+ * l3g4200d_capture_test.cpp and l3g4200d_drain_test.cpp build the same way,
+ * with l3g4200d_fake_spidev.cpp, and run all of it against a fake gyroscope.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_SPIDEV_H
+#define L3G4200D_SPIDEV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "L3G4200D_Registers.h"
+
+/*! @brief One raw sample, and when it was taken. */
+typedef struct {
+  int16_t x; /*!< Raw X-axis sample. */
+  int16_t y; /*!< Raw Y-axis sample. */
+  int16_t z; /*!< Raw Z-axis sample. */
+
+  /*! The `CLOCK_MONOTONIC` time the sample was taken at, in nanoseconds, or 0
+   * if it isn't known. */
+  uint64_t timestampNanos;
+} gyroLinuxSample_t;
+
+/*!
+ * @brief An L3G4200D on a Linux spidev device, such as `/dev/spidev0.0`.
+ *
+ * Every read and write is one `SPI_IOC_MESSAGE` ioctl, so a multi-register
+ * read or a FIFO drain is a single trip into the kernel. Methods return false
+ * on errors, with `errno` set by the failing call.
+ *
+ * Samples are raw counts, the same as L3G4200D_Unified::rawXYZ. At the range
+ * set by @ref begin, 32767 counts is 250 degrees per second.
+ */
+class L3G4200D_Spidev {
+
+public:
+  L3G4200D_Spidev();
+  ~L3G4200D_Spidev();
+
+  /*! @brief Opens the spidev device, checks it's an L3G4200D, and sets it up
+   * like L3G4200D_Unified::begin does: 400 Hz with a 25 Hz cutoff, all three
+   * axes, and the 4.36 rad/s (250 dps) range.
+   *
+   * @param device The spidev device node, such as `/dev/spidev0.0`.
+   * @param speedHz The SPI clock frequency. Must be lower than 10 MHz.
+   *
+   * @returns True if the gyroscope was found and set up.
+   */
+  bool begin(const char *device, uint32_t speedHz = 5000000);
+
+  /*! @brief Closes the spidev device. */
+  void end();
+
+  /*! @brief Reads @p count consecutive registers, starting at
+   * @p startAddress, in one transfer.
+   * @returns True if the transfer succeeded.
+   */
+  bool readRegs(uint8_t startAddress, uint8_t *buf, size_t count);
+
+  /*! @brief Writes @p count consecutive registers, starting at
+   * @p startAddress, in one transfer.
+   * @returns True if the transfer succeeded.
+   */
+  bool writeRegs(uint8_t startAddress, const uint8_t *values, size_t count);
+
+  /*! @brief Reads FIFO_SRC_REG and then @p count samples from the FIFO, all in
+   * one ioctl.
+   *
+   * Since the FIFO level isn't known until FIFO_SRC_REG comes back, only ask
+   * for samples you know are there (from the watermark, or an earlier
+   * @p fifoSrc). Reading past the end of the FIFO could take a sample that
+   * arrives partway through, which would then be thrown away.
+   *
+   * @param buf [out] Where to store the samples. Their timestamps are 0.
+   * @param count How many samples to read, at most
+   * ::L3G4200D_FIFO_DEPTH, or 0 to only read FIFO_SRC_REG.
+   * @param fifoSrc [out] FIFO_SRC_REG, from just before the samples were read.
+   *
+   * @returns The number of samples stored in @p buf: @p count, or fewer if
+   * the FIFO didn't have that many, or -1 on errors.
+   */
+  ssize_t readFifo(gyroLinuxSample_t *buf, size_t count, uint8_t *fifoSrc);
+
+  /*! @brief Returns how many samples a FIFO_SRC_REG value says are in the
+   * FIFO. */
+  static size_t fifoLevel(uint8_t fifoSrc);
+
+  /*! @brief Returns the time between samples at the data rate in CTRL_REG1,
+   * in microseconds. */
+  uint32_t samplePeriodMicros();
+
+private:
+  int _fd;
+  uint32_t _speedHz;
+
+  L3G4200D_Spidev(const L3G4200D_Spidev &);
+  L3G4200D_Spidev &operator=(const L3G4200D_Spidev &);
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*!
+ * @file L3G4200D_SpscQueue.h
+ *
+ * A lock-free queue between one producer thread and one consumer thread, for
+ * the Linux capture thread. The Linux counterpart of L3G4200D_RingBuffer.h,
+ * which only has to work between an interrupt and the main loop on one core.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_SPSC_QUEUE_H
+#define L3G4200D_SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+/*!
+ * @brief A fixed-size queue that one thread pushes to and another pops from,
+ * without locks.
+ *
+ * Each index is only written by one side. The release store of an index
+ * after touching a slot, paired with the acquire load on the other side,
+ * makes sure the slot's contents are visible before the index says so.
+ *
+ * @tparam T The type of item to store.
+ * @tparam Capacity The number of slots. Must be a power of two. One slot is
+ * always left empty to tell a full queue from an empty one.
+ */
+template <typename T, size_t Capacity> class L3G4200D_SpscQueue {
+
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  L3G4200D_SpscQueue() : _head(0), _tail(0) {}
+
+  /*! @brief Adds an item. Only call this from the producer thread.
+   * @param item The item to add.
+   * @returns True if it was added, false if the queue was full.
+   */
+  bool push(const T &item) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t next = (head + 1) & (Capacity - 1);
+    if (next == _tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    _items[head] = item;
+    _head.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /*! @brief Takes the oldest item. Only call this from the consumer thread.
+   * @param item [out] The item taken.
+   * @returns True if an item was taken, false if the queue was empty.
+   */
+  bool pop(T &item) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    item = _items[tail];
+    _tail.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+    return true;
+  }
+
+  /*! @brief Returns the number of items waiting. This can be out of date as
+   * soon as it returns if the other thread is busy. */
+  size_t size() const {
+    return (_head.load(std::memory_order_acquire) -
+            _tail.load(std::memory_order_acquire)) &
+           (Capacity - 1);
+  }
+
+private:
+  T _items[Capacity];
+
+  // Keep the two indices on separate cache lines, so the two threads don't
+  // keep stealing the line from each other.
+  alignas(64) std::atomic<size_t> _head;
+  alignas(64) std::atomic<size_t> _tail;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/* Captures samples from an L3G4200D on a Linux board and prints them as CSV,
+   one line per sample, until interrupted.
+
+   Usage:
+
+       l3g4200d_capture SPIDEV GPIOCHIP LINE [WATERMARK]
+
+   For example, with the gyroscope on /dev/spidev0.0 and its INT2 pin on line
+   17 of /dev/gpiochip0:
+
+       l3g4200d_capture /dev/spidev0.0 /dev/gpiochip0 17 > samples.csv
+
+   See L3G4200D_Spidev.h for how to build it.
+*/
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "L3G4200D_LinuxCapture.h"
+#include "L3G4200D_Spidev.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) { stopRequested = 1; }
+
+int main(int argc, char **argv) {
+  if (argc < 4 || argc > 5) {
+    fprintf(stderr, "usage: %s SPIDEV GPIOCHIP LINE [WATERMARK]\n", argv[0]);
+    return 2;
+  }
+
+  unsigned int line = (unsigned int)strtoul(argv[3], NULL, 0);
+  uint8_t watermark = (argc > 4) ? (uint8_t)strtoul(argv[4], NULL, 0) : 16;
+
+  L3G4200D_Spidev gyro;
+  if (!gyro.begin(argv[1])) {
+    fprintf(stderr, "no L3G4200D on %s: %s\n", argv[1], strerror(errno));
+    return 1;
+  }
+
+  L3G4200D_LinuxCapture capture;
+  if (!capture.start(gyro, argv[2], line, watermark)) {
+    fprintf(stderr, "can't capture from line %u of %s: %s\n", line, argv[2],
+            strerror(errno));
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  printf("timestamp_ns,x,y,z\n");
+
+  // Wake up about every 10 ms to print whatever has been captured.
+  struct timespec interval = {0, 10 * 1000 * 1000};
+  while (!stopRequested && capture.running()) {
+    gyroLinuxSample_t sample;
+    while (capture.pop(sample)) {
+      printf("%llu,%d,%d,%d\n", (unsigned long long)sample.timestampNanos,
+             sample.x, sample.y, sample.z);
+    }
+    nanosleep(&interval, NULL);
+  }
+
+  int error = capture.lastError();
+  capture.stop();
+
+  fprintf(stderr, "%u sample(s) dropped, %u FIFO overrun(s)\n",
+          capture.droppedSamples(), capture.fifoOverruns());
+  if (error != 0) {
+    fprintf(stderr, "capture stopped: %s\n", strerror(error));
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+/* Runs L3G4200D_Spidev and L3G4200D_LinuxCapture against a fake gyroscope,
+   without any hardware. It builds the same way as l3g4200d_capture:
+
+       g++ -std=c++11 -O2 -pthread -I../.. -o l3g4200d_capture_test \
+           l3g4200d_capture_test.cpp l3g4200d_fake_spidev.cpp \
+           L3G4200D_Spidev.cpp L3G4200D_LinuxCapture.cpp \
+           ../../L3G4200D_SampleClock.cpp
+
+   The fake gyroscope is in l3g4200d_fake_spidev.cpp. Here a thread playing
+   its oscillator writes an edge event each time the FIFO reaches the
+   watermark.
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include <atomic>
+#include <thread>
+
+#include "L3G4200D_LinuxCapture.h"
+#include "L3G4200D_Spidev.h"
+#include "l3g4200d_fake_spidev.h"
+
+// The fake's real output data rate: nominally 400 Hz, but 0.4% slow.
+#define TRUE_PERIOD_NANOS (2510000ULL)
+
+#define WATERMARK (8)
+
+// How long to capture for.
+#define CAPTURE_NANOS (1000000000ULL)
+
+// The most an edge's timestamp is late by, like the interrupt latency.
+#define MAX_EDGE_LATENCY_NANOS (20000)
+
+// Timestamps may be off by this much once the sample clock has settled.
+#define MAX_TIMESTAMP_ERROR_NANOS (MAX_EDGE_LATENCY_NANOS)
+
+// Samples to give the sample clock to settle.
+#define SETTLING_SAMPLES (100)
+
+// Plays the gyroscope's oscillator: adds a sample to the FIFO every
+// TRUE_PERIOD_NANOS, and signals an edge when the FIFO reaches the watermark,
+// timestamped a repeatable but varying amount after that sample was taken.
+static void oscillate(std::atomic<bool> &running) {
+  uint64_t start = nowNanos();
+  uint32_t seed = 1;
+
+  for (uint64_t n = 0; running; n++) {
+    uint64_t due = start + n * TRUE_PERIOD_NANOS;
+    while (nowNanos() < due) {
+      struct timespec pause = {0, 100000};
+      nanosleep(&pause, NULL);
+    }
+
+    std::lock_guard<std::mutex> guard(fake.lock);
+    if (!fifoEnabled()) {
+      continue;
+    }
+
+    bool belowWatermark = fake.fifo.size() < fifoWatermark();
+    fakeTakeSample(due);
+
+    if (belowWatermark && fake.fifo.size() >= fifoWatermark()) {
+      seed = seed * 1103515245UL + 12345UL;
+      fakeEdge(due + (seed >> 8) % MAX_EDGE_LATENCY_NANOS);
+    }
+  }
+}
+
+static void testBegin() {
+  L3G4200D_Spidev gyro;
+
+  fake.regs[REG_WHO_AM_I] = 0xd4;
+  CHECK(!gyro.begin("/dev/null"));
+  CHECK(errno == ENODEV);
+
+  fake.regs[REG_WHO_AM_I] = L3G4200D_CHIP_ID;
+  CHECK(gyro.begin("/dev/null"));
+
+  // The same set-up as L3G4200D_Unified::begin.
+  const uint8_t expected[5] = {0x9f, 0x00, 0x00, 0x80, 0x00};
+  CHECK(memcmp(&fake.regs[REG_CTRL_1], expected, sizeof(expected)) == 0);
+  CHECK(gyro.samplePeriodMicros() == 2500);
+}
+
+static void testCapture() {
+  L3G4200D_Spidev gyro;
+  CHECK(gyro.begin("/dev/null"));
+  fake.regs[REG_CTRL_3] = CTRL3_USE_PULL_UP_FOR_HIGH;
+
+  L3G4200D_LinuxCapture capture;
+  if (!capture.start(gyro, "/dev/null", 17, WATERMARK)) {
+    perror("start");
+    failures++;
+    return;
+  }
+  CHECK(fake.regs[REG_CTRL_3] ==
+        (CTRL3_USE_PULL_UP_FOR_HIGH | CTRL3_I2_WATERMARK));
+  CHECK(fake.regs[REG_CTRL_5] == CTRL5_FIFO_ENABLE);
+  CHECK(fake.regs[REG_FIFO_CTRL] == (FIFO_CTRL_MODE_STREAM | WATERMARK));
+
+  std::atomic<bool> running(true);
+  std::thread oscillator(oscillate, std::ref(running));
+
+  std::vector<gyroLinuxSample_t> samples;
+  uint64_t end = nowNanos() + CAPTURE_NANOS;
+  while (nowNanos() < end) {
+    gyroLinuxSample_t sample;
+    while (capture.pop(sample)) {
+      samples.push_back(sample);
+    }
+    struct timespec pause = {0, 5000000};
+    nanosleep(&pause, NULL);
+  }
+
+  running = false;
+  oscillator.join();
+  capture.stop();
+
+  gyroLinuxSample_t sample;
+  while (capture.pop(sample)) {
+    samples.push_back(sample);
+  }
+
+  // Every sample read from the FIFO should come out once, in order.
+  size_t outOfOrder = 0;
+  uint64_t worstError = 0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    if (samples[i].x != (int16_t)i) {
+      outOfOrder++;
+      continue;
+    }
+    if (i < SETTLING_SAMPLES) {
+      continue;
+    }
+
+    uint64_t taken = fake.takenNanos[i];
+    uint64_t error = (samples[i].timestampNanos > taken)
+                         ? samples[i].timestampNanos - taken
+                         : taken - samples[i].timestampNanos;
+    if (error > worstError) {
+      worstError = error;
+    }
+  }
+
+  printf("%zu samples, %zu out of order, worst timestamp error %llu ns\n",
+         samples.size(), outOfOrder, (unsigned long long)worstError);
+
+  CHECK(samples.size() > CAPTURE_NANOS / TRUE_PERIOD_NANOS / 2);
+  CHECK(outOfOrder == 0);
+  CHECK(worstError <= MAX_TIMESTAMP_ERROR_NANOS);
+  CHECK(capture.droppedSamples() == 0);
+  CHECK(capture.fifoOverruns() == 0);
+  CHECK(capture.lastError() == 0);
+
+  // stop() puts everything back.
+  CHECK(fake.regs[REG_CTRL_3] == CTRL3_USE_PULL_UP_FOR_HIGH);
+  CHECK(fake.regs[REG_CTRL_5] == 0);
+  CHECK(fake.regs[REG_FIFO_CTRL] == FIFO_CTRL_MODE_BYPASS);
+}
+
+int main() {
+  if (!fakeBegin()) {
+    return 1;
+  }
+
+  testBegin();
+  testCapture();
+
+  return fakeResult("capture");
+}
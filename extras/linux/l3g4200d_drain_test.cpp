@@ -0,0 +1,148 @@
+/* Runs L3G4200D_LinuxCapture's FIFO draining against the fake gyroscope in
+   l3g4200d_fake_spidev.cpp, one case at a time, with the test deciding what's
+   in the FIFO and when the edges come: at the watermark, with more than the
+   watermark there, with no edge at all, and after an overrun. It builds the
+   same way as l3g4200d_capture_test:
+
+       g++ -std=c++11 -O2 -pthread -I../.. -o l3g4200d_drain_test \
+           l3g4200d_drain_test.cpp l3g4200d_fake_spidev.cpp \
+           L3G4200D_Spidev.cpp L3G4200D_LinuxCapture.cpp \
+           ../../L3G4200D_SampleClock.cpp
+*/
+
+#include <time.h>
+
+#include <vector>
+
+#include "L3G4200D_LinuxCapture.h"
+#include "L3G4200D_Spidev.h"
+#include "l3g4200d_fake_spidev.h"
+
+#define WATERMARK (4)
+
+// The nominal 400 Hz period L3G4200D_Spidev::begin sets up.
+#define PERIOD_NANOS (2500000ULL)
+
+// How long to wait for the capture thread, which is far longer than the
+// drain itself, or its timeout of four watermarks' worth of samples.
+#define WAIT_NANOS (500000000ULL)
+
+static L3G4200D_Spidev gyro;
+static L3G4200D_LinuxCapture capture;
+
+// Everything the capture thread has handed over so far.
+static std::vector<gyroLinuxSample_t> samples;
+
+// The time of the next sample the fake takes. A whole number of
+// microseconds, so the timestamps can be checked exactly.
+static uint64_t nextNanos;
+
+// Puts @p count samples in the FIFO, one period apart, and, if @p edge is
+// set, signals the edge for the last of them.
+static void takeSamples(size_t count, bool edge) {
+  std::lock_guard<std::mutex> guard(fake.lock);
+  for (size_t i = 0; i < count; i++) {
+    fakeTakeSample(nextNanos);
+    nextNanos += PERIOD_NANOS;
+  }
+  if (edge) {
+    fakeEdge(nextNanos - PERIOD_NANOS);
+  }
+}
+
+// Waits for the capture thread to hand over samples until there are
+// @p total. Returns false if it doesn't in time.
+static bool waitForSamples(size_t total) {
+  uint64_t end = nowNanos() + WAIT_NANOS;
+  while (samples.size() < total && nowNanos() < end) {
+    gyroLinuxSample_t sample;
+    while (capture.pop(sample)) {
+      samples.push_back(sample);
+    }
+    struct timespec pause = {0, 100000};
+    nanosleep(&pause, NULL);
+  }
+  return samples.size() == total;
+}
+
+// Checks that samples @p first to @p last came out once each, in order, and
+// are timestamped when they were taken, or not at all if @p timestamped is
+// false.
+static void checkSamples(size_t first, size_t last, bool timestamped) {
+  for (size_t i = first; i <= last && i < samples.size(); i++) {
+    CHECK(samples[i].x == (int16_t)i);
+    uint64_t expected = timestamped ? fake.takenNanos[i] : 0;
+    CHECK(samples[i].timestampNanos == expected);
+  }
+}
+
+static void testAtEdge() {
+  // Exactly the watermark, so the edge is when the last of them was taken.
+  takeSamples(WATERMARK, true);
+  CHECK(waitForSamples(WATERMARK));
+  checkSamples(0, WATERMARK - 1, true);
+}
+
+static void testExtraSamples() {
+  // Two more came in before the edge was handled, which are read too, and
+  // timestamped by counting on from it.
+  size_t first = samples.size();
+  takeSamples(WATERMARK, true);
+  takeSamples(2, false);
+  CHECK(waitForSamples(first + WATERMARK + 2));
+  checkSamples(first, first + WATERMARK + 1, true);
+  CHECK(fake.fifo.empty());
+}
+
+static void testTimeout() {
+  // Below the watermark, with no edge, they're still drained after a while,
+  // counting on from the last edge.
+  size_t first = samples.size();
+  takeSamples(WATERMARK - 1, false);
+  CHECK(waitForSamples(first + WATERMARK - 1));
+  checkSamples(first, first + WATERMARK - 2, true);
+}
+
+static void testOverrun() {
+  // A full FIFO that lost samples doesn't line up with the edge, or with
+  // the samples before it, so they aren't timestamped, but all of them are
+  // still read.
+  size_t first = samples.size();
+  takeSamples(L3G4200D_FIFO_DEPTH, false);
+  {
+    std::lock_guard<std::mutex> guard(fake.lock);
+    fake.overrun = true;
+  }
+  fakeEdge(nextNanos - PERIOD_NANOS);
+  CHECK(waitForSamples(first + L3G4200D_FIFO_DEPTH));
+  checkSamples(first, first + L3G4200D_FIFO_DEPTH - 1, false);
+  CHECK(capture.fifoOverruns() == 1);
+
+  // The next edge starts the timestamps again.
+  first = samples.size();
+  takeSamples(WATERMARK, true);
+  CHECK(waitForSamples(first + WATERMARK));
+  CHECK(samples.back().timestampNanos == fake.takenNanos.back());
+}
+
+int main() {
+  if (!fakeBegin()) {
+    return 1;
+  }
+
+  fake.regs[REG_WHO_AM_I] = L3G4200D_CHIP_ID;
+  CHECK(gyro.begin("/dev/null"));
+  CHECK(capture.start(gyro, "/dev/null", 17, WATERMARK));
+  nextNanos = nowNanos() / 1000 * 1000;
+
+  testAtEdge();
+  testExtraSamples();
+  testTimeout();
+  testOverrun();
+
+  capture.stop();
+  CHECK(capture.droppedSamples() == 0);
+  CHECK(capture.lastError() == 0);
+
+  return fakeResult("drain");
+}
@@ -0,0 +1,188 @@
+#include "l3g4200d_fake_spidev.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+#include <stdarg.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+int failures = 0;
+
+FakeGyro fake;
+
+bool fakeBegin() {
+  if (pipe2(fake.edgePipe, O_CLOEXEC) < 0) {
+    perror("pipe2");
+    return false;
+  }
+  return true;
+}
+
+uint64_t nowNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+bool fifoEnabled() { return fake.regs[REG_CTRL_5] & CTRL5_FIFO_ENABLE; }
+
+uint8_t fifoWatermark() {
+  return fake.regs[REG_FIFO_CTRL] & FIFO_CTRL_WATERMARK_MASK;
+}
+
+void fakeTakeSample(uint64_t takenNanos) {
+  if (fake.fifo.size() == L3G4200D_FIFO_DEPTH) {
+    fake.fifo.pop_front();
+    fake.overrun = true;
+  }
+  fake.fifo.push_back((int16_t)fake.takenNanos.size());
+  fake.takenNanos.push_back(takenNanos);
+}
+
+void fakeEdge(uint64_t timestampNanos) {
+  struct gpio_v2_line_event event;
+  memset(&event, 0, sizeof(event));
+  event.timestamp_ns = timestampNanos;
+  event.id = GPIO_V2_LINE_EVENT_RISING_EDGE;
+  ssize_t written = write(fake.edgePipe[1], &event, sizeof(event));
+  (void)written;
+}
+
+int fakeResult(const char *name) {
+  if (failures != 0) {
+    fprintf(stderr, "%s: %d check(s) failed\n", name, failures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+static uint8_t readRegister(uint8_t address) {
+  if (address == REG_FIFO_SRC) {
+    size_t level = fake.fifo.size();
+    uint8_t fifoSrc = (level >= L3G4200D_FIFO_DEPTH) ? FIFO_SRC_LEVEL_MASK
+                                                     : (uint8_t)level;
+    if (fake.overrun) {
+      fifoSrc |= FIFO_SRC_OVERRUN;
+    }
+    if (level == 0) {
+      fifoSrc |= FIFO_SRC_EMPTY;
+    }
+    if (level >= fifoWatermark()) {
+      fifoSrc |= FIFO_SRC_WATERMARK;
+    }
+    return fifoSrc;
+  }
+
+  if (address >= REG_OUT_X_L && address <= REG_OUT_Z_H && fifoEnabled()) {
+    if (fake.fifo.empty()) {
+      return 0;
+    }
+    int16_t axis = (address <= REG_OUT_X_H) ? fake.fifo.front() : 0;
+    return (address & 1) ? (uint8_t)(axis >> 8) : (uint8_t)axis;
+  }
+
+  return fake.regs[address];
+}
+
+static void writeRegister(uint8_t address, uint8_t value) {
+  fake.regs[address] = value;
+
+  // Going through bypass mode empties the FIFO.
+  if (address == REG_FIFO_CTRL &&
+      (value & ~FIFO_CTRL_WATERMARK_MASK) == FIFO_CTRL_MODE_BYPASS) {
+    fake.fifo.clear();
+    fake.overrun = false;
+  }
+}
+
+// Runs one SPI_IOC_MESSAGE. Chip Select stays asserted from one transfer to
+// the next unless cs_change is set, and each time it's asserted the first
+// byte is a command.
+static void spiMessage(const struct spi_ioc_transfer *xfers, size_t count) {
+  std::lock_guard<std::mutex> guard(fake.lock);
+
+  bool haveCommand = false;
+  bool read = false;
+  bool autoIncrement = false;
+  uint8_t address = 0;
+
+  for (size_t t = 0; t < count; t++) {
+    const uint8_t *tx = (const uint8_t *)(uintptr_t)xfers[t].tx_buf;
+    uint8_t *rx = (uint8_t *)(uintptr_t)xfers[t].rx_buf;
+
+    for (size_t i = 0; i < xfers[t].len; i++) {
+      uint8_t in = tx ? tx[i] : 0;
+      uint8_t out = 0;
+
+      if (!haveCommand) {
+        haveCommand = true;
+        read = in & 0x80;
+        autoIncrement = in & 0x40;
+        address = in & 0x3f;
+      } else {
+        if (read) {
+          out = readRegister(address);
+        } else {
+          writeRegister(address, in);
+        }
+
+        if (autoIncrement) {
+          if (read && fifoEnabled() && address == REG_OUT_Z_H) {
+            // Wrap back to OUT_X_L, on to the next sample.
+            address = REG_OUT_X_L;
+            if (!fake.fifo.empty()) {
+              fake.fifo.pop_front();
+              fake.overrun = false;
+            }
+          } else {
+            address = (address + 1) & 0x3f;
+          }
+        }
+      }
+
+      if (rx) {
+        rx[i] = out;
+      }
+    }
+
+    if (xfers[t].cs_change) {
+      haveCommand = false;
+    }
+  }
+}
+
+extern "C" int ioctl(int fd, unsigned long request, ...) {
+  (void)fd;
+
+  va_list args;
+  va_start(args, request);
+  void *arg = va_arg(args, void *);
+  va_end(args);
+
+  if (request == GPIO_V2_GET_LINE_IOCTL) {
+    struct gpio_v2_line_request *line = (struct gpio_v2_line_request *)arg;
+    CHECK(line->num_lines == 1);
+    CHECK(line->config.flags & GPIO_V2_LINE_FLAG_EDGE_RISING);
+    line->fd = fake.edgePipe[0];
+    return 0;
+  }
+
+  if (_IOC_TYPE(request) != SPI_IOC_MAGIC) {
+    errno = ENOTTY;
+    return -1;
+  }
+
+  // Mode, bits per word, and speed.
+  if (_IOC_NR(request) != _IOC_NR(SPI_IOC_MESSAGE(1))) {
+    return 0;
+  }
+
+  spiMessage((const struct spi_ioc_transfer *)arg,
+             _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer));
+  return 0;
+}
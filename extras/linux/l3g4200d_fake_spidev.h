@@ -0,0 +1,72 @@
+/* A fake L3G4200D behind spidev and a GPIO line, shared by the Linux
+   backend's tests, so they run without any hardware.
+
+   l3g4200d_fake_spidev.cpp defines its own ioctl(), which the linker picks
+   over glibc's. SPI_IOC_MESSAGE transfers go to a fake L3G4200D register
+   file and FIFO, and GPIO_V2_GET_LINE_IOCTL hands back a pipe, which the
+   test writes edge events to with fakeEdge(). The other spidev ioctls just
+   succeed. The devices opened are /dev/null.
+*/
+
+#ifndef L3G4200D_FAKE_SPIDEV_H
+#define L3G4200D_FAKE_SPIDEV_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "L3G4200D_Registers.h"
+
+extern int failures;
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,         \
+              #condition);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// The fake gyroscope. Everything is guarded by `lock`, since it's touched by
+// the capture thread through ioctl() and by the test.
+struct FakeGyro {
+  std::mutex lock;
+  uint8_t regs[0x40];
+  std::deque<int16_t> fifo;
+  bool overrun;
+
+  // The pipe standing in for the GPIO line's event file descriptor.
+  int edgePipe[2];
+
+  // When each sample was taken. The samples' X axis counts up from 0, so
+  // gaps and repeats show, and this is indexed by it.
+  std::vector<uint64_t> takenNanos;
+};
+
+extern FakeGyro fake;
+
+// Sets up the fake. Returns false if it can't.
+bool fakeBegin();
+
+// Returns the CLOCK_MONOTONIC time, which GPIO edge events are stamped with.
+uint64_t nowNanos();
+
+// Whether the fake's FIFO is on, and its watermark. Call with `lock` held.
+bool fifoEnabled();
+uint8_t fifoWatermark();
+
+// Takes the next sample at @p takenNanos into the FIFO, dropping the oldest
+// and flagging an overrun if it's full. Call with `lock` held.
+void fakeTakeSample(uint64_t takenNanos);
+
+// Signals a rising edge on INT2, stamped with @p timestampNanos.
+void fakeEdge(uint64_t timestampNanos);
+
+// Prints how the checks went, and returns the exit status for main().
+int fakeResult(const char *name);
+
+#endif
@@ -0,0 +1,75 @@
+/*!
+ * @file bench.h
+ *
+ * Timing for the host benchmarks in extras/test. Each benchmark is its own
+ * program, built with the same stand-ins as the tests, and prints what it
+ * measured as JSON.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_BENCH_H
+#define L3G4200D_BENCH_H
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*! @brief How many rounds each measurement is split into. Only the fastest
+ * round counts, so one that was interrupted doesn't skew it. */
+#define BENCH_ROUNDS (5)
+
+/*! @brief Something for benchmarked code to write its results to, so none of
+ * it is optimized away. */
+static volatile int32_t benchSink;
+
+/*! @brief Returns the CPU time this process has used, in nanoseconds. */
+static inline uint64_t benchCpuNanos() {
+  struct timespec now;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/*! @brief Returns the CPU's cycle counter, or the CPU time in nanoseconds on
+ * hosts without one. See @ref benchCycleUnit. */
+static inline uint64_t benchCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return benchCpuNanos();
+#endif
+}
+
+/*! @brief Returns the unit @ref benchCycles counts in. */
+static inline const char *benchCycleUnit() {
+#if defined(__x86_64__) || defined(__i386__)
+  return "cycles";
+#else
+  return "ns";
+#endif
+}
+
+/*! @brief Runs @p body @p calls times, split into @ref BENCH_ROUNDS rounds,
+ * and returns how long one call took in the fastest round, as measured by
+ * @p clock. */
+template <typename Body>
+static double benchBest(uint64_t (*clock)(), long calls, Body body) {
+  long perRound = calls / BENCH_ROUNDS;
+  double best = 0;
+  for (int round = 0; round < BENCH_ROUNDS; round++) {
+    uint64_t start = clock();
+    for (long i = 0; i < perRound; i++) {
+      body();
+    }
+    double each = (double)(clock() - start) / perRound;
+    if (round == 0 || each < best) {
+      best = each;
+    }
+  }
+  return best;
+}
+
+#endif
@@ -0,0 +1,121 @@
+/* Measures what each way of reading the fake gyroscope costs on the bus:
+   SPI transactions, Chip Select assertions, and bytes per call, from the
+   SPI stand-in's counters, along with the time the bytes take on a 5 MHz
+   bus, the time the whole call takes on the micros() clock (which includes
+   the stand-ins' model of digitalWrite() and beginTransaction()), and the
+   host CPU time. Prints them as JSON, one path per line, with the same path
+   names and fields as examples/benchmark.
+
+   The library's rawX(), rawY(), rawZ() and rawXYZ() are private, so the
+   register reads they do are timed through rawReadRegs(): the 7-byte burst
+   from STATUS_REG that rawXYZ() and getEvent() do, and the three 2-byte
+   reads rawX(), rawY() and rawZ() would do between them.
+
+   Usage: bench_bus_traffic [calls] */
+
+#include "L3G4200D_U.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static FakeL3G4200D chip(10);
+static L3G4200D_Unified gyro(1);
+
+// Runs @p body @p calls times, and prints a line of JSON with the bus
+// traffic it took for each of @p perCall calls or samples.
+template <typename Body>
+static void measure(const char *path, long calls, long perCall, bool last,
+                    Body body) {
+  SPI.clearLog();
+  uint64_t startNanos = testNanos();
+  uint64_t startCpuNanos = benchCpuNanos();
+  for (long i = 0; i < calls; i++) {
+    body(i);
+  }
+  double cpuNanos = (double)(benchCpuNanos() - startCpuNanos);
+  double nanos = (double)(testNanos() - startNanos);
+  double count = (double)calls * perCall;
+
+  printf("    {\"path\": \"%s\", \"calls\": %ld, "
+         "\"transactions_per_call\": %.2f, \"chip_selects_per_call\": %.2f, "
+         "\"bytes_per_call\": %.2f, \"bus_ns_per_call\": %.0f, "
+         "\"ns_per_call\": %.0f, \"cpu_ns_per_call\": %.0f}%s\n",
+         path, calls * perCall, SPI.transactions / count,
+         SPI.chipSelects / count, SPI.bytes / count, SPI.busNanos / count,
+         nanos / count, cpuNanos / count, last ? "" : ",");
+}
+
+int main(int argc, char **argv) {
+  long calls = (argc > 1) ? atol(argv[1]) : 100000;
+  if (calls < L3G4200D_FIFO_DEPTH) {
+    fprintf(stderr, "usage: %s [calls]\n", argv[0]);
+    return 2;
+  }
+
+  chip.reset();
+  SPI.reset();
+  if (!gyro.begin(10)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  chip.setSample(12345, -23456, 321);
+
+  printf("{\n");
+  printf("  \"spi_hz\": %ld,\n", 5L * 1000L * 1000L);
+  printf("  \"paths\": [\n");
+
+  sensors_event_t event;
+  measure("getEvent", calls, 1, false, [&](long) {
+    gyro.getEvent(&event);
+    benchSink = (int32_t)event.gyro.x;
+  });
+
+  gyroFixedEvent_t fixed;
+  measure("getEventFixed", calls, 1, false, [&](long) {
+    gyro.getEventFixed(&fixed);
+    benchSink = fixed.x;
+  });
+
+  gyro.setEnabledAxes(GYRO_AXES_Z);
+  measure("getEventAxes<Z>", calls, 1, false, [&](long) {
+    gyro.getEventAxes<GYRO_AXES_Z>(&event);
+    benchSink = (int32_t)event.gyro.z;
+  });
+  gyro.setEnabledAxes(GYRO_AXES_XYZ);
+
+  uint8_t bytes[7];
+  measure("rawReadRegs(STATUS,7)", calls, 1, false, [&](long) {
+    gyro.rawReadRegs(REG_STATUS, bytes, 7);
+    benchSink = bytes[1];
+  });
+
+  measure("rawReadRegs(OUT_X/Y/Z_L,2)", calls, 1, false, [&](long) {
+    gyro.rawReadRegs(REG_OUT_X_L, bytes, 2);
+    gyro.rawReadRegs(REG_OUT_Y_L, bytes, 2);
+    gyro.rawReadRegs(REG_OUT_Z_L, bytes, 2);
+    benchSink = bytes[1];
+  });
+
+  measure("setRange", calls, 1, false, [&](long i) {
+    gyro.setRange((i & 1) ? GYRO_RANGE_8_DOT_73_RAD_PER_SEC
+                          : GYRO_RANGE_4_DOT_36_RAD_PER_SEC);
+  });
+  gyro.setRange(GYRO_RANGE_4_DOT_36_RAD_PER_SEC);
+
+  // A full FIFO at a time, counted per sample.
+  gyroSample_t samples[L3G4200D_FIFO_DEPTH];
+  gyro.enableFifo(GYRO_FIFO_STREAM);
+  measure("readFifo", calls / L3G4200D_FIFO_DEPTH, L3G4200D_FIFO_DEPTH, true,
+          [&](long) {
+            for (int16_t i = 0; i < L3G4200D_FIFO_DEPTH; i++) {
+              chip.pushFifo(i, -i, i);
+            }
+            benchSink = gyro.readFifo(samples, L3G4200D_FIFO_DEPTH);
+          });
+  gyro.disableFifo();
+
+  printf("  ]\n");
+  printf("}\n");
+  return 0;
+}
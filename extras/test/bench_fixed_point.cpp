@@ -0,0 +1,76 @@
+/* Times getEvent() against getEventFixed() and getEventMilliRad() over
+   millions of samples from the fake gyroscope, and prints the results as
+   JSON. Reading STATUS_REG and the output registers with rawReadRegs() is
+   the same SPI traffic without any conversion, so the difference from that
+   is roughly what each conversion costs on the host's CPU.
+
+   The host has a floating point unit, so this only shows that the fixed
+   point path isn't any slower there. On boards without one, the float path
+   pulls in soft float, which examples/benchmark measures on the board
+   itself, and check_fixed_point.py makes sure the fixed point path never
+   does.
+
+   Usage: bench_fixed_point [samples] */
+
+#include "L3G4200D_U.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static FakeL3G4200D chip(10);
+static L3G4200D_Unified gyro(1);
+
+int main(int argc, char **argv) {
+  long samples = (argc > 1) ? atol(argv[1]) : 1000000;
+  if (samples < BENCH_ROUNDS) {
+    fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+    return 2;
+  }
+
+  // Make the fake bus as close to free as it gets: nothing but the bytes,
+  // at a clock fast enough that a whole read takes well under the
+  // microsecond the fakes step time by.
+  testTiming_t freeBus = {0, 0, 0, 0, 0};
+  testTiming = freeBus;
+  chip.reset();
+  SPI.reset();
+  if (!gyro.begin(10, GYRO_RANGE_4_DOT_36_RAD_PER_SEC, SPI, 1000000000UL)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  chip.setSample(12345, -23456, 321);
+
+  uint8_t bytes[7];
+  double raw = benchBest(benchCpuNanos, samples, [&] {
+    gyro.rawReadRegs(REG_STATUS, bytes, sizeof(bytes));
+    benchSink = bytes[1] + bytes[3] + bytes[5];
+  });
+
+  sensors_event_t event;
+  double floatNanos = benchBest(benchCpuNanos, samples, [&] {
+    gyro.getEvent(&event);
+    benchSink = (int32_t)(event.gyro.x + event.gyro.y + event.gyro.z);
+  });
+
+  gyroFixedEvent_t fixed;
+  double fixedNanos = benchBest(benchCpuNanos, samples, [&] {
+    gyro.getEventFixed(&fixed);
+    benchSink = fixed.x + fixed.y + fixed.z;
+  });
+  double milliRadNanos = benchBest(benchCpuNanos, samples, [&] {
+    gyro.getEventMilliRad(&fixed);
+    benchSink = fixed.x + fixed.y + fixed.z;
+  });
+
+  printf("{\n");
+  printf("  \"samples\": %ld,\n", samples);
+  printf("  \"ns_per_sample\": {\"raw\": %.1f, \"float\": %.1f, "
+         "\"fixed\": %.1f, \"millirad\": %.1f},\n",
+         raw, floatNanos, fixedNanos, milliRadNanos);
+  printf("  \"ns_over_raw\": {\"float\": %.1f, \"fixed\": %.1f, "
+         "\"millirad\": %.1f}\n",
+         floatNanos - raw, fixedNanos - raw, milliRadNanos - raw);
+  printf("}\n");
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* Counts the cycles getEvent() and getEventFixed() take per sample from the
+   fake gyroscope, over a nearly free fake bus, and prints them as JSON.
+   Reading STATUS_REG and the output registers with rawReadRegs() is the same
+   SPI traffic with nothing else, so the difference from that is what the
+   library adds on top of the read.
+
+   run_tests.sh builds this with L3G4200D_DEBUG_LOGGING at 1, with logging
+   turned off at run time, and at 0, where it's compiled out, to compare the
+   two.
+
+   Usage: bench_get_event [samples] */
+
+#include "L3G4200D_U.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static FakeL3G4200D chip(10);
+static L3G4200D_Unified gyro(1);
+
+int main(int argc, char **argv) {
+  long samples = (argc > 1) ? atol(argv[1]) : 1000000;
+  if (samples < BENCH_ROUNDS) {
+    fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+    return 2;
+  }
+
+  // Nothing but the bytes, at a clock fast enough that a whole read takes
+  // well under the microsecond the fakes step time by.
+  testTiming_t freeBus = {0, 0, 0, 0, 0};
+  testTiming = freeBus;
+  chip.reset();
+  SPI.reset();
+  if (!gyro.begin(10, GYRO_RANGE_4_DOT_36_RAD_PER_SEC, SPI, 1000000000UL)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  gyro.enableDebugLogging(false);
+  chip.setSample(12345, -23456, 321);
+
+  uint8_t bytes[7];
+  double raw = benchBest(benchCycles, samples, [&] {
+    gyro.rawReadRegs(REG_STATUS, bytes, sizeof(bytes));
+    benchSink = bytes[1] + bytes[3] + bytes[5];
+  });
+
+  sensors_event_t event;
+  double getEvent = benchBest(benchCycles, samples, [&] {
+    gyro.getEvent(&event);
+    benchSink = (int32_t)(event.gyro.x + event.gyro.y + event.gyro.z);
+  });
+
+  gyroFixedEvent_t fixed;
+  double getEventFixed = benchBest(benchCycles, samples, [&] {
+    gyro.getEventFixed(&fixed);
+    benchSink = fixed.x + fixed.y + fixed.z;
+  });
+
+  printf("{\n");
+  printf("  \"debug_logging\": %d,\n", (int)L3G4200D_DEBUG_LOGGING);
+  printf("  \"unit\": \"%s\",\n", benchCycleUnit());
+  printf("  \"samples\": %ld,\n", samples);
+  printf("  \"per_sample\": {\"raw\": %.1f, \"getEvent\": %.1f, "
+         "\"getEventFixed\": %.1f},\n",
+         raw, getEvent, getEventFixed);
+  printf("  \"over_raw\": {\"getEvent\": %.1f, \"getEventFixed\": %.1f}\n",
+         getEvent - raw, getEventFixed - raw);
+  printf("}\n");
+  return 0;
+}
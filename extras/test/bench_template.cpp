@@ -0,0 +1,106 @@
+/* Compares the compile-time configured L3G4200D<> with L3G4200D_Unified set
+   up the same way, reading the same fake gyroscope: cycles per getEvent()
+   and getEventFixed() over a nearly free fake bus, and the SPI traffic each
+   takes. Both are measured with auto-ranging off, as the default config has
+   it, and on. Prints the results as JSON, one row per line.
+
+   Usage: bench_template [samples] */
+
+#include "L3G4200D.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// The default config, but at a clock fast enough that a whole read takes
+// well under the microsecond the fakes step time by, so the fake bus is
+// nearly free. L3G4200D_Unified is set up with the same clock.
+struct BenchConfig : L3G4200D_DefaultConfig {
+  static constexpr uint32_t SPI_FREQUENCY = 1000000000UL;
+};
+
+struct AutoRangeConfig : BenchConfig {
+  static constexpr bool AUTO_RANGE = true;
+};
+
+static FakeL3G4200D chip(10);
+
+// Times @p body over @p samples calls, and prints a row of JSON with the
+// cycles and SPI traffic per call.
+template <typename Body>
+static void measure(const char *driver, const char *path, long samples,
+                    bool last, Body body) {
+  SPI.clearLog();
+  double cycles = benchBest(benchCycles, samples, body);
+  double calls = (double)(samples / BENCH_ROUNDS * BENCH_ROUNDS);
+
+  printf("    {\"driver\": \"%s\", \"path\": \"%s\", \"%s_per_call\": %.1f, "
+         "\"transactions_per_call\": %.2f, \"bytes_per_call\": %.2f}%s\n",
+         driver, path, benchCycleUnit(), cycles, SPI.transactions / calls,
+         SPI.bytes / calls, last ? "" : ",");
+}
+
+template <typename Gyro>
+static void measureBoth(const char *driver, Gyro &gyro, long samples,
+                        bool last) {
+  sensors_event_t event;
+  measure(driver, "getEvent", samples, false, [&] {
+    gyro.getEvent(&event);
+    benchSink = (int32_t)(event.gyro.x + event.gyro.y + event.gyro.z);
+  });
+
+  gyroFixedEvent_t fixed;
+  measure(driver, "getEventFixed", samples, last, [&] {
+    gyro.getEventFixed(&fixed);
+    benchSink = fixed.x + fixed.y + fixed.z;
+  });
+}
+
+int main(int argc, char **argv) {
+  long samples = (argc > 1) ? atol(argv[1]) : 1000000;
+  if (samples < BENCH_ROUNDS) {
+    fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+    return 2;
+  }
+
+  // Nothing but the bytes.
+  testTiming_t freeBus = {0, 0, 0, 0, 0};
+  testTiming = freeBus;
+  chip.reset();
+  SPI.reset();
+
+  printf("{\n");
+  printf("  \"rows\": [\n");
+
+  L3G4200D_Unified unified(1);
+  if (!unified.begin(10, BenchConfig::RANGE, SPI, BenchConfig::SPI_FREQUENCY)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  unified.enableDebugLogging(false);
+  chip.setSample(1234, -2345, 321);
+  measureBoth("L3G4200D_Unified", unified, samples, false);
+
+  unified.enableAutoRange(true);
+  measureBoth("L3G4200D_Unified+autoRange", unified, samples, false);
+
+  L3G4200D<BenchConfig> lean;
+  if (!lean.begin(10)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  chip.setSample(1234, -2345, 321);
+  measureBoth("L3G4200D<BenchConfig>", lean, samples, false);
+
+  L3G4200D<AutoRangeConfig> leanAutoRange;
+  if (!leanAutoRange.begin(10)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  chip.setSample(1234, -2345, 321);
+  measureBoth("L3G4200D<AutoRangeConfig>", leanAutoRange, samples, true);
+
+  printf("  ]\n");
+  printf("}\n");
+  return 0;
+}
@@ -0,0 +1,124 @@
+/* Measures what one sample costs through each of L3G4200D<>'s transports:
+   hardware SPI at 5 MHz, bit-banged SPI, and I2C at 400 kHz and 1 MHz.
+   For each, prints the transactions and bytes per getEventFixed() on the
+   bus, the time those bytes take on the wire, and the time the whole call
+   takes on the micros() clock, which for bit-banged SPI is nearly all the
+   stand-ins' model of digitalWrite() and digitalRead(). The highest rate
+   each can keep up with is one sample per that time. Prints them as JSON,
+   one transport per line.
+
+   Usage: bench_transports [samples] */
+
+#include "L3G4200D.h"
+#include "L3G4200D_I2C.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static FakeL3G4200D chip(10);
+
+// What a transport put on the bus, counted by whichever stand-in it used.
+typedef struct {
+  long transactions;
+  long bytes;
+  uint64_t busNanos;
+} busLog_t;
+
+// Reads @p samples samples through @p gyro, and prints a line of JSON with
+// what each took. @p bus says what went over the bus.
+template <typename Gyro, typename Bus>
+static void measure(const char *transport, Gyro &gyro, long samples, bool last,
+                    Bus bus) {
+  chip.setSample(12345, -23456, 321);
+  gyroFixedEvent_t event;
+  busLog_t before = bus();
+  uint64_t startNanos = testNanos();
+  for (long i = 0; i < samples; i++) {
+    gyro.getEventFixed(&event);
+    benchSink = event.x;
+  }
+  double nanos = (double)(testNanos() - startNanos) / samples;
+  busLog_t after = bus();
+  double transactions = (double)(after.transactions - before.transactions);
+
+  printf("    {\"transport\": \"%s\", \"transactions_per_sample\": %.2f, "
+         "\"bytes_per_sample\": %.2f, \"bus_ns_per_sample\": %.0f, "
+         "\"ns_per_sample\": %.0f, \"max_hz\": %.0f}%s\n",
+         transport, transactions / samples,
+         (double)(after.bytes - before.bytes) / samples,
+         (double)(after.busNanos - before.busNanos) / samples, nanos,
+         1e9 / nanos, last ? "" : ",");
+}
+
+static busLog_t spiLog() {
+  busLog_t log = {(long)SPI.transactions, (long)SPI.bytes, SPI.busNanos};
+  return log;
+}
+
+static busLog_t wireLog() {
+  busLog_t log = {(long)Wire.transfers, (long)Wire.bytes, Wire.busNanos};
+  return log;
+}
+
+int main(int argc, char **argv) {
+  long samples = (argc > 1) ? atol(argv[1]) : 100000;
+  if (samples < 1) {
+    fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+    return 2;
+  }
+  // Every bit-banged edge is a digitalWrite(), so fewer of those will do.
+  long softSamples = samples / 100 + 1;
+
+  chip.reset();
+  SPI.reset();
+  Wire.reset();
+
+  printf("{\n");
+  printf("  \"transports\": [\n");
+
+  L3G4200D<> hardware;
+  if (!hardware.begin(10)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  measure("HardwareSPI", hardware, samples, false, spiLog);
+
+  // The bit-banged frames never reach the SPI stand-in, so they're counted
+  // from what the fake gyroscope saw. They take as long as the call does.
+  chip.sckPin = 13;
+  chip.copiPin = 11;
+  chip.cipoPin = 12;
+  L3G4200D<L3G4200D_DefaultConfig, L3G4200D_SoftwareSPI> software;
+  if (!software.begin(10, 13, 11, 12)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  measure("SoftwareSPI", software, softSamples, false, [] {
+    busLog_t log = {(long)chip.frames.size(), 0, testNanos()};
+    for (size_t i = 0; i < chip.frames.size(); i++) {
+      log.bytes += (long)chip.frames[i].size();
+    }
+    return log;
+  });
+  chip.sckPin = chip.copiPin = chip.cipoPin = -1;
+
+  chip.i2cAddress = L3G4200D_I2C_ADDRESS_SDO_HIGH;
+  L3G4200D<L3G4200D_DefaultConfig, L3G4200D_I2C<400000>> i2c;
+  if (!i2c.begin(Wire, L3G4200D_I2C_ADDRESS_SDO_HIGH)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  measure("I2C@400kHz", i2c, samples, false, wireLog);
+
+  L3G4200D<L3G4200D_DefaultConfig, L3G4200D_I2C<1000000>> fastI2c;
+  if (!fastI2c.begin(Wire, L3G4200D_I2C_ADDRESS_SDO_HIGH)) {
+    fprintf(stderr, "begin() failed\n");
+    return 1;
+  }
+  measure("I2C@1MHz", fastI2c, samples, true, wireLog);
+
+  printf("  ]\n");
+  printf("}\n");
+  return 0;
+}
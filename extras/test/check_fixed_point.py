@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Checks that the fixed-point read path doesn't do any floating point math.
+
+Follows every call and jump from getEventFixed() and getEventMilliRad(), of
+both L3G4200D_Unified and the L3G4200D template, through the disassembly of
+a program built from fixed_point_path.cpp, and fails if any library function
+it reaches has a floating point instruction or calls a float helper. Calls
+out of the library (to the Arduino stubs, that is) are where it stops.
+
+Usage:
+
+    check_fixed_point.py PROGRAM LIBRARY_OBJECT...
+
+The library objects are only used for the names of the functions they
+define, so static helpers count as part of the library too.
+"""
+
+import re
+import subprocess
+import sys
+
+ENTRY_POINTS = re.compile(r"^L3G4200D(_Unified|<.*>)::getEvent(Fixed|MilliRad)\(")
+
+# Scalar and packed SSE arithmetic, conversions, and compares, and any x87
+# instruction.
+FLOAT_INSTRUCTION = re.compile(
+    r"^v?((add|sub|mul|div|min|max|sqrt|rcp|rsqrt)(ss|sd|ps|pd)"
+    r"|cvt\w+|u?comis[sd]|f\w+)$"
+)
+
+# Floating point helpers, from libgcc's soft float or libm.
+FLOAT_CALL = re.compile(
+    r"^(__\w*(sf|df|tf)\w*|l?l?round\w*|floor\w*|ceil\w*|sqrt\w*|pow\w*"
+    r"|exp\w*|log\w*|sin\w*|cos\w*|tan\w*|atan\w*|fabs\w*)$"
+)
+
+FUNCTION = re.compile(r"^[0-9a-f]+ <(.*)>:$")
+INSTRUCTION = re.compile(r"^\s+([0-9a-f]+):\s+(\S+)\s*(.*)$")
+TARGET = re.compile(r"<([^>+]*)(\+0x[0-9a-f]+)?>")
+
+
+def normalize(name):
+    """Drops what the compiler adds to clones and PLT entries."""
+    name = re.sub(r" \[clone [^\]]*\]", "", name)
+    return re.sub(r"@plt$", "", name)
+
+
+def library_names(objects):
+    names = set()
+    for obj in objects:
+        out = subprocess.run(
+            ["nm", "-C", "--defined-only", obj],
+            check=True, capture_output=True, text=True,
+        ).stdout
+        for line in out.splitlines():
+            parts = line.split(None, 2)
+            if len(parts) == 3 and parts[1].lower() in "tw":
+                names.add(normalize(parts[2]))
+    return names
+
+
+def disassemble(program):
+    """Returns each function's instructions, by name, as (mnemonic,
+    operands) pairs."""
+    out = subprocess.run(
+        ["objdump", "-d", "-C", "--no-show-raw-insn", program],
+        check=True, capture_output=True, text=True,
+    ).stdout
+
+    functions = {}
+    current = None
+    for line in out.splitlines():
+        match = FUNCTION.match(line)
+        if match:
+            current = functions.setdefault(match.group(1), [])
+            continue
+        match = INSTRUCTION.match(line)
+        if match and current is not None:
+            current.append((match.group(2), match.group(3)))
+    return functions
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.stderr.write(__doc__)
+        return 2
+
+    functions = disassemble(sys.argv[1])
+    library = library_names(sys.argv[2:])
+
+    def in_library(name):
+        # Templates and inline functions are defined in the headers, so
+        # they're only in the program.
+        base = normalize(name)
+        return base in library or base.startswith("L3G4200D")
+
+    entries = [name for name in functions if ENTRY_POINTS.match(name)]
+    if not entries:
+        print("check_fixed_point.py: no entry points found", file=sys.stderr)
+        return 2
+
+    # Breadth first, remembering how each function was reached.
+    reached_from = {name: None for name in entries}
+    queue = list(entries)
+    problems = []
+    while queue:
+        name = queue.pop(0)
+        for mnemonic, operands in functions.get(name, []):
+            if FLOAT_INSTRUCTION.match(mnemonic):
+                problems.append((name, "%s %s" % (mnemonic, operands)))
+                continue
+            if not (mnemonic.startswith("call") or mnemonic.startswith("j")):
+                continue
+            target = TARGET.search(operands)
+            if target is None:
+                continue
+            callee = target.group(1)
+            if FLOAT_CALL.match(normalize(callee)):
+                problems.append((name, "call to %s" % callee))
+            elif (
+                callee in functions
+                and callee not in reached_from
+                and in_library(callee)
+            ):
+                reached_from[callee] = name
+                queue.append(callee)
+
+    # One report per function, with the first thing found and how the
+    # function was reached.
+    reported = {}
+    for name, what in problems:
+        reported.setdefault(name, []).append(what)
+    for name, found in reported.items():
+        path = [name]
+        while reached_from[path[-1]] is not None:
+            path.append(reached_from[path[-1]])
+        print(
+            "floating point in the fixed-point path: %d in %s, first %s"
+            % (len(found), name, found[0])
+        )
+        print("  reached through %s" % " <- ".join(path[1:] or ["itself"]))
+
+    if problems:
+        return 1
+    print("fixed point: ok (%d functions checked)" % len(reached_from))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,23 @@
+/* Calls every fixed-point entry point, for check_fixed_point.py to follow
+   through the disassembly. It's built, but never run. */
+
+#include "L3G4200D.h"
+
+struct AutoRangeConfig : L3G4200D_DefaultConfig {
+  static constexpr bool AUTO_RANGE = true;
+};
+
+static L3G4200D_Unified unified(1);
+static L3G4200D<> constantRange;
+static L3G4200D<AutoRangeConfig> autoRange;
+
+int main() {
+  gyroFixedEvent_t event;
+  unified.getEventFixed(&event);
+  unified.getEventMilliRad(&event);
+  constantRange.getEventFixed(&event);
+  constantRange.getEventMilliRad(&event);
+  autoRange.getEventFixed(&event);
+  autoRange.getEventMilliRad(&event);
+  return 0;
+}
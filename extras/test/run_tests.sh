@@ -0,0 +1,113 @@
+#!/bin/sh
+# Builds and runs the host tests, with plain g++ and the Arduino stand-ins in
+# stubs/. Each test is its own program; for example, from this directory:
+#
+#     g++ -std=gnu++11 -DARDUINO=10819 -Wall -Wextra -pthread -Istubs -I../.. \
+#         -o test_registers test_registers.cpp stubs/stubs.cpp \
+#         stubs/FakeL3G4200D.cpp ../../L3G4200D_U.cpp \
+#         ../../L3G4200D_BusGroup.cpp ../../L3G4200D_SampleClock.cpp \
+#         ../../L3G4200D_Telemetry.cpp
+#
+# The telemetry test also needs python3, to check that
+# extras/decode_telemetry.py decodes what the library writes, and so does
+# check_fixed_point.py, which needs objdump and nm as well. The Linux
+# backend in extras/linux has its own tests, which needs the Linux headers.
+#
+# Set CXX or CXXFLAGS to build with something else, such as
+# CXXFLAGS=-DL3G4200D_STATS=1.
+
+set -e
+
+cd "$(dirname "$0")"
+CXX=${CXX:-g++}
+OUT=${OUT:-build}
+mkdir -p "$OUT"
+
+LIBRARY="../../L3G4200D_U.cpp ../../L3G4200D_BusGroup.cpp \
+  ../../L3G4200D_SampleClock.cpp ../../L3G4200D_Telemetry.cpp \
+  stubs/stubs.cpp stubs/FakeL3G4200D.cpp"
+
+for test in test_*.cpp; do
+  name=${test%.cpp}
+  # shellcheck disable=SC2086
+  $CXX -std=gnu++11 -DARDUINO=10819 -Wall -Wextra -pthread \
+    -Istubs -I../.. $CXXFLAGS -o "$OUT/$name" "$test" $LIBRARY
+done
+
+# startRead() only runs in the background with L3G4200D_ASYNC_SPI, so build
+# its test that way too.
+# shellcheck disable=SC2086
+$CXX -std=gnu++11 -DARDUINO=10819 -DL3G4200D_ASYNC_SPI -Wall -Wextra -pthread \
+  -Istubs -I../.. $CXXFLAGS -o "$OUT/test_async_read_background" \
+  test_async_read.cpp $LIBRARY
+
+"$OUT/test_ring_buffer"
+"$OUT/test_sample_clock"
+"$OUT/test_auto_range"
+"$OUT/test_fake_gyro"
+"$OUT/test_registers"
+"$OUT/test_interrupt_capture"
+"$OUT/test_event_axes"
+"$OUT/test_calibration"
+"$OUT/test_duty_cycle"
+"$OUT/test_filters"
+"$OUT/test_bus_group"
+"$OUT/test_fixed_conversion"
+"$OUT/test_async_read"
+"$OUT/test_async_read_background"
+
+# The Linux backend's tests against a fake spidev, built like its capture
+# tool.
+for test in l3g4200d_capture_test l3g4200d_drain_test; do
+  # shellcheck disable=SC2086
+  $CXX -std=c++11 -O2 -pthread -I../.. $CXXFLAGS -o "$OUT/$test" \
+    "../linux/$test.cpp" ../linux/l3g4200d_fake_spidev.cpp \
+    ../linux/L3G4200D_Spidev.cpp ../linux/L3G4200D_LinuxCapture.cpp \
+    ../../L3G4200D_SampleClock.cpp
+  "$OUT/$test"
+done
+
+# The fixed-point read path mustn't do any floating point math, which on most
+# Arduino boards means pulling in soft float. Build it at -Os like the Arduino
+# IDE does, and follow it through the disassembly.
+mkdir -p "$OUT/fixed"
+for source in ../../L3G4200D_U.cpp ../../L3G4200D_SampleClock.cpp \
+  ../../L3G4200D_Telemetry.cpp; do
+  object="$OUT/fixed/$(basename "$source" .cpp).o"
+  # shellcheck disable=SC2086
+  $CXX -std=gnu++11 -DARDUINO=10819 -Os -Istubs -I../.. $CXXFLAGS \
+    -c -o "$object" "$source"
+done
+# shellcheck disable=SC2086
+$CXX -std=gnu++11 -DARDUINO=10819 -Os -Istubs -I../.. $CXXFLAGS \
+  -o "$OUT/fixed_point_path" fixed_point_path.cpp "$OUT"/fixed/*.o \
+  stubs/stubs.cpp stubs/FakeL3G4200D.cpp
+python3 check_fixed_point.py "$OUT/fixed_point_path" "$OUT"/fixed/*.o
+
+"$OUT/test_telemetry" "$OUT/telemetry.bin" "$OUT/telemetry.csv"
+python3 ../decode_telemetry.py --raw "$OUT/telemetry.bin" |
+  diff -u "$OUT/telemetry.csv" -
+echo "telemetry decoder: ok"
+
+# The benchmarks in bench_*.cpp each print JSON. Run them briefly, to check
+# they still build and work; run them by hand with more samples for numbers
+# worth comparing.
+for bench in bench_*.cpp; do
+  name=${bench%.cpp}
+  # shellcheck disable=SC2086
+  $CXX -std=gnu++11 -DARDUINO=10819 -O2 -Wall -Wextra -pthread \
+    -Istubs -I../.. $CXXFLAGS -o "$OUT/$name" "$bench" $LIBRARY
+done
+
+# And bench_get_event again with debug logging compiled out, to compare.
+# shellcheck disable=SC2086
+$CXX -std=gnu++11 -DARDUINO=10819 -DL3G4200D_DEBUG_LOGGING=0 -O2 -Wall \
+  -Wextra -pthread -Istubs -I../.. $CXXFLAGS \
+  -o "$OUT/bench_get_event_no_logging" bench_get_event.cpp $LIBRARY
+
+for bench in bench_fixed_point bench_get_event bench_get_event_no_logging \
+  bench_bus_traffic bench_template bench_transports; do
+  "$OUT/$bench" 100000 >"$OUT/$bench.json"
+  python3 -m json.tool "$OUT/$bench.json" >/dev/null
+done
+echo "benchmarks: ok"
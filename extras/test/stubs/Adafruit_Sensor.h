@@ -0,0 +1,73 @@
+/*!
+ * @file Adafruit_Sensor.h
+ *
+ * The parts of the Adafruit Unified Sensor Driver the library uses, laid out
+ * the same way, for the tests in extras/test.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TEST_ADAFRUIT_SENSOR_H
+#define L3G4200D_TEST_ADAFRUIT_SENSOR_H
+
+#include <stdint.h>
+
+/*! @brief The sensor type of a gyroscope. */
+#define SENSOR_TYPE_GYROSCOPE (4)
+
+/*! @brief A three-axis reading. */
+typedef struct {
+  union {
+    float v[3]; /*!< The axes as an array. */
+    struct {
+      float x; /*!< X axis. */
+      float y; /*!< Y axis. */
+      float z; /*!< Z axis. */
+    };
+  };
+  int8_t status;       /*!< Sensor status. */
+  uint8_t reserved[3]; /*!< Reserved. */
+} sensors_vec_t;
+
+/*! @brief One reading from a sensor. */
+typedef struct {
+  int32_t version;   /*!< Must be sizeof(sensors_event_t). */
+  int32_t sensor_id; /*!< The sensor's ID. */
+  int32_t type;      /*!< The sensor type. */
+  int32_t reserved0; /*!< Reserved. */
+  int32_t timestamp; /*!< When the reading was taken, in milliseconds. */
+  union {
+    float data[4];      /*!< The raw reading. */
+    sensors_vec_t gyro; /*!< The reading of a gyroscope, in rad/s. */
+  };
+} sensors_event_t;
+
+/*! @brief A description of a sensor. */
+typedef struct {
+  char name[12];     /*!< The sensor's name. */
+  int32_t version;   /*!< The driver version. */
+  int32_t sensor_id; /*!< The sensor's ID. */
+  int32_t type;      /*!< The sensor type. */
+  float max_value;   /*!< The largest reading. */
+  float min_value;   /*!< The smallest reading. */
+  float resolution;  /*!< The smallest difference between readings. */
+  int32_t min_delay; /*!< The shortest time between readings, in us. */
+} sensor_t;
+
+/*! @brief The base class of every unified sensor. */
+class Adafruit_Sensor {
+
+public:
+  virtual ~Adafruit_Sensor() {}
+
+  /*! @brief Enables or disables automatic ranging, if supported. */
+  virtual void enableAutoRange(bool enabled) { (void)enabled; }
+
+  /*! @brief Takes a reading. @returns True if it was taken. */
+  virtual bool getEvent(sensors_event_t *event) = 0;
+
+  /*! @brief Describes the sensor. */
+  virtual void getSensor(sensor_t *sensor) = 0;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*!
+ * @file Arduino.h
+ *
+ * Just enough of the Arduino core for the library to build and run on the
+ * host for the tests in extras/test. Time only moves when a test moves it,
+ * or by what the stubs charge for pin and bus operations (see
+ * @ref testTiming), and each pin can be a fake gyroscope's Chip Select (see
+ * FakeL3G4200D.h).
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TEST_ARDUINO_H
+#define L3G4200D_TEST_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Print.h"
+
+#define HIGH (1)
+#define LOW (0)
+#define INPUT (0)
+#define OUTPUT (1)
+#define MSBFIRST (1)
+#define CHANGE (1)
+#define FALLING (2)
+#define RISING (3)
+#define SPI_MODE3 (3)
+
+#define SCK (13)
+#define MOSI (11)
+#define MISO (12)
+
+/*! @brief The fake time, in microseconds, returned by micros(). Tests set
+ * it directly; delay() and delayMicroseconds() add to it. */
+extern uint32_t testMicros;
+
+/*! @brief What the stubs charge for each operation, in nanoseconds. The
+ * defaults are roughly a 16 MHz AVR's. */
+typedef struct {
+  uint32_t digitalWriteNanos;   /*!< One digitalWrite(). */
+  uint32_t digitalReadNanos;    /*!< One digitalRead(). */
+  uint32_t spiTransactionNanos; /*!< SPI.beginTransaction(). */
+  uint32_t spiByteGapNanos;     /*!< Between bytes, on top of 8 SPI clocks. */
+  uint32_t spiPollNanos;        /*!< One SPI.isBusy(). */
+} testTiming_t;
+
+/*! @brief The timing model. Tests can change it. */
+extern testTiming_t testTiming;
+
+/*! @brief Moves @ref testMicros on by @p nanos nanoseconds, keeping the
+ * fraction of a microsecond for next time, and lets the fake gyroscopes
+ * take the samples they're due as it goes, a microsecond at a time. */
+void testElapseNanos(uint32_t nanos);
+
+/*! @brief Returns the fake time in nanoseconds: @ref testMicros, plus the
+ * fraction testElapseNanos() is keeping. */
+uint64_t testNanos();
+
+/*! @brief Raises interrupt @p interruptNumber: runs its handler now, or
+ * when interrupts are next enabled, if they're off or masked by an open SPI
+ * transaction through SPIClass::usingInterrupt(). */
+void testRaiseInterrupt(int interruptNumber);
+
+/*! @brief Runs the handlers of any raised interrupts that are no longer
+ * held off. */
+void testRunPendingInterrupts();
+
+/*! @brief Does nothing. */
+void pinMode(uint8_t pin, uint8_t mode);
+
+/*! @brief Sets the pin's level. If a fake gyroscope's Chip Select is on the
+ * pin, LOW selects it and HIGH deselects it. */
+void digitalWrite(uint8_t pin, uint8_t val);
+
+/*! @brief Returns INT2 of the fake gyroscope wired to the pin, or the level
+ * last written to it (HIGH to start with). */
+int digitalRead(uint8_t pin);
+
+/*! @brief Every pin can be an interrupt, with the same number. */
+#define digitalPinToInterrupt(pin) (pin)
+
+/*! @brief Sets the handler for @p interruptNumber. The mode is ignored: the
+ * fake gyroscopes only raise interrupts on rising edges. */
+void attachInterrupt(uint8_t interruptNumber, void (*isr)(), int mode);
+
+/*! @brief Takes away the handler for @p interruptNumber. */
+void detachInterrupt(uint8_t interruptNumber);
+
+/*! @brief Returns @ref testMicros. */
+uint32_t micros();
+
+/*! @brief Returns @ref testMicros in milliseconds. */
+uint32_t millis();
+
+/*! @brief Adds @p ms milliseconds to @ref testMicros, like
+ * testElapseNanos(). */
+void delay(uint32_t ms);
+
+/*! @brief Adds @p us microseconds to @ref testMicros, like
+ * testElapseNanos(). */
+void delayMicroseconds(unsigned int us);
+
+/*! @brief Holds off interrupts until interrupts(). */
+void noInterrupts();
+
+/*! @brief Enables interrupts, running any that were held off. */
+void interrupts();
+
+#endif
@@ -0,0 +1,595 @@
+#include "Arduino.h"
+#include "FakeL3G4200D.h"
+#include "L3G4200D_Registers.h"
+
+#include <math.h>
+
+// Every fake, so Chip Select and the bus can find them by pin.
+static std::vector<FakeL3G4200D *> &fakes() {
+  static std::vector<FakeL3G4200D *> all;
+  return all;
+}
+
+// The sensitivity at each full scale, in millidegrees per second per count,
+// from the datasheet.
+static double sensitivityMdps(uint8_t ctrl4) {
+  switch (ctrl4 & CTRL4_FULL_SCALE_MASK) {
+  case CTRL4_FULL_SCALE_250DPS:
+    return 8.75;
+  case CTRL4_FULL_SCALE_500DPS:
+    return 17.5;
+  default:
+    return 70.0;
+  }
+}
+
+static const uint32_t NOT_READ = 0xffffffff;
+
+FakeL3G4200D::FakeL3G4200D(int csPin)
+    : csPin(csPin), int2Pin(-1), sckPin(-1), copiPin(-1), cipoPin(-1),
+      i2cAddress(-1) {
+  fakes().push_back(this);
+  reset();
+}
+
+FakeL3G4200D::~FakeL3G4200D() {
+  std::vector<FakeL3G4200D *> &all = fakes();
+  for (size_t i = 0; i < all.size(); i++) {
+    if (all[i] == this) {
+      all.erase(all.begin() + i);
+      break;
+    }
+  }
+}
+
+FakeL3G4200D *FakeL3G4200D::onPin(int pin) {
+  std::vector<FakeL3G4200D *> &all = fakes();
+  for (size_t i = 0; i < all.size(); i++) {
+    if (all[i]->csPin == pin) {
+      return all[i];
+    }
+  }
+  return NULL;
+}
+
+FakeL3G4200D *FakeL3G4200D::atI2cAddress(uint8_t address) {
+  std::vector<FakeL3G4200D *> &all = fakes();
+  for (size_t i = 0; i < all.size(); i++) {
+    if (all[i]->i2cAddress == address) {
+      return all[i];
+    }
+  }
+  return NULL;
+}
+
+void FakeL3G4200D::updateAll() {
+  std::vector<FakeL3G4200D *> &all = fakes();
+  for (size_t i = 0; i < all.size(); i++) {
+    all[i]->update();
+  }
+}
+
+const std::vector<FakeL3G4200D *> &FakeL3G4200D::all() { return fakes(); }
+
+void FakeL3G4200D::reset() {
+  memset(regs, 0, sizeof(regs));
+  regs[REG_WHO_AM_I] = L3G4200D_CHIP_ID;
+  regs[REG_CTRL_1] = CTRL1_POWER_DOWN | CTRL1_X_ENABLE | CTRL1_Y_ENABLE |
+                     CTRL1_Z_ENABLE;
+  _fifo.clear();
+  _haveCommand = false;
+  selected = false;
+  _sckHigh = true;
+  _bitCount = 0;
+  _shiftIn = 0;
+  _shiftOut = 0;
+
+  _trace = NULL;
+  _traceContext = NULL;
+  _lastMicros = micros();
+  _nowNanos = 0;
+  _nextSampleNanos = 0;
+  _junkUntilNanos = 0;
+  _junkLeft = 0;
+  _noiseState = 1;
+  _updating = false;
+  memset(&_held, 0, sizeof(_held));
+
+  _latchedAxis = -1;
+  _havePending = false;
+  _outSerial = 0;
+  for (int i = 0; i < 3; i++) {
+    _lowByteSerial[i] = NOT_READ;
+    zeroRateDps[i] = 0;
+  }
+  _int2 = false;
+  for (int i = 0; i < 3; i++) {
+    _highPassIn[i] = _highPassOut[i] = _lowPassOut[i] = 0;
+  }
+
+  noiseCounts = 0;
+  clockErrorPpm = 0;
+  turnOnMicros = 0;
+  sleepWakeSamples = 0;
+  junk.x = junk.y = junk.z = INT16_MIN;
+  lastSampleMicros = _lastMicros;
+
+  clearLog();
+}
+
+void FakeL3G4200D::clearLog() {
+  frames.clear();
+  samplesTaken = 0;
+  junkSamples = 0;
+  samplesLost = 0;
+  tornReads = 0;
+}
+
+void FakeL3G4200D::setSample(int16_t x, int16_t y, int16_t z) {
+  fakeGyroSample_t sample = {x, y, z};
+  writeOutputs(sample);
+  updateInt2();
+}
+
+void FakeL3G4200D::pushFifo(int16_t x, int16_t y, int16_t z) {
+  if (_fifo.size() == L3G4200D_FIFO_DEPTH) {
+    _fifo.pop_front();
+  }
+  fakeGyroSample_t sample = {x, y, z};
+  _fifo.push_back(sample);
+  updateInt2();
+}
+
+size_t FakeL3G4200D::fifoLevel() const { return _fifo.size(); }
+
+void FakeL3G4200D::setRateTrace(fakeRateTrace_t trace, void *context) {
+  syncClock();
+  if (_trace == NULL) {
+    _nextSampleNanos = _nowNanos + samplePeriodNanos();
+  }
+  _trace = trace;
+  _traceContext = context;
+}
+
+uint32_t FakeL3G4200D::samplePeriodNanos() const {
+  // 100, 200, 400, or 800 Hz.
+  uint32_t hz = 100 << ((regs[REG_CTRL_1] & CTRL1_RATE_MASK) >> 6);
+  int64_t period = 1000000000 / hz;
+  return (uint32_t)(period + period * clockErrorPpm / 1000000);
+}
+
+bool FakeL3G4200D::int2() const { return _int2; }
+
+void FakeL3G4200D::update() {
+  if (_updating) {
+    return;
+  }
+  _updating = true;
+  syncClock();
+
+  while (_trace != NULL && power() == NORMAL &&
+         _nextSampleNanos <= _nowNanos) {
+    uint64_t takenNanos = _nextSampleNanos;
+    _nextSampleNanos += samplePeriodNanos();
+
+    fakeGyroSample_t sample;
+    if (takenNanos < _junkUntilNanos || _junkLeft > 0) {
+      sample = junk;
+      junkSamples++;
+      if (_junkLeft > 0) {
+        _junkLeft--;
+      }
+    } else {
+      sample = sampleTrace(takenNanos);
+    }
+
+    samplesTaken++;
+    lastSampleMicros =
+        _lastMicros - (uint32_t)((_nowNanos - takenNanos) / 1000);
+    takeSample(sample);
+  }
+
+  _updating = false;
+}
+
+void FakeL3G4200D::select() {
+  update();
+  if (selected) {
+    return;
+  }
+  selected = true;
+  _haveCommand = false;
+  _bitCount = 0;
+  frames.push_back(std::vector<uint8_t>());
+}
+
+void FakeL3G4200D::deselect() {
+  if (!selected) {
+    return;
+  }
+  selected = false;
+  updateInt2();
+}
+
+uint8_t FakeL3G4200D::exchange(uint8_t data) {
+  uint8_t response = startByte();
+  finishByte(data);
+  return response;
+}
+
+void FakeL3G4200D::clockSck(bool high, bool copi) {
+  bool falling = _sckHigh && !high;
+  bool rising = !_sckHigh && high;
+  _sckHigh = high;
+  if (!selected) {
+    return;
+  }
+
+  // Mode 3: the chip shifts its next bit out on the falling edge, and takes
+  // ours in on the rising edge.
+  if (falling) {
+    _shiftOut = (_bitCount == 0) ? startByte() : (uint8_t)(_shiftOut << 1);
+  }
+  if (rising) {
+    _shiftIn = (uint8_t)((_shiftIn << 1) | (copi ? 1 : 0));
+    if (++_bitCount == 8) {
+      finishByte(_shiftIn);
+      _bitCount = 0;
+      _shiftIn = 0;
+    }
+  }
+}
+
+bool FakeL3G4200D::cipo() const {
+  return selected && (_shiftOut & 0x80);
+}
+
+uint8_t FakeL3G4200D::startByte() {
+  update();
+  if (!selected || !_haveCommand || !_read) {
+    // The first byte of each frame is the command, and what comes back
+    // during it is garbage, as it is while writing.
+    return 0;
+  }
+
+  uint8_t response = readRegister(_address);
+  nextAddress();
+  return response;
+}
+
+void FakeL3G4200D::finishByte(uint8_t data) {
+  if (!selected) {
+    return;
+  }
+
+  frames.back().push_back(data);
+
+  if (!_haveCommand) {
+    _haveCommand = true;
+    _read = data & 0x80;
+    _autoIncrement = data & 0x40;
+    _address = data & 0x3f;
+    return;
+  }
+
+  if (!_read) {
+    writeRegister(_address, data);
+    nextAddress();
+  }
+}
+
+void FakeL3G4200D::nextAddress() {
+  if (!_autoIncrement) {
+    return;
+  }
+  if (_read && fifoEnabled() && _address == REG_OUT_Z_H) {
+    _address = REG_OUT_X_L;
+    if (!_fifo.empty()) {
+      _fifo.pop_front();
+    }
+  } else {
+    _address = (_address + 1) & 0x3f;
+  }
+}
+
+FakeL3G4200D::power_t FakeL3G4200D::power() const {
+  // The power-down bit is the one sleep sets without any axes.
+  uint8_t ctrl1 = regs[REG_CTRL_1];
+  if (!(ctrl1 & CTRL1_SLEEP)) {
+    return POWER_DOWN;
+  }
+  uint8_t axes = CTRL1_X_ENABLE | CTRL1_Y_ENABLE | CTRL1_Z_ENABLE;
+  return (ctrl1 & axes) ? NORMAL : SLEEP;
+}
+
+bool FakeL3G4200D::fifoEnabled() const {
+  return regs[REG_CTRL_5] & CTRL5_FIFO_ENABLE;
+}
+
+uint8_t FakeL3G4200D::fifoMode() const {
+  return regs[REG_FIFO_CTRL] & ~FIFO_CTRL_WATERMARK_MASK;
+}
+
+void FakeL3G4200D::syncClock() {
+  uint32_t now = micros();
+  _nowNanos += (uint64_t)(uint32_t)(now - _lastMicros) * 1000;
+  _lastMicros = now;
+}
+
+void FakeL3G4200D::startClock(power_t from) {
+  // The first sample comes a whole period after the chip starts, or the
+  // rate changes.
+  _nextSampleNanos = _nowNanos + samplePeriodNanos();
+  if (from == POWER_DOWN) {
+    _junkUntilNanos = _nowNanos + (uint64_t)turnOnMicros * 1000;
+  } else if (from == SLEEP) {
+    _junkLeft = sleepWakeSamples;
+  }
+}
+
+fakeGyroSample_t FakeL3G4200D::sampleTrace(uint64_t nanos) {
+  double dps[3] = {0, 0, 0};
+  _trace(_lastMicros - (uint32_t)((_nowNanos - nanos) / 1000), dps,
+         _traceContext);
+
+  double sensitivity = sensitivityMdps(regs[REG_CTRL_4]) / 1000;
+  int16_t *held[3] = {&_held.x, &_held.y, &_held.z};
+  for (int i = 0; i < 3; i++) {
+    // Disabled axes keep what they had.
+    if (!(regs[REG_CTRL_1] & (CTRL1_X_ENABLE << i))) {
+      continue;
+    }
+
+    double input = (dps[i] + zeroRateDps[i]) / sensitivity;
+    if (noiseCounts > 0) {
+      uint32_t spread = 2 * noiseCounts + 1;
+      _noiseState = _noiseState * 1664525 + 1013904223;
+      input += (double)((_noiseState >> 8) % spread) - noiseCounts;
+    }
+    long counts = lround(filter(i, input));
+    if (counts > INT16_MAX) {
+      counts = INT16_MAX;
+    } else if (counts < INT16_MIN) {
+      counts = INT16_MIN;
+    }
+    *held[i] = (int16_t)counts;
+  }
+
+  return _held;
+}
+
+double FakeL3G4200D::highPassCutoffHz() const {
+  // Table 27 of the datasheet: a row for each HPCF value, and a column for
+  // each output data rate. HPCF values past the end aren't defined.
+  static const double CUTOFF_HZ[10][4] = {
+      {8, 15, 30, 56},           {4, 8, 15, 30},        {2, 4, 8, 15},
+      {1, 2, 4, 8},              {0.5, 1, 2, 4},        {0.2, 0.5, 1, 2},
+      {0.1, 0.2, 0.5, 1},        {0.05, 0.1, 0.2, 0.5}, {0.02, 0.05, 0.1, 0.2},
+      {0.01, 0.02, 0.05, 0.1}};
+  int hpcf = regs[REG_CTRL_2] & CTRL2_HIGH_PASS_DIV_MASK;
+  int rate = (regs[REG_CTRL_1] & CTRL1_RATE_MASK) >> 6;
+  return CUTOFF_HZ[hpcf < 10 ? hpcf : 9][rate];
+}
+
+double FakeL3G4200D::lowPassCutoffHz() const {
+  // Table 21 of the datasheet: a row for each output data rate, and a column
+  // for each bandwidth.
+  static const double CUTOFF_HZ[4][4] = {{12.5, 25, 25, 25},
+                                         {12.5, 25, 50, 70},
+                                         {20, 25, 50, 110},
+                                         {30, 35, 50, 110}};
+  int rate = (regs[REG_CTRL_1] & CTRL1_RATE_MASK) >> 6;
+  int bandwidth = (regs[REG_CTRL_1] & CTRL1_CUTOFF_MASK) >> 4;
+  return CUTOFF_HZ[rate][bandwidth];
+}
+
+double FakeL3G4200D::filter(int axis, double counts) {
+  double hz = 1e9 / samplePeriodNanos();
+  uint8_t ctrl5 = regs[REG_CTRL_5];
+
+  // One-pole filters, with their coefficients worked out so that the gain
+  // at the cutoff is exactly 1/sqrt(2). Both run all the time, whichever
+  // path is selected, like the real chip's.
+  double c = cos(2 * M_PI * highPassCutoffHz() / hz);
+  double alpha = 1 / (c + sqrt((1 - c) * (3 - c)));
+  double highPass = alpha * (_highPassOut[axis] + counts - _highPassIn[axis]);
+  _highPassIn[axis] = counts;
+  _highPassOut[axis] = highPass;
+
+  uint8_t mode = regs[REG_CTRL_2] & CTRL2_HIGH_PASS_MODE_MASK;
+  if (mode == CTRL2_HIGH_PASS_MODE_REFERENCE) {
+    highPass = counts - 256.0 * (int8_t)regs[REG_REFERENCE];
+  }
+
+  // HPen picks what goes into the second low pass filter.
+  bool highPassEnabled = ctrl5 & (0b1 << 4);
+  double lowPassIn = highPassEnabled ? highPass : counts;
+  c = cos(2 * M_PI * lowPassCutoffHz() / hz);
+  double a = (2 - c) - sqrt((2 - c) * (2 - c) - 1);
+  _lowPassOut[axis] += (1 - a) * (lowPassIn - _lowPassOut[axis]);
+
+  // And Out_Sel picks which filter's output comes out.
+  switch (ctrl5 & 0b11) {
+  case 0b00:
+    return counts;
+  case 0b01:
+    return highPass;
+  default:
+    return _lowPassOut[axis];
+  }
+}
+
+void FakeL3G4200D::takeSample(const fakeGyroSample_t &sample) {
+  if (fifoEnabled() && fifoMode() != FIFO_CTRL_MODE_BYPASS) {
+    if (_fifo.size() == L3G4200D_FIFO_DEPTH) {
+      samplesLost++;
+      // FIFO mode stops when it's full; the streaming modes lose the oldest.
+      if (fifoMode() == FIFO_CTRL_MODE_FIFO) {
+        updateInt2();
+        return;
+      }
+      _fifo.pop_front();
+    }
+    _fifo.push_back(sample);
+  } else {
+    if (regs[REG_STATUS] & STATUS_XYZ_NEW_DATA) {
+      samplesLost++;
+    }
+    writeOutputs(sample);
+  }
+  updateInt2();
+}
+
+void FakeL3G4200D::writeOutputs(const fakeGyroSample_t &sample) {
+  // With block data update, hold it until the high byte being waited for has
+  // been read.
+  if ((regs[REG_CTRL_4] & CTRL4_BLOCK_DATA_UPDATE_MASK) && _latchedAxis >= 0) {
+    _pending = sample;
+    _havePending = true;
+    return;
+  }
+
+  int16_t axes[3] = {sample.x, sample.y, sample.z};
+  for (int i = 0; i < 3; i++) {
+    regs[REG_OUT_X_L + 2 * i] = (uint8_t)axes[i];
+    regs[REG_OUT_X_L + 2 * i + 1] = (uint8_t)(axes[i] >> 8);
+  }
+  _outSerial++;
+
+  // New data, and overrun as well if the last sample was never read.
+  if (regs[REG_STATUS] & STATUS_XYZ_NEW_DATA) {
+    regs[REG_STATUS] |= STATUS_XYZ_OVERRUN | STATUS_Z_OVERRUN |
+                        STATUS_Y_OVERRUN | STATUS_X_OVERRUN;
+  }
+  regs[REG_STATUS] |= STATUS_XYZ_NEW_DATA | STATUS_Z_NEW_DATA |
+                      STATUS_Y_NEW_DATA | STATUS_X_NEW_DATA;
+}
+
+void FakeL3G4200D::updateInt2() {
+  uint8_t ctrl3 = regs[REG_CTRL_3];
+  size_t level = _fifo.size();
+  bool fifo = fifoEnabled() && fifoMode() != FIFO_CTRL_MODE_BYPASS;
+  size_t watermark = regs[REG_FIFO_CTRL] & FIFO_CTRL_WATERMARK_MASK;
+
+  bool high = false;
+  if (ctrl3 & CTRL3_I2_DATA_READY) {
+    high |= fifo ? level > 0 : (regs[REG_STATUS] & STATUS_XYZ_NEW_DATA) != 0;
+  }
+  if (fifo && (ctrl3 & CTRL3_I2_WATERMARK)) {
+    high |= level >= watermark;
+  }
+  if (fifo && (ctrl3 & CTRL3_I2_OVERRUN)) {
+    high |= level >= L3G4200D_FIFO_DEPTH;
+  }
+  if (fifo && (ctrl3 & CTRL3_I2_EMPTY)) {
+    high |= level == 0;
+  }
+
+  bool rising = high && !_int2;
+  _int2 = high;
+  if (rising && int2Pin >= 0) {
+    testRaiseInterrupt(digitalPinToInterrupt(int2Pin));
+  }
+}
+
+uint8_t FakeL3G4200D::readRegister(uint8_t address) {
+  if (address >= REG_OUT_X_L && address <= REG_OUT_Z_H && fifoEnabled()) {
+    if (_fifo.empty()) {
+      return 0;
+    }
+    const fakeGyroSample_t &sample = _fifo.front();
+    int16_t axes[3] = {sample.x, sample.y, sample.z};
+    int16_t axis = axes[(address - REG_OUT_X_L) / 2];
+    return (address & 1) ? (uint8_t)(axis >> 8) : (uint8_t)axis;
+  }
+
+  if (address == REG_FIFO_SRC) {
+    // The level only counts to 31; a full FIFO sets the overrun bit instead.
+    size_t level = _fifo.size();
+    uint8_t watermark = regs[REG_FIFO_CTRL] & FIFO_CTRL_WATERMARK_MASK;
+    uint8_t fifoSrc = (uint8_t)level;
+    if (level >= L3G4200D_FIFO_DEPTH) {
+      fifoSrc = FIFO_SRC_OVERRUN | FIFO_SRC_LEVEL_MASK;
+    }
+    if (level == 0) {
+      fifoSrc |= FIFO_SRC_EMPTY;
+    }
+    if (level >= watermark) {
+      fifoSrc |= FIFO_SRC_WATERMARK;
+    }
+    return fifoSrc;
+  }
+
+  uint8_t value = regs[address];
+
+  // In normal-reset mode, reading REFERENCE starts the high pass filter
+  // over from the current input.
+  uint8_t highPassMode = regs[REG_CTRL_2] & CTRL2_HIGH_PASS_MODE_MASK;
+  if (address == REG_REFERENCE &&
+      highPassMode == CTRL2_HIGH_PASS_MODE_NORMAL_RESET) {
+    for (int i = 0; i < 3; i++) {
+      _highPassOut[i] = 0;
+    }
+  }
+
+  // Data ready drops before a sample held off by block data update comes in
+  // below, so that raises it again.
+  if (address == REG_OUT_Z_H) {
+    regs[REG_STATUS] = 0;
+    updateInt2();
+  }
+
+  if (address >= REG_OUT_X_L && address <= REG_OUT_Z_H) {
+    int axis = (address - REG_OUT_X_L) / 2;
+    if (!(address & 1)) {
+      _lowByteSerial[axis] = _outSerial;
+      if (regs[REG_CTRL_4] & CTRL4_BLOCK_DATA_UPDATE_MASK) {
+        _latchedAxis = axis;
+      }
+    } else {
+      if (_lowByteSerial[axis] != NOT_READ &&
+          _lowByteSerial[axis] != _outSerial) {
+        tornReads++;
+      }
+      _lowByteSerial[axis] = NOT_READ;
+
+      if (_latchedAxis == axis) {
+        _latchedAxis = -1;
+        if (_havePending) {
+          _havePending = false;
+          writeOutputs(_pending);
+          updateInt2();
+        }
+      }
+    }
+  }
+
+  return value;
+}
+
+void FakeL3G4200D::writeRegister(uint8_t address, uint8_t value) {
+  // WHO_AM_I, STATUS_REG, the outputs, and FIFO_SRC_REG are read-only.
+  if (address == REG_WHO_AM_I ||
+      (address >= REG_STATUS && address <= REG_OUT_Z_H) ||
+      address == REG_FIFO_SRC) {
+    return;
+  }
+
+  // Samples due before the change are taken with the old settings.
+  power_t from = power();
+  uint8_t rate = regs[REG_CTRL_1] & CTRL1_RATE_MASK;
+
+  regs[address] = value;
+
+  if (address == REG_CTRL_1 && power() == NORMAL &&
+      (from != NORMAL || (value & CTRL1_RATE_MASK) != rate)) {
+    startClock(from);
+  }
+
+  if (address == REG_FIFO_CTRL &&
+      (value & ~FIFO_CTRL_WATERMARK_MASK) == FIFO_CTRL_MODE_BYPASS) {
+    _fifo.clear();
+  }
+
+  updateInt2();
+}
@@ -0,0 +1,284 @@
+/*!
+ * @file FakeL3G4200D.h
+ *
+ * A fake L3G4200D for the tests in extras/test: a register file behind a
+ * Chip Select pin, with a model of when the real chip takes its samples.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TEST_FAKE_L3G4200D_H
+#define L3G4200D_TEST_FAKE_L3G4200D_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+/*! @brief One sample, as the fake gyroscope keeps it. */
+typedef struct {
+  int16_t x; /*!< X axis. */
+  int16_t y; /*!< Y axis. */
+  int16_t z; /*!< Z axis. */
+} fakeGyroSample_t;
+
+/*! @brief An angular rate trace: fills in @p dps with the rate about each
+ * axis, in degrees per second, at time @p micros (on the micros() clock). */
+typedef void (*fakeRateTrace_t)(uint32_t micros, double dps[3], void *context);
+
+/*!
+ * @brief A fake L3G4200D on its own Chip Select pin.
+ *
+ * It decodes the command byte (read bit, auto-increment bit, and register
+ * address) and keeps a register file. With the FIFO enabled in CTRL_REG5,
+ * the output registers read from the FIFO, and an auto-increment read wraps
+ * from OUT_Z_H back to OUT_X_L, popping a sample, like the real chip.
+ * FIFO_SRC_REG is worked out from the FIFO, and going into bypass mode
+ * empties it. Reading OUT_Z_H outside FIFO mode clears STATUS_REG.
+ *
+ * Samples come from one of two places. Tests can put them in by hand with
+ * setSample() and pushFifo(), or give the fake a rate trace with
+ * setRateTrace(), after which it takes a sample from the trace at each tick
+ * of its output data rate as the micros() clock moves, like the real chip:
+ * only in normal mode, at the rate set in CTRL_REG1, scaled to the range in
+ * CTRL_REG4, with a zero-rate offset and noise. Until the turn-on time has
+ * passed after power down, and for the first few samples after sleep, it
+ * gives @ref junk instead.
+ *
+ * Samples from the trace go through the filters CTRL_REG5 selects, on their
+ * way to both the output registers and the FIFO: the high pass filter, at
+ * the cutoff CTRL_REG2 sets, and the second low pass filter, at the cutoff
+ * the bandwidth in CTRL_REG1 sets, both from the datasheet's tables. Each is
+ * a one-pole filter, tuned so its response is down 3 dB at the cutoff. The
+ * first low pass filter, which is always on, isn't modelled, since the
+ * datasheet doesn't give its cutoff. The high pass filter resets when
+ * REFERENCE is read in normal-reset mode, and reference mode subtracts
+ * REFERENCE from the high byte; the datasheet doesn't say how its 8 bits
+ * line up with the output. Autoreset works like normal mode, since the fake
+ * has no interrupt generator to reset it.
+ *
+ * With block data update on in CTRL_REG4, reading the low byte of an output
+ * register holds off new samples until the high byte has been read;
+ * without it, a sample that arrives in between tears the reading.
+ *
+ * INT2 follows CTRL_REG3, and raises the interrupt for @ref int2Pin when it
+ * goes high.
+ *
+ * Bytes usually come from the SPI stand-in, but with @ref sckPin set the
+ * fake also decodes SPI bit-banged through digitalWrite() and digitalRead()
+ * (mode 3, MSB first) on @ref sckPin, @ref copiPin and @ref cipoPin. With
+ * @ref i2cAddress set, it answers the I2C stand-in in Wire.h, which turns
+ * each I2C transfer into the frame SPI would have sent.
+ *
+ * Everything sent to it is logged, one entry per Chip Select frame, so tests
+ * can check the library's register traffic.
+ */
+class FakeL3G4200D {
+
+public:
+  /*! @brief Puts a fake on Chip Select pin @p csPin. */
+  explicit FakeL3G4200D(int csPin);
+
+  ~FakeL3G4200D();
+
+  /*! @brief Returns the fake on Chip Select pin @p pin, or NULL. */
+  static FakeL3G4200D *onPin(int pin);
+
+  /*! @brief Returns the fake at I2C address @p address, or NULL. */
+  static FakeL3G4200D *atI2cAddress(uint8_t address);
+
+  /*! @brief Returns every fake. */
+  static const std::vector<FakeL3G4200D *> &all();
+
+  /*! @brief Takes the samples every fake is due, up to micros(). The stubs
+   * call it whenever time moves. */
+  static void updateAll();
+
+  /*! @brief Takes the samples this fake is due, up to micros(). */
+  void update();
+
+  /*! @brief Puts the fake back to how it is at power on, with the default
+   * settings below and no rate trace, and clears the log. */
+  void reset();
+
+  /*! @brief Clears the log and counters, but not the registers or the
+   * FIFO. */
+  void clearLog();
+
+  /*! @brief Makes a new sample available in the output registers, and sets
+   * the new data bit in STATUS_REG (or the overrun bit, if the last one was
+   * never read). */
+  void setSample(int16_t x, int16_t y, int16_t z);
+
+  /*! @brief Adds a sample to the FIFO. If it's full, the oldest sample is
+   * lost, as in stream mode. */
+  void pushFifo(int16_t x, int16_t y, int16_t z);
+
+  /*! @brief Returns the number of samples in the FIFO. */
+  size_t fifoLevel() const;
+
+  /*! @brief Starts taking samples from @p trace at the output data rate, or
+   * stops if it's NULL. */
+  void setRateTrace(fakeRateTrace_t trace, void *context = NULL);
+
+  /*! @brief Returns the sample period for the output data rate in CTRL_REG1,
+   * in nanoseconds, including @ref clockErrorPpm. */
+  uint32_t samplePeriodNanos() const;
+
+  /*! @brief Returns whether INT2 is high. */
+  bool int2() const;
+
+  /*! @brief Asserts Chip Select, starting a new frame. */
+  void select();
+
+  /*! @brief Releases Chip Select. */
+  void deselect();
+
+  /*! @brief Clocks one byte in, and returns the one clocked out. */
+  uint8_t exchange(uint8_t data);
+
+  /*! @brief Moves the bit-banged SPI clock to @p high, with COPI at
+   * @p copi. */
+  void clockSck(bool high, bool copi);
+
+  /*! @brief Returns the bit the fake is driving on CIPO. */
+  bool cipo() const;
+
+  /*! @brief The register file. */
+  uint8_t regs[0x40];
+
+  /*! @brief Every byte sent with Chip Select asserted, one entry per
+   * frame. */
+  std::vector<std::vector<uint8_t>> frames;
+
+  /*! @brief Whether Chip Select is asserted. */
+  bool selected;
+
+  /*! @brief The Chip Select pin. */
+  const int csPin;
+
+  /*! @brief The pin INT2 is wired to, or -1. */
+  int int2Pin;
+
+  /*! @brief The bit-banged SPI clock pin, or -1 for the SPI stand-in. */
+  int sckPin;
+
+  /*! @brief The bit-banged SPI COPI (MOSI) pin, or -1. */
+  int copiPin;
+
+  /*! @brief The bit-banged SPI CIPO (MISO) pin, or -1. */
+  int cipoPin;
+
+  /*! @brief The I2C address it answers at, or -1. */
+  int i2cAddress;
+
+  /*! @brief The zero-rate offset of each axis, in degrees per second. */
+  double zeroRateDps[3];
+
+  /*! @brief Peak noise added to each axis, in counts. */
+  int noiseCounts;
+
+  /*! @brief How fast the chip's clock runs, in parts per million: positive
+   * means samples come further apart than the nominal rate. */
+  int32_t clockErrorPpm;
+
+  /*! @brief How long after leaving power down it gives @ref junk, in
+   * microseconds. */
+  uint32_t turnOnMicros;
+
+  /*! @brief How many samples after leaving sleep it gives @ref junk. */
+  uint32_t sleepWakeSamples;
+
+  /*! @brief What it gives while it's settling. */
+  fakeGyroSample_t junk;
+
+  /*! @brief Samples taken from the rate trace, including junk. */
+  uint32_t samplesTaken;
+
+  /*! @brief Junk samples taken. */
+  uint32_t junkSamples;
+
+  /*! @brief Samples taken from the trace that were lost, because the
+   * output registers were never read or the FIFO was full. */
+  uint32_t samplesLost;
+
+  /*! @brief Readings of an output register that came from two different
+   * samples. */
+  uint32_t tornReads;
+
+  /*! @brief When the newest sample was taken, on the micros() clock. */
+  uint32_t lastSampleMicros;
+
+private:
+  enum power_t { POWER_DOWN, SLEEP, NORMAL };
+
+  std::deque<fakeGyroSample_t> _fifo;
+
+  // The command byte of the current frame, once it has arrived.
+  bool _haveCommand;
+  bool _read;
+  bool _autoIncrement;
+  uint8_t _address;
+
+  // Bit-banged SPI: the clock level, and the byte being shifted each way.
+  bool _sckHigh;
+  uint8_t _bitCount;
+  uint8_t _shiftIn;
+  uint8_t _shiftOut;
+
+  // The rate trace, and the tick model that samples it.
+  fakeRateTrace_t _trace;
+  void *_traceContext;
+  uint32_t _lastMicros;
+  uint64_t _nowNanos;
+  uint64_t _nextSampleNanos;
+  uint64_t _junkUntilNanos;
+  uint32_t _junkLeft;
+  uint32_t _noiseState;
+  bool _updating;
+  fakeGyroSample_t _held;
+
+  // Block data update: which output register's high byte is still to come,
+  // and the sample held off until it's read.
+  int _latchedAxis;
+  bool _havePending;
+  fakeGyroSample_t _pending;
+
+  // Which sample each output register's low byte came from, for spotting
+  // torn readings.
+  uint32_t _outSerial;
+  uint32_t _lowByteSerial[3];
+
+  bool _int2;
+
+  // The filters' state on each axis: the high pass filter's last input and
+  // output, and the second low pass filter's last output, in counts.
+  double _highPassIn[3];
+  double _highPassOut[3];
+  double _lowPassOut[3];
+
+  power_t power() const;
+  bool fifoEnabled() const;
+  uint8_t fifoMode() const;
+  void syncClock();
+  void startClock(power_t from);
+  fakeGyroSample_t sampleTrace(uint64_t nanos);
+  double highPassCutoffHz() const;
+  double lowPassCutoffHz() const;
+  double filter(int axis, double counts);
+  void takeSample(const fakeGyroSample_t &sample);
+  void writeOutputs(const fakeGyroSample_t &sample);
+  void updateInt2();
+  uint8_t readRegister(uint8_t address);
+  void writeRegister(uint8_t address, uint8_t value);
+
+  // exchange() in two halves, since bit-banged SPI needs the byte going out
+  // before the one coming in has arrived: startByte() returns the byte the
+  // chip sends, and finishByte() takes the one it receives.
+  uint8_t startByte();
+  void finishByte(uint8_t data);
+  void nextAddress();
+};
+
+#endif
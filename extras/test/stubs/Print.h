@@ -0,0 +1,67 @@
+/*!
+ * @file Print.h
+ *
+ * The parts of the Arduino core's Print class the library uses, for the
+ * tests in extras/test.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TEST_PRINT_H
+#define L3G4200D_TEST_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*! @brief Something bytes can be written to, like the Arduino core's. */
+class Print {
+
+public:
+  virtual ~Print() {}
+
+  /*! @brief Writes one byte.
+   * @returns The number of bytes written. */
+  virtual size_t write(uint8_t byte) = 0;
+
+  /*! @brief Writes @p size bytes, one at a time.
+   * @returns The number of bytes written. */
+  virtual size_t write(const uint8_t *buffer, size_t size);
+
+  /*! @brief Returns how many bytes can be written without blocking. */
+  virtual int availableForWrite() { return 0; }
+
+  /*! @brief Writes a string. @returns The number of bytes written. */
+  size_t print(const char str[]);
+
+  /*! @brief Writes a number in decimal. @returns The number of bytes
+   * written. */
+  size_t print(long val);
+
+  /*! @brief Writes a number in decimal. @returns The number of bytes
+   * written. */
+  size_t print(int val) { return print((long)val); }
+
+  /*! @brief Writes a string and a newline. @returns The number of bytes
+   * written. */
+  size_t println(const char str[] = "");
+};
+
+/*! @brief A serial port that writes to standard error, so debug logging
+ * doesn't get mixed into anything a test writes to standard output. */
+class HardwareSerial : public Print {
+
+public:
+  /*! @brief Does nothing. */
+  void begin(unsigned long baud) { (void)baud; }
+
+  /*! @brief Writes @p byte to standard error. @returns 1. */
+  size_t write(uint8_t byte);
+
+  /*! @brief Returns a typical hardware serial buffer size. */
+  int availableForWrite() { return 63; }
+};
+
+/*! @brief The default serial port. */
+extern HardwareSerial Serial;
+
+#endif
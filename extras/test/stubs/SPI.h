@@ -0,0 +1,145 @@
+/*!
+ * @file SPI.h
+ *
+ * An Arduino SPI class for the tests in extras/test, wired to the fake
+ * L3G4200Ds in FakeL3G4200D.h instead of a bus.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TEST_SPI_H
+#define L3G4200D_TEST_SPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FakeL3G4200D.h"
+
+// Like the AVR and SAMD cores, so the library pairs usingInterrupt() with
+// notUsingInterrupt().
+#define SPI_HAS_NOTUSINGINTERRUPT (1)
+
+/*! @brief SPI clock, bit order, and mode. Only the clock matters to the
+ * fake bus, for how long each byte takes. */
+class SPISettings {
+
+public:
+  SPISettings() : clock(4000000) {}
+
+  /*! @brief Keeps @p clock, and ignores the rest. */
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+      : clock(clock) {
+    (void)bitOrder;
+    (void)dataMode;
+  }
+
+  /*! @brief The SPI clock, in Hz. */
+  uint32_t clock;
+};
+
+/*!
+ * @brief The SPI bus, with the fake L3G4200Ds on it.
+ *
+ * Each byte goes to whichever fakes have their Chip Select pin LOW, and takes
+ * 8 SPI clocks plus @ref testTiming_t::spiByteGapNanos of fake time. It counts
+ * what goes over it, and what shouldn't: bytes sent outside a transaction or
+ * with no chip selected, bytes two chips answered at once, and transactions
+ * started inside another.
+ *
+ * Like the SAMD and ESP32 cores, it can also transfer in the background:
+ * transfer(tx, rx, count, false) returns straight away, and the bytes go out
+ * as time passes, until isBusy() says they're done.
+ */
+class SPIClass {
+
+public:
+  SPIClass();
+
+  /*! @brief Does nothing. */
+  void begin() {}
+
+  /*! @brief Starts a transaction at the clock in @p settings. */
+  void beginTransaction(SPISettings settings);
+
+  /*! @brief Ends a transaction, and runs any interrupts it held off. */
+  void endTransaction();
+
+  /*! @brief Holds off @p interruptNumber during transactions. */
+  void usingInterrupt(int interruptNumber);
+
+  /*! @brief Stops holding off @p interruptNumber. */
+  void notUsingInterrupt(int interruptNumber);
+
+  /*! @brief Sends one byte to the selected fake gyroscopes.
+   * @returns The byte that comes back. */
+  uint8_t transfer(uint8_t data);
+
+  /*! @brief Sends @p count bytes, replacing each with what comes back. */
+  void transfer(void *buf, size_t count);
+
+  /*! @brief Sends @p count bytes from @p txBuf, and puts what comes back in
+   * @p rxBuf (which can be the same buffer). Unless @p block is true, it
+   * returns straight away, and the bytes go out as fake time passes. */
+  void transfer(const void *txBuf, void *rxBuf, size_t count, bool block);
+
+  /*! @brief Returns whether a background transfer is still going. Each call
+   * costs @ref testTiming_t::spiPollNanos. */
+  bool isBusy();
+
+  /*! @brief Zeroes the counters, and forgets any interrupts it was told
+   * about. */
+  void reset();
+
+  /*! @brief Zeroes the counters. */
+  void clearLog();
+
+  /*! @brief The number of transactions started. */
+  uint32_t transactions;
+
+  /*! @brief The number of bytes sent. */
+  uint32_t bytes;
+
+  /*! @brief The number of times a fake gyroscope was selected. */
+  uint32_t chipSelects;
+
+  /*! @brief How long the bytes took on the bus, in nanoseconds. */
+  uint64_t busNanos;
+
+  /*! @brief Bytes sent outside a transaction or without Chip Select. Should
+   * always be 0. */
+  uint32_t strayBytes;
+
+  /*! @brief Bytes sent with more than one chip selected. Should always
+   * be 0. */
+  uint32_t collisions;
+
+  /*! @brief Transactions started while one was already open. Should always
+   * be 0. */
+  uint32_t nestedTransactions;
+
+  /*! @brief The interrupts registered with usingInterrupt(), as a bit
+   * mask. */
+  uint32_t interruptMask;
+
+  /*! @brief Whether a transaction is open. */
+  bool inTransaction;
+
+private:
+  uint32_t _clock;
+
+  // The background transfer, if there is one.
+  const uint8_t *_asyncTx;
+  uint8_t *_asyncRx;
+  size_t _asyncCount;
+  size_t _asyncDone;
+  uint64_t _asyncStartNanos;
+
+  uint32_t byteNanos() const;
+  uint8_t exchange(uint8_t data);
+  void continueAsync();
+};
+
+/*! @brief The default SPI bus. */
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,104 @@
+/*!
+ * @file Wire.h
+ *
+ * An Arduino TwoWire class for the tests in extras/test, wired to the fake
+ * L3G4200Ds in FakeL3G4200D.h that have an I2C address instead of a bus.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TEST_WIRE_H
+#define L3G4200D_TEST_WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FakeL3G4200D.h"
+
+/*!
+ * @brief The I2C bus, with the fake L3G4200Ds that have an I2C address on it.
+ *
+ * The L3G4200D takes a sub-address byte first, whose top bit asks for
+ * auto-increment. A write transfer with more than that goes to the fake as
+ * the SPI frame that would write the same registers. A write of just the
+ * sub-address sets where the next read starts, and the read goes to the fake
+ * as the SPI frame that would read them.
+ *
+ * Each byte, with its acknowledge, takes 9 clocks of fake time, and each
+ * start and stop condition one more. It counts what goes over it.
+ */
+class TwoWire {
+
+public:
+  TwoWire();
+
+  /*! @brief Does nothing. */
+  void begin() {}
+
+  /*! @brief Sets the clock, in Hz, for how long each byte takes. */
+  void setClock(uint32_t clock);
+
+  /*! @brief Starts a write to the device at @p address. */
+  void beginTransmission(uint8_t address);
+
+  /*! @brief Queues a byte to write. @returns 1. */
+  size_t write(uint8_t data);
+
+  /*! @brief Queues @p count bytes to write. @returns @p count. */
+  size_t write(const uint8_t *data, size_t count);
+
+  /*! @brief Sends the queued bytes, with a stop condition after them unless
+   * @p sendStop is false.
+   * @returns 0 on success, or 2 if no fake answered at the address. */
+  uint8_t endTransmission(bool sendStop = true);
+
+  /*! @brief Reads @p count bytes from the device at @p address.
+   * @returns The number of bytes read, which is 0 if no fake answered. */
+  uint8_t requestFrom(uint8_t address, uint8_t count);
+
+  /*! @brief Returns how many bytes read are left to take with read(). */
+  int available();
+
+  /*! @brief Takes the next byte read, or returns -1 if there are none. */
+  int read();
+
+  /*! @brief Zeroes the counters, and goes back to the default clock. */
+  void reset();
+
+  /*! @brief Zeroes the counters. */
+  void clearLog();
+
+  /*! @brief The number of start conditions, including repeated starts, each
+   * of which begins a transfer. */
+  uint32_t transfers;
+
+  /*! @brief The number of bytes sent or received, including address
+   * bytes. */
+  uint32_t bytes;
+
+  /*! @brief How long the transfers took on the bus, in nanoseconds. */
+  uint64_t busNanos;
+
+  /*! @brief Transfers that no fake answered. */
+  uint32_t naks;
+
+private:
+  static const size_t BUFFER_SIZE = 32;
+
+  uint32_t _clock;
+  uint8_t _address;
+  uint8_t _tx[BUFFER_SIZE];
+  size_t _txCount;
+  uint8_t _rx[BUFFER_SIZE];
+  size_t _rxCount;
+  size_t _rxRead;
+  uint8_t _subAddress;
+
+  void elapseBits(uint32_t bits);
+  static uint8_t command(uint8_t subAddress, bool read);
+};
+
+/*! @brief The I2C bus. */
+extern TwoWire Wire;
+
+#endif
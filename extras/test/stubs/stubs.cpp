@@ -0,0 +1,429 @@
+#include "Arduino.h"
+#include "FakeL3G4200D.h"
+#include "SPI.h"
+#include "Wire.h"
+
+#include <stdio.h>
+
+uint32_t testMicros = 0;
+
+testTiming_t testTiming = {3500, 3000, 500, 250, 250};
+
+HardwareSerial Serial;
+SPIClass SPI;
+TwoWire Wire;
+
+static const int PINS = 32;
+
+static bool pinLow[PINS];
+static uint32_t carryNanos = 0;
+
+static void (*interruptHandlers[PINS])();
+static bool interruptRaised[PINS];
+static bool interruptsEnabled = true;
+static bool inInterrupt = false;
+
+void testElapseNanos(uint32_t nanos) {
+  // A microsecond at a time, so the fakes take their samples and raise their
+  // interrupts when they're due rather than all at the end. Interrupt
+  // handlers move time on as well, and that counts towards it.
+  uint64_t until = testNanos() + nanos;
+  while (testNanos() < until) {
+    uint64_t step = until - testNanos();
+    carryNanos += step < 1000 ? (uint32_t)step : 1000;
+    testMicros += carryNanos / 1000;
+    carryNanos %= 1000;
+    FakeL3G4200D::updateAll();
+  }
+}
+
+uint64_t testNanos() { return (uint64_t)testMicros * 1000 + carryNanos; }
+
+void testRaiseInterrupt(int interruptNumber) {
+  if (interruptNumber < 0 || interruptNumber >= PINS ||
+      interruptHandlers[interruptNumber] == NULL) {
+    return;
+  }
+  interruptRaised[interruptNumber] = true;
+  testRunPendingInterrupts();
+}
+
+void testRunPendingInterrupts() {
+  if (!interruptsEnabled || inInterrupt) {
+    return;
+  }
+
+  // Handlers don't nest, and one can raise another, so start again after
+  // each.
+  for (int i = 0; i < PINS; i++) {
+    bool masked = SPI.inTransaction && (SPI.interruptMask & (1UL << i));
+    if (!interruptRaised[i] || masked || interruptHandlers[i] == NULL) {
+      continue;
+    }
+    interruptRaised[i] = false;
+    inInterrupt = true;
+    interruptHandlers[i]();
+    inInterrupt = false;
+    i = -1;
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  testElapseNanos(testTiming.digitalWriteNanos);
+  if (pin < PINS) {
+    pinLow[pin] = val == LOW;
+  }
+
+  // Bit-banged SPI clocks in whatever is on COPI at the time.
+  const std::vector<FakeL3G4200D *> &fakes = FakeL3G4200D::all();
+  for (size_t i = 0; i < fakes.size(); i++) {
+    int copi = fakes[i]->copiPin;
+    if (fakes[i]->sckPin == pin) {
+      bool copiHigh = copi >= 0 && copi < PINS && !pinLow[copi];
+      fakes[i]->clockSck(val == HIGH, copiHigh);
+    }
+  }
+
+  FakeL3G4200D *fake = FakeL3G4200D::onPin(pin);
+  if (fake == NULL) {
+    return;
+  }
+  if (val == LOW) {
+    if (!fake->selected) {
+      SPI.chipSelects++;
+    }
+    fake->select();
+  } else {
+    fake->deselect();
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  testElapseNanos(testTiming.digitalReadNanos);
+  const std::vector<FakeL3G4200D *> &fakes = FakeL3G4200D::all();
+  for (size_t i = 0; i < fakes.size(); i++) {
+    if (fakes[i]->int2Pin == pin) {
+      return fakes[i]->int2() ? HIGH : LOW;
+    }
+    if (fakes[i]->cipoPin == pin && fakes[i]->selected) {
+      return fakes[i]->cipo() ? HIGH : LOW;
+    }
+  }
+  return pin < PINS && pinLow[pin] ? LOW : HIGH;
+}
+
+void attachInterrupt(uint8_t interruptNumber, void (*isr)(), int mode) {
+  (void)mode;
+  if (interruptNumber < PINS) {
+    interruptHandlers[interruptNumber] = isr;
+    interruptRaised[interruptNumber] = false;
+  }
+}
+
+void detachInterrupt(uint8_t interruptNumber) {
+  if (interruptNumber < PINS) {
+    interruptHandlers[interruptNumber] = NULL;
+  }
+}
+
+uint32_t micros() { return testMicros; }
+
+uint32_t millis() { return testMicros / 1000; }
+
+void delay(uint32_t ms) {
+  for (uint32_t i = 0; i < ms; i++) {
+    testElapseNanos(1000000);
+  }
+}
+
+void delayMicroseconds(unsigned int us) {
+  for (unsigned int i = 0; i < us; i++) {
+    testElapseNanos(1000);
+  }
+}
+
+void noInterrupts() { interruptsEnabled = false; }
+
+void interrupts() {
+  interruptsEnabled = true;
+  testRunPendingInterrupts();
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t written = 0;
+  while (written < size && write(buffer[written])) {
+    written++;
+  }
+  return written;
+}
+
+size_t Print::print(const char str[]) {
+  return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::print(long val) {
+  char str[24];
+  snprintf(str, sizeof(str), "%ld", val);
+  return print(str);
+}
+
+size_t Print::println(const char str[]) { return print(str) + print("\n"); }
+
+size_t HardwareSerial::write(uint8_t byte) {
+  fputc(byte, stderr);
+  return 1;
+}
+
+SPIClass::SPIClass() { reset(); }
+
+void SPIClass::beginTransaction(SPISettings settings) {
+  if (inTransaction) {
+    nestedTransactions++;
+  }
+  transactions++;
+  inTransaction = true;
+  _clock = settings.clock;
+  testElapseNanos(testTiming.spiTransactionNanos);
+}
+
+void SPIClass::endTransaction() {
+  // Whatever a background transfer hadn't sent yet goes nowhere.
+  if (_asyncDone < _asyncCount) {
+    continueAsync();
+    strayBytes += _asyncCount - _asyncDone;
+    _asyncCount = _asyncDone = 0;
+  }
+
+  inTransaction = false;
+  testRunPendingInterrupts();
+}
+
+void SPIClass::usingInterrupt(int interruptNumber) {
+  interruptMask |= 1UL << interruptNumber;
+}
+
+void SPIClass::notUsingInterrupt(int interruptNumber) {
+  interruptMask &= ~(1UL << interruptNumber);
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  testElapseNanos(byteNanos());
+  return exchange(data);
+}
+
+void SPIClass::transfer(void *buf, size_t count) {
+  uint8_t *bytes = (uint8_t *)buf;
+  for (size_t i = 0; i < count; i++) {
+    bytes[i] = transfer(bytes[i]);
+  }
+}
+
+void SPIClass::transfer(const void *txBuf, void *rxBuf, size_t count,
+                        bool block) {
+  _asyncTx = (const uint8_t *)txBuf;
+  _asyncRx = (uint8_t *)rxBuf;
+  _asyncCount = count;
+  _asyncDone = 0;
+  _asyncStartNanos = testNanos();
+
+  if (block) {
+    while (isBusy()) {
+    }
+  }
+}
+
+bool SPIClass::isBusy() {
+  testElapseNanos(testTiming.spiPollNanos);
+  continueAsync();
+  return _asyncDone < _asyncCount;
+}
+
+void SPIClass::reset() {
+  interruptMask = 0;
+  inTransaction = false;
+  _clock = SPISettings().clock;
+  _asyncCount = _asyncDone = 0;
+  clearLog();
+}
+
+void SPIClass::clearLog() {
+  transactions = 0;
+  bytes = 0;
+  chipSelects = 0;
+  busNanos = 0;
+  strayBytes = 0;
+  collisions = 0;
+  nestedTransactions = 0;
+}
+
+uint32_t SPIClass::byteNanos() const {
+  return (uint32_t)(8000000000ULL / _clock) + testTiming.spiByteGapNanos;
+}
+
+uint8_t SPIClass::exchange(uint8_t data) {
+  bytes++;
+  busNanos += byteNanos();
+  if (!inTransaction) {
+    strayBytes++;
+    return 0;
+  }
+
+  // Every selected chip sees the byte. If more than one answers, they fight
+  // over CIPO, and the zeros win.
+  const std::vector<FakeL3G4200D *> &fakes = FakeL3G4200D::all();
+  size_t selected = 0;
+  uint8_t response = 0xff;
+  for (size_t i = 0; i < fakes.size(); i++) {
+    if (fakes[i]->selected) {
+      selected++;
+      response &= fakes[i]->exchange(data);
+    }
+  }
+
+  if (selected == 0) {
+    strayBytes++;
+    return 0;
+  }
+  if (selected > 1) {
+    collisions++;
+  }
+  return response;
+}
+
+void SPIClass::continueAsync() {
+  // The bytes whose time has come go out.
+  uint64_t elapsed = testNanos() - _asyncStartNanos;
+  size_t due = (size_t)(elapsed / byteNanos());
+  while (_asyncDone < _asyncCount && _asyncDone < due) {
+    uint8_t data = _asyncTx[_asyncDone];
+    _asyncRx[_asyncDone] = exchange(data);
+    _asyncDone++;
+  }
+}
+
+TwoWire::TwoWire() { reset(); }
+
+void TwoWire::setClock(uint32_t clock) { _clock = clock; }
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _address = address;
+  _txCount = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (_txCount == BUFFER_SIZE) {
+    return 0;
+  }
+  _tx[_txCount++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t count) {
+  size_t written = 0;
+  while (written < count && write(data[written]) == 1) {
+    written++;
+  }
+  return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  // The start condition and the address byte go out whoever is there.
+  transfers++;
+  bytes++;
+  elapseBits(1 + 9);
+
+  FakeL3G4200D *fake = FakeL3G4200D::atI2cAddress(_address);
+  if (fake == NULL) {
+    naks++;
+    elapseBits(1);
+    return 2;
+  }
+
+  bytes += _txCount;
+  elapseBits(9 * _txCount + (sendStop ? 1 : 0));
+  if (_txCount == 0) {
+    return 0;
+  }
+
+  _subAddress = _tx[0];
+  if (_txCount > 1) {
+    fake->select();
+    fake->exchange(command(_subAddress, false));
+    for (size_t i = 1; i < _txCount; i++) {
+      fake->exchange(_tx[i]);
+    }
+    fake->deselect();
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t count) {
+  transfers++;
+  bytes++;
+  elapseBits(1 + 9);
+  _rxCount = _rxRead = 0;
+
+  FakeL3G4200D *fake = FakeL3G4200D::atI2cAddress(address);
+  if (fake == NULL) {
+    naks++;
+    elapseBits(1);
+    return 0;
+  }
+
+  if (count > BUFFER_SIZE) {
+    count = BUFFER_SIZE;
+  }
+  fake->select();
+  fake->exchange(command(_subAddress, true));
+  for (uint8_t i = 0; i < count; i++) {
+    _rx[i] = fake->exchange(0);
+  }
+  fake->deselect();
+
+  _rxCount = count;
+  bytes += count;
+  elapseBits(9 * count + 1);
+  return count;
+}
+
+int TwoWire::available() { return (int)(_rxCount - _rxRead); }
+
+int TwoWire::read() {
+  if (_rxRead == _rxCount) {
+    return -1;
+  }
+  return _rx[_rxRead++];
+}
+
+void TwoWire::reset() {
+  _clock = 100000;
+  _address = 0;
+  _txCount = _rxCount = _rxRead = 0;
+  _subAddress = 0;
+  clearLog();
+}
+
+void TwoWire::clearLog() {
+  transfers = 0;
+  bytes = 0;
+  busNanos = 0;
+  naks = 0;
+}
+
+void TwoWire::elapseBits(uint32_t bits) {
+  uint32_t nanos = (uint32_t)(bits * 1000000000ULL / _clock);
+  busNanos += nanos;
+  testElapseNanos(nanos);
+}
+
+uint8_t TwoWire::command(uint8_t subAddress, bool read) {
+  // The same registers, in an SPI command byte: the read bit, then the
+  // auto-increment bit, which over I2C is the top bit of the sub-address.
+  return (read ? 0x80 : 0) | ((subAddress & 0x80) ? 0x40 : 0) |
+         (subAddress & 0x3f);
+}
@@ -0,0 +1,51 @@
+/*!
+ * @file test.h
+ *
+ * Checks for the host tests in extras/test. Each test is its own program:
+ * the checks print what failed, and main() returns @ref testResult.
+ *
+ * MIT license, all text above must be included in any redistribution.
+ */
+
+#ifndef L3G4200D_TEST_H
+#define L3G4200D_TEST_H
+
+#include <stdio.h>
+
+/*! @brief The number of checks that have failed so far. */
+static int testFailures = 0;
+
+/*! @brief Checks that @p condition is true, and carries on either way. */
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,         \
+              #condition);                                                     \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+/*! @brief Checks that two integers are equal, printing both if they
+ * aren't. */
+#define CHECK_EQUAL(expected, actual)                                          \
+  do {                                                                         \
+    long long expectedValue = (long long)(expected);                           \
+    long long actualValue = (long long)(actual);                               \
+    if (expectedValue != actualValue) {                                        \
+      fprintf(stderr, "%s:%d: expected %s == %lld, got %lld\n", __FILE__,      \
+              __LINE__, #actual, expectedValue, actualValue);                  \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+/*! @brief Prints a summary, and returns the exit status for main(). */
+static inline int testResult(const char *name) {
+  if (testFailures != 0) {
+    fprintf(stderr, "%s: %d check(s) failed\n", name, testFailures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+#endif
@@ -0,0 +1,113 @@
+/* Checks startRead() and pollReadComplete() against the fake gyroscope:
+   that only one read runs at a time, that the sample and callback come out
+   of pollReadComplete() once, and, with L3G4200D_ASYNC_SPI, that the
+   transfer runs in the background and everything else waits for it.
+   run_tests.sh builds this both with and without L3G4200D_ASYNC_SPI. */
+
+#include "L3G4200D_U.h"
+#include "test.h"
+
+static FakeL3G4200D chip(10);
+
+static void powerOn() {
+  chip.reset();
+  SPI.reset();
+}
+
+typedef struct {
+  int calls;
+  gyroSample_t sample;
+} callbackLog_t;
+
+static void onRead(const gyroSample_t &sample, void *context) {
+  callbackLog_t *log = (callbackLog_t *)context;
+  log->calls++;
+  log->sample = sample;
+}
+
+static void testOneReadAtATime() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10));
+  SPI.clearLog();
+
+  // With nothing started, there's nothing to wait for.
+  CHECK(gyro.pollReadComplete());
+
+  chip.setSample(100, -200, 300);
+  callbackLog_t log = {0, {0, 0, 0}};
+  CHECK(gyro.startRead(onRead, &log));
+  CHECK(!gyro.startRead(onRead, &log));
+
+  gyroSample_t sample;
+  int polls = 1;
+  while (!gyro.pollReadComplete(&sample)) {
+    polls++;
+  }
+#ifdef L3G4200D_ASYNC_SPI
+  CHECK(polls > 1);
+#else
+  CHECK_EQUAL(1, polls);
+#endif
+  CHECK_EQUAL(100, sample.x);
+  CHECK_EQUAL(-200, sample.y);
+  CHECK_EQUAL(300, sample.z);
+  CHECK_EQUAL(1, log.calls);
+  CHECK_EQUAL(100, log.sample.x);
+  CHECK_EQUAL(300, log.sample.z);
+
+  // It's finished with, so polling again doesn't hand it over again, and
+  // the next read can start.
+  CHECK(gyro.pollReadComplete());
+  CHECK_EQUAL(1, log.calls);
+  chip.setSample(1, 2, 3);
+  CHECK(gyro.startRead());
+  while (!gyro.pollReadComplete(&sample)) {
+  }
+  CHECK_EQUAL(1, sample.x);
+  CHECK_EQUAL(1, log.calls);
+  CHECK_EQUAL(2, SPI.transactions);
+  CHECK_EQUAL(0, SPI.strayBytes);
+}
+
+static void testBusHeldUntilDone() {
+  // A slow bus, so the transfer is still going when startRead() returns.
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10, GYRO_RANGE_4_DOT_36_RAD_PER_SEC, SPI, 100000));
+  chip.setSample(7, 8, 9);
+  SPI.clearLog();
+
+  CHECK(gyro.startRead());
+#ifdef L3G4200D_ASYNC_SPI
+  CHECK(SPI.inTransaction);
+#else
+  CHECK(!SPI.inTransaction);
+#endif
+
+  // Anything else that needs the bus waits for the read to finish first,
+  // and leaves its sample for pollReadComplete().
+  uint8_t whoAmI = 0;
+  gyro.rawReadRegs(REG_WHO_AM_I, &whoAmI, 1);
+  CHECK_EQUAL(L3G4200D_CHIP_ID, whoAmI);
+  CHECK(!SPI.inTransaction);
+  CHECK_EQUAL(2, SPI.transactions);
+  CHECK_EQUAL(0, SPI.nestedTransactions);
+  CHECK_EQUAL(0, SPI.strayBytes);
+
+  gyroSample_t sample;
+  CHECK(gyro.pollReadComplete(&sample));
+  CHECK_EQUAL(7, sample.x);
+  CHECK_EQUAL(9, sample.z);
+}
+
+int main() {
+  testOneReadAtATime();
+  testBusHeldUntilDone();
+
+#ifdef L3G4200D_ASYNC_SPI
+  return testResult("async read (background)");
+#else
+  return testResult("async read");
+#endif
+}
@@ -0,0 +1,114 @@
+#include "L3G4200D_U.h"
+#include "test.h"
+
+#define LOW_RANGE GYRO_RANGE_4_DOT_36_RAD_PER_SEC
+#define MID_RANGE GYRO_RANGE_8_DOT_73_RAD_PER_SEC
+#define HIGH_RANGE GYRO_RANGE_34_DOT_91_RAD_PER_SEC
+
+static gyroSample_t sample(int16_t x, int16_t y, int16_t z) {
+  gyroSample_t sample = {x, y, z};
+  return sample;
+}
+
+static void testStaysWhenQuiet() {
+  L3G4200D_AutoRange autoRange;
+
+  for (int i = 0; i < 1000; i++) {
+    CHECK_EQUAL(LOW_RANGE, autoRange.update(sample(1000, -2000, 3000),
+                                            LOW_RANGE, false));
+  }
+}
+
+static void testSwitchesUpOnLargeSamples() {
+  L3G4200D_AutoRange autoRange;
+  int16_t large = L3G4200D_AUTO_RANGE_UP_THRESHOLD;
+
+  // Any axis, either sign.
+  CHECK_EQUAL(MID_RANGE,
+              autoRange.update(sample(0, 0, -large), LOW_RANGE, false));
+  CHECK_EQUAL(HIGH_RANGE,
+              autoRange.update(sample(0, large, 0), MID_RANGE, false));
+
+  // There's nowhere higher to go.
+  CHECK_EQUAL(HIGH_RANGE,
+              autoRange.update(sample(large, 0, 0), HIGH_RANGE, false));
+}
+
+static void testSwitchesUpWhenSaturated() {
+  L3G4200D_AutoRange autoRange;
+
+  CHECK_EQUAL(MID_RANGE, autoRange.update(sample(10, 10, 10), LOW_RANGE, true));
+}
+
+static void testPredictsFromTheTrend() {
+  L3G4200D_AutoRange autoRange;
+
+  // 20000 is under the threshold, but coming from 10000, the next sample
+  // looks like it'll be around 30000.
+  CHECK_EQUAL(LOW_RANGE,
+              autoRange.update(sample(10000, 0, 0), LOW_RANGE, false));
+  CHECK_EQUAL(MID_RANGE,
+              autoRange.update(sample(20000, 0, 0), LOW_RANGE, false));
+
+  // The sample before the switch was at the old range, so it isn't used to
+  // predict from the first one at the new range.
+  CHECK_EQUAL(MID_RANGE,
+              autoRange.update(sample(20000, 0, 0), MID_RANGE, false));
+}
+
+static void testSwitchesDownAfterHolding() {
+  L3G4200D_AutoRange autoRange;
+
+  // The quiet threshold is scaled into the current range's counts.
+  int16_t quiet = (L3G4200D_AUTO_RANGE_DOWN_THRESHOLD >> 1) - 1;
+  int16_t notQuiet = quiet + 1;
+
+  for (int i = 1; i < L3G4200D_AUTO_RANGE_DOWN_HOLD; i++) {
+    CHECK_EQUAL(MID_RANGE,
+                autoRange.update(sample(quiet, 0, 0), MID_RANGE, false));
+  }
+
+  // One sample that wouldn't fit starts the count again.
+  CHECK_EQUAL(MID_RANGE,
+              autoRange.update(sample(notQuiet, 0, 0), MID_RANGE, false));
+  for (int i = 1; i < L3G4200D_AUTO_RANGE_DOWN_HOLD; i++) {
+    CHECK_EQUAL(MID_RANGE,
+                autoRange.update(sample(quiet, 0, 0), MID_RANGE, false));
+  }
+  CHECK_EQUAL(LOW_RANGE,
+              autoRange.update(sample(quiet, 0, 0), MID_RANGE, false));
+}
+
+static void testSwitchesDownFromTheTop() {
+  L3G4200D_AutoRange autoRange;
+  int16_t quiet = (L3G4200D_AUTO_RANGE_DOWN_THRESHOLD >> 2) - 1;
+
+  gyroRange_t range = HIGH_RANGE;
+  for (int i = 0; i < L3G4200D_AUTO_RANGE_DOWN_HOLD; i++) {
+    range = autoRange.update(sample(0, quiet, 0), range, false);
+  }
+  CHECK_EQUAL(MID_RANGE, range);
+}
+
+static void testReset() {
+  L3G4200D_AutoRange autoRange;
+
+  autoRange.update(sample(10000, 0, 0), LOW_RANGE, false);
+  autoRange.reset();
+
+  // Without the previous sample, there's no trend to predict from.
+  CHECK_EQUAL(LOW_RANGE,
+              autoRange.update(sample(20000, 0, 0), LOW_RANGE, false));
+}
+
+int main() {
+  testStaysWhenQuiet();
+  testSwitchesUpOnLargeSamples();
+  testSwitchesUpWhenSaturated();
+  testPredictsFromTheTrend();
+  testSwitchesDownAfterHolding();
+  testSwitchesDownFromTheTop();
+  testReset();
+
+  return testResult("auto range");
+}
@@ -0,0 +1,132 @@
+/* Checks L3G4200D_BusGroup against two fake gyroscopes on their own Chip
+   Select pins: that it reads both in one transaction, keeps each one's
+   interrupt handler off the bus until it's done, and leaves a gyroscope
+   alone while it's in the middle of startRead(). */
+
+#include "L3G4200D_BusGroup.h"
+#include "test.h"
+
+static FakeL3G4200D chipA(9);
+static FakeL3G4200D chipB(10);
+
+static L3G4200D_Unified gyroA(1);
+static L3G4200D_Unified gyroB(2);
+
+static void powerOn() {
+  chipA.reset();
+  chipB.reset();
+  SPI.reset();
+}
+
+static void still(uint32_t micros, double dps[3], void *context) {
+  (void)micros;
+  (void)context;
+  dps[0] = dps[1] = dps[2] = 0;
+}
+
+static void onChipBInt2() { gyroB.handleInterrupt(); }
+
+static void testReadAll() {
+  powerOn();
+  CHECK(gyroA.begin(9));
+  CHECK(gyroB.begin(10));
+  L3G4200D_BusGroup group;
+  CHECK(group.add(gyroA));
+  CHECK(group.add(gyroB));
+  CHECK_EQUAL(2, group.size());
+
+  chipA.setSample(1, 2, 3);
+  chipB.setSample(-4, -5, -6);
+  SPI.clearLog();
+
+  // Both Chip Selects, one after the other, in one transaction.
+  gyroBusFrame_t frame;
+  CHECK(group.readAll(&frame));
+  CHECK_EQUAL(2, frame.count);
+  CHECK_EQUAL(1, frame.x[0]);
+  CHECK_EQUAL(3, frame.z[0]);
+  CHECK_EQUAL(-4, frame.x[1]);
+  CHECK_EQUAL(-6, frame.z[1]);
+  CHECK_EQUAL(1, SPI.transactions);
+  CHECK_EQUAL(2, SPI.chipSelects);
+  CHECK_EQUAL(0, SPI.collisions);
+}
+
+static void testHoldsOffEveryInterrupt() {
+  // A slow bus, on a core that can't hold the interrupt off during
+  // transactions, with the second gyroscope capturing on its interrupt, so
+  // it often comes in while the group has the bus.
+  powerOn();
+  CHECK(gyroA.begin(9, GYRO_RANGE_4_DOT_36_RAD_PER_SEC, SPI, 100000));
+  CHECK(gyroB.begin(10, GYRO_RANGE_4_DOT_36_RAD_PER_SEC, SPI, 100000));
+  L3G4200D_BusGroup group;
+  CHECK(group.add(gyroA));
+  CHECK(group.add(gyroB));
+
+  chipB.setRateTrace(still);
+  chipB.int2Pin = 3;
+  attachInterrupt(digitalPinToInterrupt(3), onChipBInt2, RISING);
+  gyroB.enableDataReadyInterrupt(digitalPinToInterrupt(3));
+  SPI.notUsingInterrupt(digitalPinToInterrupt(3));
+  chipB.clearLog();
+  SPI.clearLog();
+
+  // The handler waits for the group, rather than starting a transaction in
+  // the middle of it. (The group reads the second gyroscope's samples too,
+  // so the handler mostly finds nothing new by then.)
+  gyroBusFrame_t frame;
+  gyroSample_t samples[L3G4200D_SAMPLE_RING_CAPACITY];
+  for (int i = 0; i < 200; i++) {
+    CHECK(group.readAll(&frame));
+    gyroB.readSamples(samples, L3G4200D_SAMPLE_RING_CAPACITY);
+  }
+  CHECK(chipB.samplesTaken > 100);
+  CHECK_EQUAL(0, SPI.nestedTransactions);
+  CHECK_EQUAL(0, SPI.collisions);
+  CHECK_EQUAL(0, SPI.strayBytes);
+
+  gyroB.disableDataReadyInterrupt();
+  detachInterrupt(digitalPinToInterrupt(3));
+  chipB.int2Pin = -1;
+}
+
+static void testWaitsForStartRead() {
+  powerOn();
+  CHECK(gyroA.begin(9));
+  CHECK(gyroB.begin(10));
+  gyroB.enableFifo();
+  L3G4200D_BusGroup group;
+  CHECK(group.add(gyroA));
+  CHECK(group.add(gyroB));
+
+  // Until the read is finished, the group leaves the bus alone.
+  chipA.setSample(7, 8, 9);
+  CHECK(gyroA.startRead());
+  SPI.clearLog();
+  gyroBusFrame_t frame;
+  CHECK(!group.readAll(&frame));
+  CHECK_EQUAL(0, frame.count);
+
+  gyroSample_t buf[2 * L3G4200D_FIFO_DEPTH];
+  size_t counts[2] = {5, 5};
+  CHECK_EQUAL(0, group.drainFifos(buf, L3G4200D_FIFO_DEPTH, counts));
+  CHECK_EQUAL(0, counts[0]);
+  CHECK_EQUAL(0, counts[1]);
+  CHECK_EQUAL(0, SPI.transactions);
+
+  gyroSample_t sample;
+  CHECK(gyroA.pollReadComplete(&sample));
+  CHECK_EQUAL(7, sample.x);
+  CHECK(group.readAll(&frame));
+  chipB.pushFifo(1, 1, 1);
+  CHECK_EQUAL(1, group.drainFifos(buf, L3G4200D_FIFO_DEPTH, counts));
+  CHECK_EQUAL(1, counts[1]);
+}
+
+int main() {
+  testReadAll();
+  testHoldsOffEveryInterrupt();
+  testWaitsForStartRead();
+
+  return testResult("bus group");
+}
@@ -0,0 +1,168 @@
+/* Checks bias calibration against the fake gyroscope's zero-rate offset:
+   when calibrate() refuses to run, that it waits for the filters to settle,
+   that saveCalibration() and loadCalibration() round trip, and that online
+   calibration follows the bias while still and leaves it alone while
+   turning. */
+
+#include "L3G4200D_U.h"
+#include "test.h"
+
+#include <string.h>
+
+static FakeL3G4200D chip(10);
+
+static void powerOn() {
+  chip.reset();
+  SPI.reset();
+}
+
+// Turns at the rate in @p context, in degrees per second, about every axis.
+static void turning(uint32_t micros, double dps[3], void *context) {
+  (void)micros;
+  double rate = *(const double *)context;
+  dps[0] = dps[1] = dps[2] = rate;
+}
+
+// Turns at 50 degrees per second until the micros() time in @p context.
+static void stopping(uint32_t micros, double dps[3], void *context) {
+  uint32_t stopMicros = *(const uint32_t *)context;
+  double rate = (int32_t)(micros - stopMicros) < 0 ? 50 : 0;
+  dps[0] = dps[1] = dps[2] = rate;
+}
+
+// Waits long enough for a new sample at 100 Hz, and reads it, in
+// milliradians per second.
+static gyroFixedEvent_t nextEvent(L3G4200D_Unified &gyro) {
+  gyroFixedEvent_t event;
+  do {
+    delay(10);
+  } while (!gyro.getEventMilliRad(&event));
+  return event;
+}
+
+static void testRefusesWhileSampling() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  double rate = 0;
+  chip.setRateTrace(turning, &rate);
+  CHECK(gyro.begin(10));
+
+  // Anything else taking samples would take them from under it.
+  gyro.enableFifo();
+  CHECK(!gyro.calibrate(20));
+  gyro.disableFifo();
+
+  gyro.enableDataReadyInterrupt(digitalPinToInterrupt(2));
+  CHECK(!gyro.calibrate(20));
+  gyro.disableDataReadyInterrupt();
+
+  gyro.enableDutyCycle(100, 8);
+  CHECK(!gyro.calibrate(20));
+  gyro.disableDutyCycle();
+
+  CHECK(gyro.calibrate(20));
+}
+
+static void testWaitsForSettling() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  uint32_t stopMicros = 0;
+  chip.setRateTrace(stopping, &stopMicros);
+  chip.zeroRateDps[0] = 2;
+  CHECK(gyro.begin(10));
+
+  // The samples while the filters settle after a change look like turning,
+  // and would fail the calibration if they were counted.
+  stopMicros = micros() + 10000 * L3G4200D_SETTLING_SAMPLES;
+  gyro.setDataRate(GYRO_DATA_RATE_100HZ);
+  CHECK(gyro.calibrate(20));
+  CHECK(chip.samplesTaken >= L3G4200D_SETTLING_SAMPLES + 20);
+
+  gyro.clearCalibration();
+  CHECK(nextEvent(gyro).x > 10);
+  CHECK(gyro.calibrate(20));
+  CHECK_EQUAL(0, nextEvent(gyro).x);
+}
+
+static void testSaveAndLoad() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  double rate = 0;
+  chip.setRateTrace(turning, &rate);
+  chip.zeroRateDps[0] = 2;
+  chip.zeroRateDps[1] = -3;
+  chip.zeroRateDps[2] = 5;
+  chip.regs[REG_OUT_TEMP] = 20;
+  CHECK(gyro.begin(10));
+  CHECK(gyro.calibrate(20));
+
+  uint8_t blob[L3G4200D_CALIBRATION_SIZE];
+  CHECK_EQUAL(0, gyro.saveCalibration(blob, sizeof(blob) - 1));
+  CHECK_EQUAL(L3G4200D_CALIBRATION_SIZE,
+              gyro.saveCalibration(blob, sizeof(blob)));
+
+  // After a reboot, the bias is back without calibrating, at any range.
+  L3G4200D_Unified rebooted(2);
+  CHECK(rebooted.begin(10, GYRO_RANGE_34_DOT_91_RAD_PER_SEC));
+  gyroFixedEvent_t event = nextEvent(rebooted);
+  CHECK(event.x != 0 && event.y != 0 && event.z != 0);
+  CHECK(rebooted.loadCalibration(blob, sizeof(blob)));
+  event = nextEvent(rebooted);
+  CHECK(event.x >= -1 && event.x <= 1);
+  CHECK(event.y >= -1 && event.y <= 1);
+  CHECK(event.z >= -1 && event.z <= 1);
+
+  // Not if the temperature has changed too much since.
+  chip.regs[REG_OUT_TEMP] = 30;
+  CHECK(!rebooted.loadCalibration(blob, sizeof(blob), 5));
+  CHECK(rebooted.loadCalibration(blob, sizeof(blob), 10));
+
+  // Or if the blob isn't one.
+  uint8_t bad[L3G4200D_CALIBRATION_SIZE];
+  memcpy(bad, blob, sizeof(bad));
+  bad[3] ^= 0x10;
+  CHECK(!rebooted.loadCalibration(bad, sizeof(bad)));
+  memset(bad, 0xff, sizeof(bad));
+  CHECK(!rebooted.loadCalibration(bad, sizeof(bad)));
+  CHECK(!rebooted.loadCalibration(blob, sizeof(blob) - 1));
+}
+
+static void testOnlineCalibration() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  double rate = 0;
+  chip.setRateTrace(turning, &rate);
+  chip.zeroRateDps[0] = 1;
+  chip.noiseCounts = 3;
+  CHECK(gyro.begin(10));
+  CHECK(gyro.calibrate(50));
+  gyro.enableOnlineCalibration(true);
+
+  // The bias drifts by half a degree per second, which is followed while the
+  // gyroscope is still.
+  chip.zeroRateDps[0] = 1.5;
+  CHECK(nextEvent(gyro).x > 2);
+  for (int i = 0; i < 2000; i++) {
+    nextEvent(gyro);
+  }
+  int32_t x = nextEvent(gyro).x;
+  CHECK(x >= -1 && x <= 1);
+
+  // But not while it's turning.
+  rate = 30;
+  for (int i = 0; i < 2000; i++) {
+    nextEvent(gyro);
+  }
+  rate = 0;
+  x = nextEvent(gyro).x;
+  CHECK(x >= -1 && x <= 1);
+}
+
+int main() {
+  testRefusesWhileSampling();
+  testWaitsForSettling();
+  testSaveAndLoad();
+  testOnlineCalibration();
+
+  return testResult("calibration");
+}
@@ -0,0 +1,178 @@
+/* Checks waking up and duty cycling against the fake gyroscope's model of
+   how long it takes to wake up: that wake() says how long the junk will go
+   on for, that none of it comes out of getEvent() or serviceDutyCycle(),
+   and that duty cycling collects full bursts on time and goes back to
+   sleep in between. */
+
+#include "L3G4200D_U.h"
+#include "test.h"
+
+static FakeL3G4200D chip(10);
+
+// The default data rate, 400 Hz.
+static const uint32_t PERIOD_MICROS = 2500;
+
+static void powerOn() {
+  chip.reset();
+  SPI.reset();
+
+  // As long as the datasheet says, which is what the driver waits out.
+  chip.turnOnMicros = L3G4200D_POWER_DOWN_TURN_ON_MICROS;
+  chip.sleepWakeSamples = L3G4200D_SETTLING_SAMPLES;
+}
+
+// Turns at 10 degrees per second about every axis, so a good sample is
+// never mistaken for junk, which reads as INT16_MIN.
+static void turning(uint32_t micros, double dps[3], void *context) {
+  (void)micros;
+  (void)context;
+  dps[0] = dps[1] = dps[2] = 10;
+}
+
+// Starts @p gyro, and waits for it to come out of power-down.
+static void begin(L3G4200D_Unified &gyro) {
+  chip.setRateTrace(turning, NULL);
+  CHECK(gyro.begin(10));
+  delay(L3G4200D_POWER_DOWN_TURN_ON_MICROS / 1000 + 10);
+}
+
+// Reads each sample as it comes in, halfway between samples so none comes
+// in the middle of a read, until getEvent() returns one, and returns how long
+// after @p startMicros that was. Each is read twice, as reading faster than
+// the data rate would.
+static uint32_t microsToFirstEvent(L3G4200D_Unified &gyro,
+                                   uint32_t startMicros) {
+  gyroFixedEvent_t event;
+  uint32_t pollMicros = PERIOD_MICROS / 2;
+  do {
+    delayMicroseconds(startMicros + pollMicros - micros());
+    pollMicros += PERIOD_MICROS;
+  } while (!gyro.getEventFixed(&event) && !gyro.getEventFixed(&event));
+  CHECK(event.x > 0 && event.y > 0 && event.z > 0);
+  return micros() - startMicros;
+}
+
+static void testWakeFromSleep() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  begin(gyro);
+
+  gyro.sleep();
+  CHECK_EQUAL(GYRO_POWER_SLEEP, gyro.powerMode());
+  chip.clearLog();
+  delay(10);
+  CHECK_EQUAL(0, chip.samplesTaken);
+
+  // Waking from sleep takes the filters a few samples to settle, and the
+  // first good one comes after those.
+  uint32_t start = micros();
+  uint32_t wakeMicros = gyro.wake();
+  CHECK_EQUAL((L3G4200D_SETTLING_SAMPLES + 1) * PERIOD_MICROS, wakeMicros);
+  CHECK_EQUAL(GYRO_POWER_NORMAL, gyro.powerMode());
+  uint32_t elapsed = microsToFirstEvent(gyro, start);
+  CHECK(elapsed > wakeMicros);
+  CHECK(elapsed <= wakeMicros + PERIOD_MICROS);
+  CHECK_EQUAL(L3G4200D_SETTLING_SAMPLES, chip.junkSamples);
+
+  // Already awake, there's nothing to wait for.
+  CHECK_EQUAL(0, gyro.wake());
+}
+
+static void testWakeFromPowerDown() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  begin(gyro);
+
+  gyro.powerDown();
+  CHECK_EQUAL(GYRO_POWER_DOWN, gyro.powerMode());
+  chip.clearLog();
+  delay(10);
+  CHECK_EQUAL(0, chip.samplesTaken);
+
+  // Out of power-down, it takes the same time whatever the data rate, which
+  // is a whole number of samples at 400 Hz.
+  uint32_t start = micros();
+  uint32_t wakeMicros = gyro.wake();
+  CHECK_EQUAL(L3G4200D_POWER_DOWN_TURN_ON_MICROS + PERIOD_MICROS, wakeMicros);
+  uint32_t elapsed = microsToFirstEvent(gyro, start);
+  CHECK(elapsed > wakeMicros);
+  CHECK(elapsed <= wakeMicros + PERIOD_MICROS);
+  CHECK(chip.junkSamples > 0);
+}
+
+// Runs duty cycling with bursts of 8 samples every @p periodMillis for
+// @p bursts bursts, calling serviceDutyCycle() every millisecond, and checks
+// each burst comes @p latencyMicros after it was due and is all good
+// samples.
+static void checkBursts(gyroPowerMode_t idleMode, uint32_t periodMillis,
+                        int bursts, uint32_t latencyMicros) {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  begin(gyro);
+  chip.clearLog();
+
+  gyro.enableDutyCycle(periodMillis, 8, idleMode);
+  CHECK_EQUAL(idleMode, gyro.powerMode());
+
+  // The first burst is due straight away, and they're all timed on
+  // millis().
+  uint32_t dueMicros = millis() * 1000;
+  int burstsSeen = 0;
+  int badSamples = 0;
+  int lateBursts = 0;
+  gyroSample_t buf[L3G4200D_FIFO_DEPTH];
+  while (burstsSeen < bursts) {
+    size_t count = gyro.serviceDutyCycle(buf, L3G4200D_FIFO_DEPTH);
+    if (count == 0) {
+      delay(1);
+      continue;
+    }
+
+    CHECK_EQUAL(8, count);
+    for (size_t i = 0; i < count; i++) {
+      if (buf[i].x <= 0 || buf[i].y <= 0 || buf[i].z <= 0) {
+        badSamples++;
+      }
+    }
+
+    // It's back to idle between bursts, and the next one counts from when
+    // this one was due, not from when it finished.
+    uint32_t latency = micros() - dueMicros;
+    if (latency < latencyMicros || latency > latencyMicros + 2000) {
+      fprintf(stderr, "burst %d took %lu us, expected %lu us\n", burstsSeen,
+              (unsigned long)latency, (unsigned long)latencyMicros);
+      lateBursts++;
+    }
+    CHECK_EQUAL(idleMode, gyro.powerMode());
+    dueMicros += periodMillis * 1000;
+    burstsSeen++;
+  }
+  CHECK_EQUAL(0, badSamples);
+  CHECK_EQUAL(0, lateBursts);
+
+  // Junk came out of the fake every time it woke up, and none of it got
+  // through.
+  CHECK(chip.junkSamples >= (uint32_t)bursts);
+
+  gyro.disableDutyCycle();
+  CHECK_EQUAL(GYRO_POWER_NORMAL, gyro.powerMode());
+  CHECK(!(chip.regs[REG_CTRL_5] & CTRL5_FIFO_ENABLE));
+}
+
+static void testDutyCycle() {
+  // Sleeping, each burst takes the settling samples and then the burst.
+  checkBursts(GYRO_POWER_SLEEP, 100, 10,
+              (L3G4200D_SETTLING_SAMPLES + 1 + 8) * PERIOD_MICROS);
+
+  // Powered down, the turn-on time and then the burst.
+  checkBursts(GYRO_POWER_DOWN, 1000, 3,
+              L3G4200D_POWER_DOWN_TURN_ON_MICROS + (1 + 8) * PERIOD_MICROS);
+}
+
+int main() {
+  testWakeFromSleep();
+  testWakeFromPowerDown();
+  testDutyCycle();
+
+  return testResult("duty cycle");
+}
@@ -0,0 +1,318 @@
+/* Checks the test harness itself: that each fake gyroscope answers on its
+   own Chip Select, takes samples from its rate trace at its output data rate,
+   latches its output registers with block data update, raises INT2, and
+   charges the time the timing model says it should, and that it answers
+   bit-banged SPI and I2C the same way. */
+
+#include "L3G4200D.h"
+#include "L3G4200D_I2C.h"
+#include "test.h"
+
+static FakeL3G4200D chipA(9);
+static FakeL3G4200D chipB(10);
+
+static void powerOn() {
+  chipA.reset();
+  chipB.reset();
+  SPI.reset();
+}
+
+static void constantRate(uint32_t micros, double dps[3], void *context) {
+  (void)micros;
+  const double *rates = (const double *)context;
+  for (int i = 0; i < 3; i++) {
+    dps[i] = rates[i];
+  }
+}
+
+// Goes up by 1000 degrees per second every second, on every axis, from the
+// time in @p context.
+static void ramp(uint32_t micros, double dps[3], void *context) {
+  uint32_t start = *(const uint32_t *)context;
+  for (int i = 0; i < 3; i++) {
+    dps[i] = (double)(micros - start) / 1000;
+  }
+}
+
+// Reads STATUS_REG and all three axes in one burst, like the library.
+static gyroSample_t readSample(L3G4200D_Unified &gyro) {
+  uint8_t bytes[7];
+  gyro.rawReadRegs(REG_STATUS, bytes, sizeof(bytes));
+  gyroSample_t sample;
+  sample.x = (int16_t)((bytes[2] << 8) | bytes[1]);
+  sample.y = (int16_t)((bytes[4] << 8) | bytes[3]);
+  sample.z = (int16_t)((bytes[6] << 8) | bytes[5]);
+  return sample;
+}
+
+static void testEachChipHasItsOwnChipSelect() {
+  powerOn();
+  L3G4200D_Unified gyroA(1);
+  L3G4200D_Unified gyroB(2);
+
+  CHECK(gyroA.begin(9));
+  CHECK_EQUAL(2, chipA.frames.size());
+  CHECK_EQUAL(0, chipB.frames.size());
+
+  // A different range on each, so each only got its own writes.
+  CHECK(gyroB.begin(10, GYRO_RANGE_34_DOT_91_RAD_PER_SEC));
+  CHECK_EQUAL(2, chipA.frames.size());
+  CHECK_EQUAL(2, chipB.frames.size());
+  CHECK_EQUAL(0x80, chipA.regs[REG_CTRL_4]);
+  CHECK_EQUAL(0xa0, chipB.regs[REG_CTRL_4]);
+
+  chipA.setSample(1, 2, 3);
+  chipB.setSample(-1, -2, -3);
+  CHECK_EQUAL(1, readSample(gyroA).x);
+  CHECK_EQUAL(-3, readSample(gyroB).z);
+
+  CHECK_EQUAL(6, SPI.transactions);
+  CHECK_EQUAL(6, SPI.chipSelects);
+  CHECK_EQUAL(0, SPI.collisions);
+  CHECK_EQUAL(0, SPI.strayBytes);
+
+  // Nothing answers on a pin with no chip.
+  L3G4200D_Unified nobody(3);
+  CHECK(!nobody.begin(8));
+  CHECK_EQUAL(2, SPI.strayBytes);
+}
+
+static void testSamplesFromTheTrace() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  double rates[3] = {100, -50, 2000};
+  chipA.zeroRateDps[1] = 1;
+  chipA.setRateTrace(constantRate, rates);
+
+  // Nothing happens in power down.
+  delay(100);
+  CHECK_EQUAL(0, chipA.samplesTaken);
+
+  // 400 Hz, after begin().
+  CHECK(gyro.begin(9));
+  uint32_t start = micros();
+  delay(100);
+  CHECK_EQUAL(40, chipA.samplesTaken);
+  // The clock started when CTRL_REG1 was written, a little before begin()
+  // returned.
+  CHECK(start + 100000 - chipA.lastSampleMicros < 20);
+
+  // 8.75 millidegrees per second per count at 250 degrees per second, with
+  // the zero-rate offset, and saturated.
+  gyroSample_t sample = readSample(gyro);
+  CHECK_EQUAL(11429, sample.x);
+  CHECK_EQUAL(-5600, sample.y);
+  CHECK_EQUAL(INT16_MAX, sample.z);
+  CHECK_EQUAL(39, chipA.samplesLost);
+
+  // 70 millidegrees per second per count at 2000.
+  gyro.setRange(GYRO_RANGE_34_DOT_91_RAD_PER_SEC);
+  delay(3);
+  CHECK_EQUAL(28571, readSample(gyro).z);
+
+  // A chip clock 1% slow takes 396 samples a second instead of 400.
+  chipA.clockErrorPpm = 10000;
+  chipA.clearLog();
+  gyro.setDataRate(GYRO_DATA_RATE_100HZ);
+  gyro.setDataRate(GYRO_DATA_RATE_400HZ);
+  delay(1000);
+  CHECK_EQUAL(396, chipA.samplesTaken);
+
+  // Nothing in sleep either.
+  chipA.clearLog();
+  gyro.sleep();
+  delay(100);
+  CHECK_EQUAL(0, chipA.samplesTaken);
+}
+
+static void testTurnOnJunk() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  double rates[3] = {10, 10, 10};
+  chipA.setRateTrace(constantRate, rates);
+  chipA.turnOnMicros = 10000;
+  chipA.sleepWakeSamples = 2;
+
+  // The three samples before 10 ms after power down are junk.
+  CHECK(gyro.begin(9));
+  delay(20);
+  CHECK_EQUAL(8, chipA.samplesTaken);
+  CHECK_EQUAL(3, chipA.junkSamples);
+
+  // And two after sleep.
+  gyro.sleep();
+  chipA.clearLog();
+  gyro.wake();
+  delay(20);
+  CHECK_EQUAL(8, chipA.samplesTaken);
+  CHECK_EQUAL(2, chipA.junkSamples);
+}
+
+// Reads OUT_X_L, lets @p micros go by, then reads OUT_X_H, by hand.
+static int16_t slowReadX(uint32_t micros) {
+  SPI.beginTransaction(SPISettings(5000000, MSBFIRST, SPI_MODE3));
+  digitalWrite(9, LOW);
+  SPI.transfer(0xc0 | REG_OUT_X_L);
+  uint8_t low = SPI.transfer(0);
+  delayMicroseconds(micros);
+  uint8_t high = SPI.transfer(0);
+  digitalWrite(9, HIGH);
+  SPI.endTransaction();
+  return (int16_t)((high << 8) | low);
+}
+
+static void testBlockDataUpdate() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  uint32_t start = micros();
+  chipA.setRateTrace(ramp, &start);
+
+  // With block data update, which begin() turns on, the sample that comes
+  // in between the two bytes waits until both have been read.
+  CHECK(gyro.begin(9));
+  delay(10);
+  int16_t before = readSample(gyro).x;
+  int16_t x = slowReadX(5000);
+  CHECK_EQUAL(before, x);
+  CHECK_EQUAL(0, chipA.tornReads);
+  CHECK(readSample(gyro).x > x);
+
+  // Without it, the reading is half of each.
+  gyro.rawWriteReg(REG_CTRL_4, CTRL4_FULL_SCALE_250DPS);
+  delay(10);
+  slowReadX(5000);
+  CHECK_EQUAL(1, chipA.tornReads);
+}
+
+static int int2Edges = 0;
+
+static void countInterrupt() { int2Edges++; }
+
+static void testInt2() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  double rates[3] = {0, 0, 0};
+  chipA.setRateTrace(constantRate, rates);
+  chipA.int2Pin = 2;
+  attachInterrupt(digitalPinToInterrupt(2), countInterrupt, RISING);
+
+  CHECK(gyro.begin(9));
+  gyro.rawWriteReg(REG_CTRL_3, CTRL3_I2_DATA_READY);
+
+  // Data ready stays high until the sample is read, so there's only one
+  // edge until then.
+  delay(10);
+  CHECK_EQUAL(1, int2Edges);
+  CHECK_EQUAL(HIGH, digitalRead(2));
+  readSample(gyro);
+  CHECK_EQUAL(LOW, digitalRead(2));
+  delay(3);
+  CHECK_EQUAL(2, int2Edges);
+
+  // Held off while interrupts are, and during transactions that registered
+  // it with usingInterrupt().
+  readSample(gyro);
+  noInterrupts();
+  delay(3);
+  CHECK_EQUAL(2, int2Edges);
+  interrupts();
+  CHECK_EQUAL(3, int2Edges);
+
+  readSample(gyro);
+  SPI.usingInterrupt(2);
+  SPI.beginTransaction(SPISettings());
+  delay(3);
+  CHECK_EQUAL(3, int2Edges);
+  SPI.endTransaction();
+  CHECK_EQUAL(4, int2Edges);
+
+  detachInterrupt(digitalPinToInterrupt(2));
+  chipA.int2Pin = -1;
+}
+
+static void testTimingModel() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(9));
+
+  // A transaction, two Chip Select writes, and eight bytes at 5 MHz.
+  uint64_t start = testNanos();
+  readSample(gyro);
+  CHECK_EQUAL(testTiming.spiTransactionNanos +
+                  2 * testTiming.digitalWriteNanos +
+                  8 * (1600 + testTiming.spiByteGapNanos),
+              testNanos() - start);
+
+  // In the background, the bytes go out while the caller waits.
+  uint8_t buf[4] = {0x80 | REG_WHO_AM_I, 0, 0, 0};
+  SPI.beginTransaction(SPISettings(5000000, MSBFIRST, SPI_MODE3));
+  digitalWrite(9, LOW);
+  SPI.transfer(buf, buf, 2, false);
+  CHECK(SPI.isBusy());
+  delayMicroseconds(5);
+  CHECK(!SPI.isBusy());
+  digitalWrite(9, HIGH);
+  SPI.endTransaction();
+  CHECK_EQUAL(L3G4200D_CHIP_ID, buf[1]);
+  CHECK_EQUAL(0, SPI.strayBytes);
+}
+
+static void testOtherTransports() {
+  powerOn();
+  L3G4200D<> hardware;
+  CHECK(hardware.begin(9));
+  chipA.setSample(1000, -2000, 3000);
+  gyroFixedEvent_t expected;
+  CHECK(hardware.getEventFixed(&expected));
+  gyroFixedEvent_t event;
+
+  // Bit-banged on four pins, which the SPI stand-in never sees.
+  chipA.sckPin = 13;
+  chipA.copiPin = 11;
+  chipA.cipoPin = 12;
+  L3G4200D<L3G4200D_DefaultConfig, L3G4200D_SoftwareSPI> softSpi;
+  chipA.reset();
+  SPI.clearLog();
+  CHECK(softSpi.begin(9, 13, 11, 12));
+  CHECK_EQUAL(CTRL4_UPDATE_MSB_AND_LSB_TOGETHER, chipA.regs[REG_CTRL_4]);
+  chipA.setSample(1000, -2000, 3000);
+  CHECK(softSpi.getEventFixed(&event));
+  CHECK_EQUAL(expected.x, event.x);
+  CHECK_EQUAL(expected.y, event.y);
+  CHECK_EQUAL(expected.z, event.z);
+  CHECK_EQUAL(0, SPI.bytes);
+  CHECK_EQUAL(3, chipA.frames.size());
+  CHECK_EQUAL(1 + 6, chipA.frames.back().size());
+  chipA.sckPin = chipA.copiPin = chipA.cipoPin = -1;
+
+  // Over I2C, only at its own address.
+  chipB.i2cAddress = L3G4200D_I2C_ADDRESS_SDO_HIGH;
+  Wire.reset();
+  L3G4200D<L3G4200D_DefaultConfig, L3G4200D_I2C<>> i2c;
+  CHECK(!i2c.begin(Wire, L3G4200D_I2C_ADDRESS_SDO_LOW));
+  CHECK_EQUAL(1, Wire.naks);
+  CHECK(i2c.begin(Wire, L3G4200D_I2C_ADDRESS_SDO_HIGH));
+  CHECK_EQUAL(CTRL4_UPDATE_MSB_AND_LSB_TOGETHER, chipB.regs[REG_CTRL_4]);
+  chipB.setSample(1000, -2000, 3000);
+  Wire.clearLog();
+  CHECK(i2c.getEventFixed(&event));
+  CHECK_EQUAL(expected.x, event.x);
+  CHECK_EQUAL(expected.y, event.y);
+  CHECK_EQUAL(expected.z, event.z);
+  CHECK_EQUAL(2, Wire.transfers);
+  CHECK_EQUAL(1 + 1 + 1 + 6, Wire.bytes);
+  CHECK_EQUAL(0, SPI.bytes);
+  chipB.i2cAddress = -1;
+}
+
+int main() {
+  testEachChipHasItsOwnChipSelect();
+  testSamplesFromTheTrace();
+  testTurnOnJunk();
+  testBlockDataUpdate();
+  testInt2();
+  testTimingModel();
+  testOtherTransports();
+
+  return testResult("fake gyroscope");
+}
@@ -0,0 +1,219 @@
+/* Checks the fake gyroscope's model of the high and low pass filters
+   against the cutoffs in the datasheet: that a sine at the cutoff comes out
+   3 dB down on every data rate and bandwidth, and every high pass cutoff
+   that can be measured in a few seconds, that the high pass filter removes
+   a zero-rate offset, and that its reset and reference modes work. The
+   cutoffs are typed in here again, so a mistake in the fake's tables
+   doesn't check itself. Everything is read through the FIFO, which gets the
+   same filtered samples as the output registers. */
+
+#include "L3G4200D_U.h"
+#include "test.h"
+
+#include <math.h>
+
+static FakeL3G4200D chip(10);
+
+static const gyroDataRate_t RATES[4] = {
+    GYRO_DATA_RATE_100HZ, GYRO_DATA_RATE_200HZ, GYRO_DATA_RATE_400HZ,
+    GYRO_DATA_RATE_800HZ};
+static const double RATE_HZ[4] = {100, 200, 400, 800};
+
+// The second low pass filter's cutoff for each data rate and bandwidth, in
+// Hz, from Table 21 of the datasheet.
+static const double LOW_PASS_HZ[4][4] = {{12.5, 25, 25, 25},
+                                         {12.5, 25, 50, 70},
+                                         {20, 25, 50, 110},
+                                         {30, 35, 50, 110}};
+
+// The high pass filter's cutoff at 800 Hz for each divisor, in Hz, from
+// Table 27 of the datasheet, down to the last that settles quickly.
+static const double HIGH_PASS_800HZ_HZ[7] = {56, 30, 15, 8, 4, 2, 1};
+
+static void powerOn() {
+  chip.reset();
+  SPI.reset();
+}
+
+// Turns back and forth about every axis, 100 degrees per second either way,
+// at the frequency in @p context, in Hz.
+static void shaking(uint32_t micros, double dps[3], void *context) {
+  double hz = *(const double *)context;
+  dps[0] = dps[1] = dps[2] = 100 * sin(2 * M_PI * hz * micros / 1e6);
+}
+
+// Turns at 50 degrees per second about every axis, from the micros() time
+// in @p context.
+static void stepping(uint32_t micros, double dps[3], void *context) {
+  uint32_t startMicros = *(const uint32_t *)context;
+  double rate = (int32_t)(micros - startMicros) < 0 ? 0 : 50;
+  dps[0] = dps[1] = dps[2] = rate;
+}
+
+// Reads @p count samples of the X axis through the FIFO, after throwing
+// away @p skip while the filters settle.
+static void readX(L3G4200D_Unified &gyro, size_t skip, size_t count,
+                  double *x) {
+  gyro.enableFifo(GYRO_FIFO_STREAM);
+  size_t seen = 0;
+  while (seen < skip + count) {
+    delay(10);
+    gyroSample_t buf[L3G4200D_FIFO_DEPTH];
+    size_t n = gyro.readFifo(buf, L3G4200D_FIFO_DEPTH);
+    for (size_t i = 0; i < n && seen < skip + count; i++, seen++) {
+      if (seen >= skip) {
+        x[seen - skip] = buf[i].x;
+      }
+    }
+  }
+  gyro.disableFifo();
+}
+
+// Shakes at @p hz, with the data rate at index @p rate, and returns the
+// amplitude of that frequency in what comes out of @p path, in counts. It
+// waits @p settleSeconds for the filters to settle, and measures over 10
+// whole cycles.
+static double amplitude(L3G4200D_Unified &gyro, int rate, gyroFilterPath_t path,
+                        double hz, double settleSeconds) {
+  gyro.setFilterPath(path);
+  chip.setRateTrace(shaking, &hz);
+
+  size_t skip = (size_t)(RATE_HZ[rate] * settleSeconds);
+  size_t count = (size_t)lround(10 * RATE_HZ[rate] / hz);
+  static double x[10 * 800];
+  readX(gyro, skip, count, x);
+
+  // Correlating with a sine and a cosine picks out just that frequency,
+  // whatever its phase.
+  double i = 0, q = 0;
+  for (size_t n = 0; n < count; n++) {
+    double phase = 2 * M_PI * hz * n / RATE_HZ[rate];
+    i += x[n] * sin(phase);
+    q += x[n] * cos(phase);
+  }
+  return 2 * sqrt(i * i + q * q) / count;
+}
+
+static void testLowPassCutoffs() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10));
+
+  for (int rate = 0; rate < 4; rate++) {
+    for (int bandwidth = 0; bandwidth < 4; bandwidth++) {
+      gyro.setDataRate(RATES[rate], (gyroBandwidth_t)(bandwidth << 4));
+      double cutoff = LOW_PASS_HZ[rate][bandwidth];
+
+      double in = amplitude(gyro, rate, GYRO_FILTER_PATH_LPF1, cutoff, 0.1);
+      double atCutoff =
+          amplitude(gyro, rate, GYRO_FILTER_PATH_LPF2, cutoff, 0.1) / in;
+      double below =
+          amplitude(gyro, rate, GYRO_FILTER_PATH_LPF2, cutoff / 4, 0.1) / in;
+      if (fabs(atCutoff - M_SQRT1_2) > 0.01 || below < 0.9) {
+        fprintf(stderr, "%.0f Hz, %.1f Hz cutoff: gain %.3f, %.3f below\n",
+                RATE_HZ[rate], cutoff, atCutoff, below);
+        testFailures++;
+      }
+    }
+  }
+}
+
+static void testHighPassCutoffs() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10));
+  gyro.setDataRate(GYRO_DATA_RATE_800HZ);
+
+  for (int divisor = 0; divisor < 7; divisor++) {
+    gyro.setHighPassFilter(GYRO_HIGH_PASS_NORMAL,
+                           (gyroHighPassDivisor_t)divisor);
+    double cutoff = HIGH_PASS_800HZ_HZ[divisor];
+
+    // A few time constants, which is longest at the lowest cutoff.
+    double settle = 1 / cutoff;
+    double in = amplitude(gyro, 3, GYRO_FILTER_PATH_LPF1, cutoff, settle);
+    double atCutoff =
+        amplitude(gyro, 3, GYRO_FILTER_PATH_HPF, cutoff, settle) / in;
+    double above =
+        amplitude(gyro, 3, GYRO_FILTER_PATH_HPF, cutoff * 4, settle) / in;
+    if (fabs(atCutoff - M_SQRT1_2) > 0.01 || above < 0.8) {
+      fprintf(stderr, "%.0f Hz cutoff: gain %.3f, %.3f above\n", cutoff,
+              atCutoff, above);
+      testFailures++;
+    }
+  }
+}
+
+static void testHighPassRemovesOffset() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10));
+  gyro.setDataRate(GYRO_DATA_RATE_800HZ);
+  gyro.setHighPassFilter(GYRO_HIGH_PASS_NORMAL, GYRO_HIGH_PASS_DIV_12);
+  chip.zeroRateDps[0] = 5;
+  uint32_t never = 0x80000000;
+  chip.setRateTrace(stepping, &never);
+
+  // Without it, the offset comes straight through, 5 degrees per second at
+  // 8.75 millidegrees per second per count.
+  double x[8];
+  gyro.setFilterPath(GYRO_FILTER_PATH_LPF1);
+  readX(gyro, 8, 8, x);
+  CHECK_EQUAL(571, x[7]);
+
+  gyro.setFilterPath(GYRO_FILTER_PATH_HPF);
+  readX(gyro, 80, 8, x);
+  CHECK_EQUAL(0, x[7]);
+
+  // And the second low pass filter after it doesn't bring it back.
+  gyro.setFilterPath(GYRO_FILTER_PATH_HPF_LPF2);
+  readX(gyro, 80, 8, x);
+  CHECK_EQUAL(0, x[7]);
+}
+
+static void testHighPassReset() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10));
+  gyro.setDataRate(GYRO_DATA_RATE_800HZ);
+  gyro.setHighPassFilter(GYRO_HIGH_PASS_NORMAL_RESET, GYRO_HIGH_PASS_DIV_10000);
+  gyro.setFilterPath(GYRO_FILTER_PATH_HPF);
+
+  // With a 0.1 Hz cutoff, a step in the rate takes seconds to die away.
+  uint32_t start = micros() + 20000;
+  chip.setRateTrace(stepping, &start);
+  double x[8];
+  readX(gyro, 80, 8, x);
+  CHECK(x[7] > 5000);
+
+  // Resetting starts it over from there.
+  gyro.resetHighPassFilter();
+  readX(gyro, 8, 8, x);
+  CHECK_EQUAL(0, x[7]);
+}
+
+static void testHighPassReference() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10));
+  gyro.setHighPassFilter(GYRO_HIGH_PASS_REFERENCE, GYRO_HIGH_PASS_DIV_12);
+  gyro.setHighPassReference(2);
+  gyro.setFilterPath(GYRO_FILTER_PATH_HPF);
+  uint32_t start = 0;
+  chip.setRateTrace(stepping, &start);
+
+  // 50 degrees per second is 5714 counts, less 2 in the high byte.
+  double x[8];
+  readX(gyro, 8, 8, x);
+  CHECK_EQUAL(5714 - 2 * 256, x[7]);
+}
+
+int main() {
+  testLowPassCutoffs();
+  testHighPassCutoffs();
+  testHighPassRemovesOffset();
+  testHighPassReset();
+  testHighPassReference();
+
+  return testResult("filters");
+}
@@ -0,0 +1,91 @@
+/* Checks that getEventFixed() and getEventMilliRad() agree with getEvent()
+   for every possible sample, at every range, to within what the integer
+   scales can hold. */
+
+#include "L3G4200D_U.h"
+#include "test.h"
+
+#include <math.h>
+
+static FakeL3G4200D chip(10);
+
+static const gyroRange_t RANGES[] = {GYRO_RANGE_4_DOT_36_RAD_PER_SEC,
+                                     GYRO_RANGE_8_DOT_73_RAD_PER_SEC,
+                                     GYRO_RANGE_34_DOT_91_RAD_PER_SEC};
+
+// How far a fixed-point value can be from @p expected, the float one in the
+// same units: the scale is rounded to the nearest 1/2^@p shift, which is out
+// by up to half of that for every count, then the result is rounded to the
+// nearest unit, and the float itself is only good to 24 bits.
+static double tolerance(int16_t sample, uint8_t shift, double expected) {
+  return fabs((double)sample) * 0.5 / (1L << shift) + 0.5 +
+         fabs(expected) / (1L << 23);
+}
+
+// Returns how many of the three axes are further from @p rad than the scale
+// allows.
+static int mismatches(const gyroFixedEvent_t &fixed, const float rad[3],
+                      const int16_t samples[3], long one, uint8_t shift) {
+  const int32_t values[3] = {fixed.x, fixed.y, fixed.z};
+  int count = 0;
+  for (int i = 0; i < 3; i++) {
+    double expected = (double)rad[i] * one;
+    if (fabs(values[i] - expected) > tolerance(samples[i], shift, expected)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+static void testEverySample(gyroRange_t range) {
+  chip.reset();
+  SPI.reset();
+  L3G4200D_Unified gyro(1);
+  CHECK(gyro.begin(10, range));
+
+  // Three samples at a time, one on each axis, from INT16_MIN up.
+  int fixedMismatches = 0;
+  int milliRadMismatches = 0;
+  for (int32_t first = INT16_MIN; first <= INT16_MAX; first += 3) {
+    int16_t samples[3];
+    for (int i = 0; i < 3; i++) {
+      int32_t value = first + i;
+      samples[i] = (int16_t)(value > INT16_MAX ? INT16_MAX : value);
+    }
+    chip.setSample(samples[0], samples[1], samples[2]);
+
+    sensors_event_t event;
+    gyroFixedEvent_t fixed;
+    gyroFixedEvent_t milliRad;
+    CHECK(gyro.getEvent(&event));
+    CHECK(gyro.getEventFixed(&fixed));
+    CHECK(gyro.getEventMilliRad(&milliRad));
+
+    const float rad[3] = {event.gyro.x, event.gyro.y, event.gyro.z};
+    fixedMismatches += mismatches(fixed, rad, samples, L3G4200D_FIXED_ONE,
+                                  L3G4200D_FIXED_SHIFT);
+    milliRadMismatches += mismatches(milliRad, rad, samples,
+                                     L3G4200D_MILLIRAD_ONE,
+                                     L3G4200D_MILLIRAD_SHIFT);
+
+    // Zero is exactly zero, and the sign always matches.
+    for (int i = 0; i < 3; i++) {
+      const int32_t values[3] = {fixed.x, fixed.y, fixed.z};
+      if (samples[i] == 0) {
+        CHECK_EQUAL(0, values[i]);
+      } else if ((samples[i] < 0) != (values[i] < 0)) {
+        CHECK(values[i] == 0);
+      }
+    }
+  }
+  CHECK_EQUAL(0, fixedMismatches);
+  CHECK_EQUAL(0, milliRadMismatches);
+}
+
+int main() {
+  for (size_t i = 0; i < sizeof(RANGES) / sizeof(RANGES[0]); i++) {
+    testEverySample(RANGES[i]);
+  }
+
+  return testResult("fixed conversion");
+}
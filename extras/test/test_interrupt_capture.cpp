@@ -0,0 +1,132 @@
+/* Checks interrupt-driven capture against the fake gyroscope's INT2: that
+   samples are timestamped from when their interrupt came in, not from when
+   the main loop got round to taking them from the capture buffer, including
+   interrupts put off while the bus was in use and samples read together from
+   the FIFO. */
+
+#include "L3G4200D_U.h"
+#include "test.h"
+
+static FakeL3G4200D chip(10);
+static L3G4200D_Unified gyro(1);
+
+static void still(uint32_t micros, double dps[3], void *context) {
+  (void)micros;
+  (void)context;
+  dps[0] = dps[1] = dps[2] = 0;
+}
+
+static void onInt2() { gyro.handleInterrupt(); }
+
+static void start(bool useWatermark, uint32_t spiFrequency = 5000000) {
+  chip.reset();
+  SPI.reset();
+  chip.setRateTrace(still);
+  chip.int2Pin = 2;
+  attachInterrupt(digitalPinToInterrupt(2), onInt2, RISING);
+  CHECK(gyro.begin(10, GYRO_RANGE_4_DOT_36_RAD_PER_SEC, SPI, spiFrequency));
+  if (useWatermark) {
+    gyro.enableFifo(GYRO_FIFO_STREAM, 8);
+  }
+  gyro.enableDataReadyInterrupt(digitalPinToInterrupt(2), useWatermark);
+}
+
+static void stop() {
+  gyro.disableDataReadyInterrupt();
+  detachInterrupt(digitalPinToInterrupt(2));
+  chip.int2Pin = -1;
+}
+
+// How far the last timestamp is from @p sampleMicros, either way.
+static uint32_t timestampError(uint32_t sampleMicros) {
+  int32_t error = (int32_t)(gyro.lastTimestampMicros() - sampleMicros);
+  return error < 0 ? -error : error;
+}
+
+static void testLateReadsAreNotLate() {
+  start(false);
+
+  // Take the samples at odd times after they came in, each time leaving the
+  // capture buffer empty, so the last one taken is the newest sample.
+  sensors_event_t events[L3G4200D_SAMPLE_RING_CAPACITY];
+  uint32_t worst = 0;
+  for (int i = 0; i < 200; i++) {
+    delayMicroseconds(20000 + (i * 737) % 2500);
+    size_t count = gyro.getEvents(events, L3G4200D_SAMPLE_RING_CAPACITY);
+    CHECK(count >= 8 && count <= 10);
+    uint32_t error = timestampError(chip.lastSampleMicros);
+    if (i >= 20 && error > worst) {
+      worst = error;
+    }
+  }
+  // Within the time the handler takes to read a sample, rather than
+  // anywhere up to a period late.
+  CHECK(worst < 50);
+  CHECK_EQUAL(0, chip.samplesLost);
+
+  stop();
+}
+
+static void testPutOffInterrupts() {
+  // A slow bus, on a core that can't hold the interrupt off during
+  // transactions, so it often comes in while the main loop is using the bus
+  // and the handler is put off until it has finished, up to a millisecond
+  // later.
+  start(false, 100000);
+  SPI.notUsingInterrupt(digitalPinToInterrupt(2));
+
+  sensors_event_t events[L3G4200D_SAMPLE_RING_CAPACITY];
+  uint8_t regs[8];
+  uint32_t worst = 0;
+  for (int i = 0; i < 100; i++) {
+    uint32_t busyUntil = micros() + 20000 + (i * 737) % 2500;
+    while ((int32_t)(micros() - busyUntil) < 0) {
+      gyro.rawReadRegs(REG_WHO_AM_I, regs, sizeof(regs));
+    }
+    gyro.getEvents(events, L3G4200D_SAMPLE_RING_CAPACITY);
+    uint32_t error = timestampError(chip.lastSampleMicros);
+    if (i >= 20 && error > worst) {
+      worst = error;
+    }
+  }
+  CHECK(worst < 50);
+  CHECK_EQUAL(0, SPI.collisions);
+
+  stop();
+}
+
+static void testFifoWatermark() {
+  start(true);
+
+  // Eight samples at a time, the newest taken just before the interrupt and
+  // the rest a period apart before it.
+  sensors_event_t events[L3G4200D_SAMPLE_RING_CAPACITY];
+  uint32_t worst = 0;
+  for (int i = 0; i < 100; i++) {
+    delayMicroseconds(30000 + (i * 997) % 7000);
+    size_t count = gyro.getEvents(events, L3G4200D_SAMPLE_RING_CAPACITY);
+    CHECK(count % 8 == 0);
+    if (count == 0) {
+      continue;
+    }
+    // The newest sample in the buffer came from the last watermark, which
+    // may be older than the chip's newest.
+    uint32_t newest = chip.lastSampleMicros -
+                      chip.fifoLevel() * chip.samplePeriodNanos() / 1000;
+    uint32_t error = timestampError(newest);
+    if (i >= 20 && error > worst) {
+      worst = error;
+    }
+  }
+  CHECK(worst < 100);
+
+  stop();
+}
+
+int main() {
+  testLateReadsAreNotLate();
+  testPutOffInterrupts();
+  testFifoWatermark();
+
+  return testResult("interrupt capture");
+}
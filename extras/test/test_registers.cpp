@@ -0,0 +1,268 @@
+#include "L3G4200D_U.h"
+#include "test.h"
+
+#include <vector>
+
+typedef std::vector<std::vector<uint8_t>> frames_t;
+
+// The gyroscope, with its Chip Select on pin 10.
+static FakeL3G4200D chip(10);
+
+// Puts the gyroscope and the bus back to how they are at power on.
+static void powerOn() {
+  chip.reset();
+  SPI.reset();
+}
+
+// Clears what the bus and the gyroscope have logged.
+static void clearLog() {
+  chip.clearLog();
+  SPI.clearLog();
+}
+
+static void printFrames(const char *label, const frames_t &frames) {
+  fprintf(stderr, "  %s:", label);
+  for (size_t i = 0; i < frames.size(); i++) {
+    fprintf(stderr, " [");
+    for (size_t j = 0; j < frames[i].size(); j++) {
+      fprintf(stderr, j == 0 ? "%02x" : " %02x", frames[i][j]);
+    }
+    fprintf(stderr, "]");
+  }
+  fprintf(stderr, "\n");
+}
+
+// Checks that exactly @p expected was sent, one entry per Chip Select frame,
+// in @p transactions transactions, and then clears the log.
+static void checkTraffic(const char *what, size_t transactions,
+                         const frames_t &expected) {
+  if (chip.frames != expected) {
+    fprintf(stderr, "%s: unexpected register traffic\n", what);
+    printFrames("expected", expected);
+    printFrames("sent", chip.frames);
+    testFailures++;
+  }
+  CHECK_EQUAL(transactions, SPI.transactions);
+  CHECK_EQUAL(0, SPI.strayBytes);
+  CHECK(!SPI.inTransaction && !chip.selected);
+
+  clearLog();
+}
+
+// Returns what reading @p samples samples from the FIFO should send: a read of
+// FIFO_SRC_REG, then (if there are any samples) one auto-increment burst from
+// OUT_X_L, with dummy bytes to clock the samples out.
+static frames_t fifoRead(size_t samples) {
+  frames_t frames(1, std::vector<uint8_t>(2, 0x00));
+  frames[0][0] = 0x80 | REG_FIFO_SRC;
+
+  if (samples > 0) {
+    frames.push_back(std::vector<uint8_t>(1 + 6 * samples, 0x00));
+    frames[1][0] = 0xc0 | REG_OUT_X_L;
+  }
+
+  return frames;
+}
+
+static void testBegin() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+
+  CHECK(gyro.begin(10));
+
+  // WHO_AM_I, then CTRL_REG1 to CTRL_REG5 in one auto-increment burst: 400 Hz
+  // with a 25 Hz cutoff and all axes on, block data update, and 250 dps.
+  checkTraffic("begin", 2,
+               {{0x80 | REG_WHO_AM_I, 0x00},
+                {0x40 | REG_CTRL_1, 0x9f, 0x00, 0x00, 0x80, 0x00}});
+
+  // Anything else isn't an L3G4200D.
+  chip.regs[REG_WHO_AM_I] = 0xd4;
+  CHECK(!gyro.begin(10));
+  checkTraffic("begin with the wrong chip ID", 1,
+               {{0x80 | REG_WHO_AM_I, 0x00}});
+}
+
+static void testReconfigure() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  gyro.begin(10);
+  clearLog();
+
+  gyroConfig_t config;
+  gyro.getConfig(&config);
+
+  // Nothing changed, so nothing is written.
+  gyro.reconfigure(config);
+  checkTraffic("reconfigure with no changes", 0, {});
+
+  // CTRL_REG1 and CTRL_REG4 changed, so CTRL_REG1 to CTRL_REG4 are written in
+  // one burst, leaving CTRL_REG5 alone. Then the sample from before the
+  // change is read out of the way, so it isn't counted towards settling.
+  config.dataRate = GYRO_DATA_RATE_800HZ;
+  config.bandwidth = GYRO_BANDWIDTH_NARROWEST;
+  config.range = GYRO_RANGE_34_DOT_91_RAD_PER_SEC;
+  gyro.reconfigure(config);
+  checkTraffic("reconfigure rate and range", 2,
+               {{0x40 | REG_CTRL_1, 0xcf, 0x00, 0x00, 0xa0},
+                {0xc0 | REG_STATUS, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}});
+  CHECK_EQUAL(0xcf, chip.regs[REG_CTRL_1]);
+  CHECK_EQUAL(0xa0, chip.regs[REG_CTRL_4]);
+
+  // A single register is written without auto-increment.
+  config.highPassDivisor = GYRO_HIGH_PASS_DIV_100;
+  gyro.reconfigure(config);
+  checkTraffic("reconfigure one register", 2,
+               {{REG_CTRL_2, GYRO_HIGH_PASS_DIV_100},
+                {0xc0 | REG_STATUS, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}});
+}
+
+static void testReconfigureRangeFlushesFifo() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  gyro.begin(10);
+  gyro.enableFifo(GYRO_FIFO_STREAM, 16);
+  clearLog();
+
+  for (int i = 0; i < 10; i++) {
+    chip.pushFifo(i, i, i);
+  }
+
+  // Samples in the FIFO were taken at the old range, so going through
+  // bypass mode throws them away.
+  gyroConfig_t config;
+  gyro.getConfig(&config);
+  config.range = GYRO_RANGE_8_DOT_73_RAD_PER_SEC;
+  gyro.reconfigure(config);
+  checkTraffic("reconfigure range with the FIFO on", 3,
+               {{REG_CTRL_4, 0x90},
+                {REG_FIFO_CTRL, FIFO_CTRL_MODE_BYPASS},
+                {REG_FIFO_CTRL, FIFO_CTRL_MODE_STREAM | 16}});
+  CHECK_EQUAL(0, chip.fifoLevel());
+}
+
+static void testDrainFifo() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  gyro.begin(10);
+  gyro.enableFifo(GYRO_FIFO_STREAM, 16);
+  clearLog();
+
+  gyroSample_t buf[L3G4200D_FIFO_DEPTH];
+
+  // An empty FIFO only costs the FIFO_SRC_REG read.
+  CHECK_EQUAL(0, gyro.readFifo(buf, L3G4200D_FIFO_DEPTH));
+  checkTraffic("readFifo when empty", 1, fifoRead(0));
+
+  for (int i = 0; i < 5; i++) {
+    chip.pushFifo(100 + i, -200 - i, 300 + i);
+  }
+
+  // FIFO_SRC_REG, then every sample in one burst that wraps from OUT_Z_H
+  // back to OUT_X_L, all in one transaction.
+  CHECK_EQUAL(5, gyro.readFifo(buf, L3G4200D_FIFO_DEPTH));
+  checkTraffic("readFifo", 1, fifoRead(5));
+  for (int i = 0; i < 5; i++) {
+    CHECK_EQUAL(100 + i, buf[i].x);
+    CHECK_EQUAL(-200 - i, buf[i].y);
+    CHECK_EQUAL(300 + i, buf[i].z);
+  }
+  CHECK_EQUAL(0, chip.fifoLevel());
+
+  // Only as many as asked for are read, and the rest stay in the FIFO.
+  for (int i = 0; i < 5; i++) {
+    chip.pushFifo(i, i, i);
+  }
+  CHECK_EQUAL(3, gyro.readFifo(buf, 3));
+  checkTraffic("readFifo with a smaller buffer", 1, fifoRead(3));
+  CHECK_EQUAL(2, chip.fifoLevel());
+
+  // A full FIFO shows as an overrun, and all of it is read.
+  for (int i = 0; i < 40; i++) {
+    chip.pushFifo(i, i, i);
+  }
+  CHECK_EQUAL(L3G4200D_FIFO_DEPTH, gyro.readFifo(buf, L3G4200D_FIFO_DEPTH));
+  checkTraffic("readFifo after an overrun", 1, fifoRead(L3G4200D_FIFO_DEPTH));
+  CHECK_EQUAL(8, buf[0].x);
+  CHECK_EQUAL(39, buf[L3G4200D_FIFO_DEPTH - 1].x);
+}
+
+static void testRawWritesFollowed() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  gyro.begin(10);
+
+  // A range written by hand is used to scale samples, as half the range
+  // at full scale.
+  gyro.rawWriteReg(REG_CTRL_4, CTRL4_UPDATE_MSB_AND_LSB_TOGETHER |
+                                   CTRL4_FULL_SCALE_2000DPS);
+  chip.setSample(INT16_MAX, 0, 0);
+  gyroFixedEvent_t event;
+  CHECK(gyro.getEventMilliRad(&event));
+  CHECK(event.x >= 17454 && event.x <= 17456);
+
+  // So is a FIFO set up by hand, and changing the range by hand empties it
+  // like setRange() does.
+  uint8_t stream = FIFO_CTRL_MODE_STREAM | 8;
+  gyro.rawWriteReg(REG_FIFO_CTRL, stream);
+  gyro.rawWriteReg(REG_CTRL_5, CTRL5_FIFO_ENABLE);
+  for (int i = 0; i < 3; i++) {
+    chip.pushFifo(i, i, i);
+  }
+  gyroSample_t buf[L3G4200D_FIFO_DEPTH];
+  CHECK_EQUAL(3, gyro.readSamples(buf, L3G4200D_FIFO_DEPTH));
+  chip.pushFifo(1, 1, 1);
+  clearLog();
+  gyro.rawWriteReg(REG_CTRL_4, CTRL4_UPDATE_MSB_AND_LSB_TOGETHER |
+                                   CTRL4_FULL_SCALE_500DPS);
+  checkTraffic("raw range change with the FIFO on", 3,
+               {{REG_CTRL_4, 0x90},
+                {REG_FIFO_CTRL, FIFO_CTRL_MODE_BYPASS},
+                {REG_FIFO_CTRL, stream}});
+  CHECK_EQUAL(0, chip.fifoLevel());
+
+  // And turning it off in a burst goes back to reading the sensor.
+  uint8_t ctrl[5] = {CTRL1_RATE_400HZ_CUTOFF_25HZ | GYRO_AXES_XYZ, 0, 0,
+                     CTRL4_UPDATE_MSB_AND_LSB_TOGETHER, 0};
+  gyro.rawWriteRegs(REG_CTRL_1, ctrl, sizeof(ctrl));
+  chip.setSample(5, 6, 7);
+  CHECK_EQUAL(1, gyro.readSamples(buf, L3G4200D_FIFO_DEPTH));
+  CHECK_EQUAL(5, buf[0].x);
+}
+
+static void testBeginAgain() {
+  powerOn();
+  L3G4200D_Unified gyro(1);
+  gyro.begin(10);
+  gyro.enableFifo(GYRO_FIFO_STREAM, 8);
+  gyro.enableDataReadyInterrupt(2, true);
+  CHECK_EQUAL(1UL << 2, SPI.interruptMask);
+
+  // Starting over forgets the FIFO and the capture buffer, and the old bus
+  // stops holding off the interrupt.
+  gyro.begin(10);
+  CHECK_EQUAL(0, SPI.interruptMask);
+  chip.setSample(5, 6, 7);
+  gyroSample_t buf[L3G4200D_FIFO_DEPTH];
+  CHECK_EQUAL(1, gyro.readSamples(buf, L3G4200D_FIFO_DEPTH));
+  CHECK_EQUAL(7, buf[0].z);
+
+  // And duty cycling.
+  gyro.enableDutyCycle(100, 8);
+  gyro.begin(10);
+  chip.setSample(8, 9, 10);
+  CHECK_EQUAL(1, gyro.readSamples(buf, L3G4200D_FIFO_DEPTH));
+  CHECK_EQUAL(8, buf[0].x);
+  CHECK_EQUAL(0, gyro.serviceDutyCycle(buf, L3G4200D_FIFO_DEPTH));
+}
+
+int main() {
+  testBegin();
+  testReconfigure();
+  testReconfigureRangeFlushesFifo();
+  testDrainFifo();
+  testRawWritesFollowed();
+  testBeginAgain();
+
+  return testResult("register traffic");
+}
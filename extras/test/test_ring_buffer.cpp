@@ -0,0 +1,107 @@
+#include "L3G4200D_RingBuffer.h"
+#include "test.h"
+
+#include <thread>
+
+// Enough items for the free-running indices to wrap many times over.
+#define THREADED_ITEMS (1000000UL)
+
+static void testFillAndDrain() {
+  L3G4200D_RingBuffer<uint32_t, 8> ring;
+  uint32_t item = 0;
+
+  CHECK(ring.empty());
+  CHECK(!ring.pop(item));
+
+  // The whole capacity is usable, and nothing more.
+  for (uint32_t i = 0; i < 8; i++) {
+    CHECK(ring.push(i));
+  }
+  CHECK_EQUAL(8, ring.size());
+  CHECK(!ring.push(8));
+
+  for (uint32_t i = 0; i < 8; i++) {
+    CHECK(ring.pop(item));
+    CHECK_EQUAL(i, item);
+  }
+  CHECK(ring.empty());
+}
+
+static void testWrapAround() {
+  L3G4200D_RingBuffer<uint32_t, 128> ring;
+  uint32_t item = 0;
+
+  // Go round the 8-bit indices several times with the ring part full, so
+  // head - tail has to wrap too.
+  uint32_t next = 0;
+  uint32_t expected = 0;
+  for (int round = 0; round < 1000; round++) {
+    for (int i = 0; i < 100; i++) {
+      CHECK(ring.push(next++));
+    }
+    CHECK_EQUAL(100, ring.size());
+    for (int i = 0; i < 100; i++) {
+      CHECK(ring.pop(item));
+      CHECK_EQUAL(expected++, item);
+    }
+  }
+}
+
+static void testClear() {
+  L3G4200D_RingBuffer<uint32_t, 4> ring;
+  uint32_t item = 0;
+
+  ring.push(1);
+  ring.push(2);
+  ring.clear();
+  CHECK(ring.empty());
+  CHECK(!ring.pop(item));
+
+  // It carries on from where it was.
+  CHECK(ring.push(3));
+  CHECK(ring.pop(item));
+  CHECK_EQUAL(3, item);
+}
+
+// The producer and consumer on their own threads, as an interrupt handler
+// and the main loop would be on a multi-core board. Every item must come out
+// exactly once, in order, with no torn values.
+static void testThreaded() {
+  static L3G4200D_RingBuffer<uint32_t, 16> ring;
+
+  std::thread producer([] {
+    for (uint32_t i = 1; i <= THREADED_ITEMS; i++) {
+      while (!ring.push(i * 0x9e3779b1UL)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t received = 0;
+  uint32_t outOfOrder = 0;
+  while (received < THREADED_ITEMS) {
+    uint32_t item;
+    if (!ring.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    received++;
+    if (item != (uint32_t)(received * 0x9e3779b1UL)) {
+      outOfOrder++;
+    }
+  }
+
+  producer.join();
+
+  CHECK_EQUAL(0, outOfOrder);
+  CHECK(ring.empty());
+}
+
+int main() {
+  testFillAndDrain();
+  testWrapAround();
+  testClear();
+  testThreaded();
+
+  return testResult("ring buffer");
+}
@@ -0,0 +1,116 @@
+#include "L3G4200D_SampleClock.h"
+#include "test.h"
+
+#include <stdlib.h>
+
+// 400 Hz nominally, with the oscillator running 0.4% slow.
+#define NOMINAL_PERIOD (2500)
+#define TRUE_PERIOD (2510)
+
+// Returns a repeatable read latency, from 0 to 400 microseconds.
+static uint32_t readLatency(uint32_t &seed) {
+  seed = seed * 1103515245UL + 12345UL;
+  return (seed >> 16) % 401;
+}
+
+// Returns the magnitude of the difference between two micros() times.
+static uint32_t microsApart(uint32_t a, uint32_t b) {
+  return (uint32_t)abs((int32_t)(a - b));
+}
+
+static void testNoSamples() {
+  L3G4200D_SampleClock clock;
+  clock.reset(NOMINAL_PERIOD);
+
+  CHECK_EQUAL(0, clock.timestampMicros(0));
+  CHECK(clock.periodMicros() == NOMINAL_PERIOD);
+}
+
+static void testFirstBatch() {
+  L3G4200D_SampleClock clock;
+  clock.reset(NOMINAL_PERIOD);
+
+  // With one batch, count back from its newest sample at the nominal rate.
+  CHECK_EQUAL(0, clock.observe(100000, 4));
+  CHECK_EQUAL(100000, clock.timestampMicros(3));
+  CHECK_EQUAL(100000 - 3 * NOMINAL_PERIOD, clock.timestampMicros(0));
+  CHECK_EQUAL(4, clock.observe(110000, 1));
+}
+
+// Reads batches of 16 as a watermark interrupt would, late by a varying
+// amount each time, starting just before micros() wraps. The fitted line
+// should find the real period and take the jitter out of the timestamps.
+static void testTracksJitteryBatches() {
+  L3G4200D_SampleClock clock;
+  clock.reset(NOMINAL_PERIOD);
+
+  uint32_t seed = 1;
+  uint32_t start = 0xffffffffUL - 100000;
+  uint32_t worstError = 0;
+  uint32_t index = 0;
+
+  for (int batch = 0; batch < 64; batch++) {
+    index += 16;
+    uint32_t taken = start + (index - 1) * TRUE_PERIOD;
+    uint32_t first = clock.observe(taken + readLatency(seed), 16);
+    CHECK_EQUAL(index - 16, first);
+
+    // Give it a few batches to settle before holding it to anything.
+    if (batch < 8) {
+      continue;
+    }
+    for (uint32_t i = first; i < index; i++) {
+      uint32_t spacing =
+          clock.timestampMicros(i + 1) - clock.timestampMicros(i);
+      CHECK(spacing >= TRUE_PERIOD - 3 && spacing <= TRUE_PERIOD + 3);
+
+      uint32_t error =
+          microsApart(clock.timestampMicros(i), start + i * TRUE_PERIOD);
+      if (error > worstError) {
+        worstError = error;
+      }
+    }
+  }
+
+  CHECK(clock.periodMicros() > TRUE_PERIOD - 2);
+  CHECK(clock.periodMicros() < TRUE_PERIOD + 2);
+
+  // The average latency, about 200 microseconds, is an offset the clock
+  // can't know about, but the jitter around it should be smoothed out.
+  CHECK(worstError < 400);
+}
+
+static void testAdvanceKeepsCounting() {
+  L3G4200D_SampleClock clock;
+  clock.reset(NOMINAL_PERIOD);
+
+  clock.observe(50000, 1);
+  CHECK_EQUAL(1, clock.advance(10));
+  CHECK_EQUAL(50000 + 10 * NOMINAL_PERIOD, clock.timestampMicros(10));
+  CHECK_EQUAL(11, clock.observe(50000 + 11 * NOMINAL_PERIOD, 1));
+}
+
+static void testResetForgets() {
+  L3G4200D_SampleClock clock;
+  clock.reset(NOMINAL_PERIOD);
+
+  for (uint32_t i = 1; i <= 8; i++) {
+    clock.observe(i * 16 * TRUE_PERIOD, 16);
+  }
+  CHECK(clock.periodMicros() != NOMINAL_PERIOD);
+
+  clock.reset(NOMINAL_PERIOD / 2);
+  CHECK(clock.periodMicros() == NOMINAL_PERIOD / 2);
+  CHECK_EQUAL(0, clock.timestampMicros(0));
+  CHECK_EQUAL(0, clock.observe(1000, 1));
+}
+
+int main() {
+  testNoSamples();
+  testFirstBatch();
+  testTracksJitteryBatches();
+  testAdvanceKeepsCounting();
+  testResetForgets();
+
+  return testResult("sample clock");
+}
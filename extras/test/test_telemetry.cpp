@@ -0,0 +1,179 @@
+/* Checks the telemetry frame layout, and writes a capture for
+   extras/decode_telemetry.py to decode, along with the CSV it should decode
+   it to. run_tests.sh compares the two.
+
+   Usage:
+
+       test_telemetry CAPTURE EXPECTED_CSV
+*/
+
+#include "L3G4200D_Telemetry.h"
+#include "test.h"
+
+#include <vector>
+
+namespace {
+
+// Collects everything written to it. Like a serial port's buffer, `room` goes
+// down as bytes are written, until the test makes more.
+class CapturePrint : public Print {
+
+public:
+  CapturePrint(int room) : room(room) {}
+
+  size_t write(uint8_t byte) {
+    bytes.push_back(byte);
+    if (room > 0) {
+      room--;
+    }
+    return 1;
+  }
+
+  int availableForWrite() { return room; }
+
+  std::vector<uint8_t> bytes;
+  int room;
+};
+
+} // namespace
+
+static gyroSample_t sample(int16_t x, int16_t y, int16_t z) {
+  gyroSample_t sample = {x, y, z};
+  return sample;
+}
+
+static const char *rangeName(uint8_t flags) {
+  switch (flags & L3G4200D_TELEMETRY_FLAG_RANGE_MASK) {
+  default:
+  case GYRO_RANGE_4_DOT_36_RAD_PER_SEC >> 4:
+    return "4.36";
+  case GYRO_RANGE_8_DOT_73_RAD_PER_SEC >> 4:
+    return "8.73";
+  case GYRO_RANGE_34_DOT_91_RAD_PER_SEC >> 4:
+    return "34.91";
+  }
+}
+
+// Records a frame, and the line decode_telemetry.py --raw should print for
+// it.
+static void record(L3G4200D_Telemetry &telemetry, FILE *expected,
+                   int32_t sensorId, uint32_t timestampMicros,
+                   const gyroSample_t &sample, uint8_t flags) {
+  CHECK(telemetry.record(sensorId, timestampMicros, sample, flags));
+  fprintf(expected, "%u,%lu,%d,%d,%d,%s,%d\n", (uint16_t)sensorId,
+          (unsigned long)timestampMicros, sample.x, sample.y, sample.z,
+          rangeName(flags),
+          (flags & L3G4200D_TELEMETRY_FLAG_SATURATED) ? 1 : 0);
+}
+
+static void testFrameLayout() {
+  L3G4200D_Telemetry telemetry;
+  CapturePrint out(64);
+
+  telemetry.record(0x12340841, 0x89abcdef, sample(0x0102, -2, 0x7fff),
+                   0b01 | L3G4200D_TELEMETRY_FLAG_SATURATED);
+  CHECK_EQUAL(1, telemetry.flush(out));
+
+  const uint8_t expected[L3G4200D_TELEMETRY_FRAME_SIZE - 1] = {
+      0xa5, 0x00, 0x41, 0x08, 0xef, 0xcd, 0xab, 0x89,
+      0x02, 0x01, 0xfe, 0xff, 0xff, 0x7f, 0x05};
+  CHECK_EQUAL(L3G4200D_TELEMETRY_FRAME_SIZE, out.bytes.size());
+
+  uint8_t check = 0;
+  for (size_t i = 0; i < sizeof(expected); i++) {
+    CHECK_EQUAL(expected[i], out.bytes[i]);
+    check ^= expected[i];
+  }
+  CHECK_EQUAL(check, out.bytes[L3G4200D_TELEMETRY_FRAME_SIZE - 1]);
+}
+
+static void testFlushOnlyWritesWhatFits() {
+  L3G4200D_Telemetry telemetry;
+  CapturePrint small(L3G4200D_TELEMETRY_FRAME_SIZE - 1);
+
+  telemetry.record(1, 0, sample(0, 0, 0), 0);
+  telemetry.record(1, 0, sample(0, 0, 0), 0);
+
+  // Not even one frame fits, unless it's allowed to block.
+  CHECK_EQUAL(0, telemetry.flush(small));
+  CHECK_EQUAL(2, telemetry.flush(small, true));
+  CHECK_EQUAL(0, telemetry.flush(small, true));
+}
+
+static void testDropsWhenFull() {
+  L3G4200D_Telemetry telemetry;
+
+  for (int i = 0; i < L3G4200D_TELEMETRY_CAPACITY; i++) {
+    CHECK(telemetry.record(1, i, sample(0, 0, 0), 0));
+  }
+  CHECK(!telemetry.record(1, 0, sample(0, 0, 0), 0));
+  CHECK_EQUAL(1, telemetry.dropped());
+}
+
+// Writes frames made directly and by the driver, with junk in between that
+// the decoder has to resynchronize after.
+static void writeCapture(FILE *capture, FILE *expected) {
+  L3G4200D_Telemetry telemetry;
+  CapturePrint out(0);
+
+  record(telemetry, expected, 2113, 0x12345678, sample(1, -2, 32767), 0b00);
+  record(telemetry, expected, 0x10002, 0xffffffff, sample(-32768, 0, 5),
+         0b01 | L3G4200D_TELEMETRY_FLAG_SATURATED);
+  CHECK_EQUAL(2, telemetry.flush(out, true));
+
+  // A stray sync byte, and a run of zeros.
+  out.write(L3G4200D_TELEMETRY_SYNC);
+  for (int i = 0; i < 20; i++) {
+    out.write(0);
+  }
+
+  record(telemetry, expected, -1, 0, sample(-300, 400, -500), 0b10);
+
+  // One from the driver, at the middle range.
+  L3G4200D_Unified gyro(4242);
+  FakeL3G4200D chip(10);
+  SPI.reset();
+  testMicros = 1000000;
+  CHECK(gyro.begin(10, GYRO_RANGE_8_DOT_73_RAD_PER_SEC));
+  gyro.setTelemetry(&telemetry);
+
+  chip.setSample(123, -456, 789);
+  sensors_event_t event;
+  CHECK(gyro.getEvent(&event));
+  fprintf(expected, "4242,%lu,123,-456,789,8.73,0\n",
+          (unsigned long)gyro.lastTimestampMicros());
+
+  // Without blocking, each flush only writes what there's room for.
+  CHECK_EQUAL(0, telemetry.flush(out));
+  out.room = L3G4200D_TELEMETRY_FRAME_SIZE + 1;
+  CHECK_EQUAL(1, telemetry.flush(out));
+  out.room = L3G4200D_TELEMETRY_FRAME_SIZE;
+  CHECK_EQUAL(1, telemetry.flush(out));
+
+  fwrite(out.bytes.data(), 1, out.bytes.size(), capture);
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s CAPTURE EXPECTED_CSV\n", argv[0]);
+    return 2;
+  }
+
+  testFrameLayout();
+  testFlushOnlyWritesWhatFits();
+  testDropsWhenFull();
+
+  FILE *capture = fopen(argv[1], "wb");
+  FILE *expected = fopen(argv[2], "w");
+  if (capture == NULL || expected == NULL) {
+    perror("test_telemetry");
+    return 2;
+  }
+
+  fprintf(expected, "sensor_id,timestamp_us,x,y,z,range,saturated\n");
+  writeCapture(capture, expected);
+  fclose(capture);
+  fclose(expected);
+
+  return testResult("telemetry");
+}